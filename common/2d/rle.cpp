@@ -35,6 +35,7 @@ COPYRIGHT 1993-1998 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "dxxerror.h"
 #include "rle.h"
 #include "byteutil.h"
+#include "texmap.h"
 
 #include "compiler-range_for.h"
 #include "d_range.h"
@@ -442,6 +443,9 @@ grs_bitmap *_rle_expand_texture(const grs_bitmap &bmp)
 		}
 	}
 
+#if !DXX_USE_OGL
+	tmap_batch_retire(std::move(least_recently_used->expanded_bitmap));
+#endif
 	least_recently_used->expanded_bitmap = gr_create_bitmap(bmp.bm_w, bmp.bm_h);
 	rle_expand_texture_sub(bmp, *least_recently_used->expanded_bitmap.get());
 	least_recently_used->rle_bitmap = &bmp;
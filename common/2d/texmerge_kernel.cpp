@@ -0,0 +1,386 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+/*
+ *
+ * Pixel loops that merge an overlay texture onto a base texture.
+ *
+ * The vector kernels share one structure: each output row is a row of
+ * the bottom texture and a row of the rotated top texture.  For
+ * rotation 0 the top row is contiguous and is read in place.  For the
+ * other rotations it is first copied into a scratch row, and then all
+ * rotations use the same vector select.
+ *
+ */
+
+#include <cstddef>
+#include <vector>
+#include "texmerge_kernel.h"
+#include "fwd-gr.h"
+
+#if defined(__SSE2__)
+#define DXX_TEXMERGE_SSE2	1
+#include <emmintrin.h>
+#else
+#define DXX_TEXMERGE_SSE2	0
+#endif
+
+/* AVX2 is not part of any baseline x86 target, so it is compiled with a
+ * function-specific target and selected only if the CPU reports it.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DXX_TEXMERGE_AVX2	1
+#include <immintrin.h>
+#else
+#define DXX_TEXMERGE_AVX2	0
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define DXX_TEXMERGE_NEON	1
+#include <arm_neon.h>
+#else
+#define DXX_TEXMERGE_NEON	0
+#endif
+
+namespace dcx {
+
+namespace {
+
+constexpr uint8_t texmerge_transparent = static_cast<uint8_t>(TRANSPARENCY_COLOR);
+constexpr uint8_t texmerge_super_transparent = 254;
+
+/* Helper classes merge_texture_0 through merge_texture_3 correspond to
+ * the four values of `rotation`.
+ */
+struct merge_texture_0
+{
+	static std::size_t get_top_data_index(const unsigned wh, const unsigned y, const unsigned x)
+	{
+		return wh * y + x;
+	}
+};
+
+struct merge_texture_1
+{
+	static std::size_t get_top_data_index(const unsigned wh, const unsigned y, const unsigned x)
+	{
+		return wh * x + ((wh - 1) - y);
+	}
+};
+
+struct merge_texture_2
+{
+	static std::size_t get_top_data_index(const unsigned wh, const unsigned y, const unsigned x)
+	{
+		return wh * ((wh - 1) - y) + ((wh - 1) - x);
+	}
+};
+
+struct merge_texture_3
+{
+	static std::size_t get_top_data_index(const unsigned wh, const unsigned y, const unsigned x)
+	{
+		return wh * ((wh - 1) - x) + y;
+	}
+};
+
+/* For supertransparent colors, remap 254.
+ * For regular transparent colors, do nothing.
+ *
+ * In both cases, the caller remaps TRANSPARENCY_COLOR to the bottom
+ * bitmap.
+ */
+struct merge_transform_super_xparent
+{
+	static uint8_t transform_color(uint8_t c)
+	{
+		return c == texmerge_super_transparent ? texmerge_transparent : c;
+	}
+};
+
+struct merge_transform_new
+{
+	static uint8_t transform_color(uint8_t c)
+	{
+		return c;
+	}
+};
+
+/* Run the transform for one texture merge case.  Different values of
+ * `rotation` lead to different types for `get_index`.
+ */
+template <typename texture_transform, typename get_index>
+static void merge_textures_case(const unsigned wh, const uint8_t *const top_data, const uint8_t *const bottom_data, uint8_t *dest_data)
+{
+	for (unsigned y = 0; y < wh; ++y)
+		for (unsigned x = 0; x < wh; ++x)
+		{
+			const auto c = top_data[get_index::get_top_data_index(wh, y, x)];
+			/* All merged textures support TRANSPARENCY_COLOR, so handle
+			 * it here.  Supertransparency is delegated down to
+			 * `texture_transform`, since not all textures want
+			 * supertransparency.
+			 */
+			*dest_data++ = (c == texmerge_transparent)
+				? bottom_data[wh * y + x]
+				: texture_transform::transform_color(c);
+		}
+}
+
+/* Dispatch a texture transformation based on the value of `rotation`.
+ * The loops are duplicated in each case so that `rotation` is not
+ * reread for each byte processed.
+ */
+template <typename texture_transform>
+static void merge_textures_scalar(const unsigned wh, const unsigned rotation, const uint8_t *const top_data, const uint8_t *const bottom_data, uint8_t *const dest_data)
+{
+	switch (rotation)
+	{
+		case 0:
+			merge_textures_case<texture_transform, merge_texture_0>(wh, top_data, bottom_data, dest_data);
+			break;
+		case 1:
+			merge_textures_case<texture_transform, merge_texture_1>(wh, top_data, bottom_data, dest_data);
+			break;
+		case 2:
+			merge_textures_case<texture_transform, merge_texture_2>(wh, top_data, bottom_data, dest_data);
+			break;
+		case 3:
+			merge_textures_case<texture_transform, merge_texture_3>(wh, top_data, bottom_data, dest_data);
+			break;
+	}
+}
+
+static void merge_textures_scalar(const unsigned wh, const unsigned rotation, const texmerge_transform transform, const uint8_t *const top_data, const uint8_t *const bottom_data, uint8_t *const dest_data)
+{
+	if (transform == texmerge_transform::super_transparent)
+		merge_textures_scalar<merge_transform_super_xparent>(wh, rotation, top_data, bottom_data, dest_data);
+	else
+		merge_textures_scalar<merge_transform_new>(wh, rotation, top_data, bottom_data, dest_data);
+}
+
+/* Select the bytes for the tail of a row that is not a multiple of the
+ * vector width.
+ */
+static void merge_row_tail(const unsigned begin, const unsigned end, const bool super_transparent, const uint8_t *const top, const uint8_t *const bottom, uint8_t *const dest)
+{
+	for (unsigned x = begin; x < end; ++x)
+	{
+		const auto c = top[x];
+		dest[x] = (c == texmerge_transparent)
+			? bottom[x]
+			: (super_transparent && c == texmerge_super_transparent ? texmerge_transparent : c);
+	}
+}
+
+/* Return the top row that lands on output row `y`, copying it into
+ * `scratch` unless it is already contiguous in `top_data`.
+ */
+static const uint8_t *get_rotated_top_row(const unsigned wh, const unsigned rotation, const unsigned y, const uint8_t *const top_data, uint8_t *const scratch)
+{
+	switch (rotation)
+	{
+		case 0:
+		default:
+			return &top_data[wh * y];
+		case 1:
+			for (unsigned x = 0; x < wh; ++x)
+				scratch[x] = top_data[merge_texture_1::get_top_data_index(wh, y, x)];
+			return scratch;
+		case 2:
+			{
+				const auto row = &top_data[wh * ((wh - 1) - y)];
+				for (unsigned x = 0; x < wh; ++x)
+					scratch[x] = row[(wh - 1) - x];
+			}
+			return scratch;
+		case 3:
+			for (unsigned x = 0; x < wh; ++x)
+				scratch[x] = top_data[merge_texture_3::get_top_data_index(wh, y, x)];
+			return scratch;
+	}
+}
+
+/* Apply `merge_row` to each output row.  `merge_row` handles one row
+ * of `wh` bytes, from pointers to the top, bottom and destination rows.
+ */
+template <typename F>
+static void merge_textures_by_row(const unsigned wh, const unsigned rotation, const uint8_t *const top_data, const uint8_t *const bottom_data, uint8_t *const dest_data, F merge_row)
+{
+	std::vector<uint8_t> scratch(rotation ? wh : 0);
+	for (unsigned y = 0; y < wh; ++y)
+	{
+		const std::size_t offset = std::size_t{wh} * y;
+		merge_row(get_rotated_top_row(wh, rotation, y, top_data, scratch.data()), &bottom_data[offset], &dest_data[offset]);
+	}
+}
+
+#if DXX_TEXMERGE_SSE2
+static void merge_textures_sse2(const unsigned wh, const unsigned rotation, const texmerge_transform transform, const uint8_t *const top_data, const uint8_t *const bottom_data, uint8_t *const dest_data)
+{
+	const bool super_transparent = (transform == texmerge_transform::super_transparent);
+	const auto vtransparent = _mm_set1_epi8(static_cast<char>(texmerge_transparent));
+	const auto vsuper = _mm_set1_epi8(static_cast<char>(texmerge_super_transparent));
+	merge_textures_by_row(wh, rotation, top_data, bottom_data, dest_data, [=](const uint8_t *const top, const uint8_t *const bottom, uint8_t *const dest) {
+		unsigned x = 0;
+		for (; x + 16 <= wh; x += 16)
+		{
+			auto t = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&top[x]));
+			const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&bottom[x]));
+			const auto use_bottom = _mm_cmpeq_epi8(t, vtransparent);
+			/* 254 | 0xff == 0xff, so or-ing in the compare mask maps
+			 * exactly the supertransparent texels to TRANSPARENCY_COLOR.
+			 */
+			if (super_transparent)
+				t = _mm_or_si128(t, _mm_cmpeq_epi8(t, vsuper));
+			const auto r = _mm_or_si128(_mm_and_si128(use_bottom, b), _mm_andnot_si128(use_bottom, t));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(&dest[x]), r);
+		}
+		merge_row_tail(x, wh, super_transparent, top, bottom, dest);
+	});
+}
+#endif
+
+#if DXX_TEXMERGE_AVX2
+__attribute__((target("avx2")))
+static void merge_row_avx2(const unsigned wh, const bool super_transparent, const uint8_t *const top, const uint8_t *const bottom, uint8_t *const dest)
+{
+	const auto vtransparent = _mm256_set1_epi8(static_cast<char>(texmerge_transparent));
+	const auto vsuper = _mm256_set1_epi8(static_cast<char>(texmerge_super_transparent));
+	unsigned x = 0;
+	for (; x + 32 <= wh; x += 32)
+	{
+		auto t = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&top[x]));
+		const auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&bottom[x]));
+		const auto use_bottom = _mm256_cmpeq_epi8(t, vtransparent);
+		if (super_transparent)
+			t = _mm256_or_si256(t, _mm256_cmpeq_epi8(t, vsuper));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(&dest[x]), _mm256_blendv_epi8(t, b, use_bottom));
+	}
+	merge_row_tail(x, wh, super_transparent, top, bottom, dest);
+}
+
+static void merge_textures_avx2(const unsigned wh, const unsigned rotation, const texmerge_transform transform, const uint8_t *const top_data, const uint8_t *const bottom_data, uint8_t *const dest_data)
+{
+	const bool super_transparent = (transform == texmerge_transform::super_transparent);
+	merge_textures_by_row(wh, rotation, top_data, bottom_data, dest_data, [=](const uint8_t *const top, const uint8_t *const bottom, uint8_t *const dest) {
+		merge_row_avx2(wh, super_transparent, top, bottom, dest);
+	});
+}
+#endif
+
+#if DXX_TEXMERGE_NEON
+static void merge_textures_neon(const unsigned wh, const unsigned rotation, const texmerge_transform transform, const uint8_t *const top_data, const uint8_t *const bottom_data, uint8_t *const dest_data)
+{
+	const bool super_transparent = (transform == texmerge_transform::super_transparent);
+	const auto vtransparent = vdupq_n_u8(texmerge_transparent);
+	const auto vsuper = vdupq_n_u8(texmerge_super_transparent);
+	merge_textures_by_row(wh, rotation, top_data, bottom_data, dest_data, [=](const uint8_t *const top, const uint8_t *const bottom, uint8_t *const dest) {
+		unsigned x = 0;
+		for (; x + 16 <= wh; x += 16)
+		{
+			auto t = vld1q_u8(&top[x]);
+			const auto b = vld1q_u8(&bottom[x]);
+			const auto use_bottom = vceqq_u8(t, vtransparent);
+			if (super_transparent)
+				t = vorrq_u8(t, vceqq_u8(t, vsuper));
+			vst1q_u8(&dest[x], vbslq_u8(use_bottom, b, t));
+		}
+		merge_row_tail(x, wh, super_transparent, top, bottom, dest);
+	});
+}
+#endif
+
+static bool texmerge_isa_supported(const texmerge_isa isa)
+{
+	switch (isa)
+	{
+		case texmerge_isa::scalar:
+			return true;
+		case texmerge_isa::sse2:
+			return DXX_TEXMERGE_SSE2;
+		case texmerge_isa::avx2:
+#if DXX_TEXMERGE_AVX2
+			return __builtin_cpu_supports("avx2");
+#else
+			return false;
+#endif
+		case texmerge_isa::neon:
+			return DXX_TEXMERGE_NEON;
+		default:
+			return false;
+	}
+}
+
+static texmerge_isa texmerge_detect_isa()
+{
+	for (const auto isa : {texmerge_isa::avx2, texmerge_isa::sse2, texmerge_isa::neon})
+		if (texmerge_isa_supported(isa))
+			return isa;
+	return texmerge_isa::scalar;
+}
+
+}
+
+texmerge_isa texmerge_best_isa()
+{
+	static const texmerge_isa best = texmerge_detect_isa();
+	return best;
+}
+
+const char *texmerge_isa_name(const texmerge_isa isa)
+{
+	switch (isa)
+	{
+		case texmerge_isa::scalar:
+			return "scalar";
+		case texmerge_isa::sse2:
+			return "SSE2";
+		case texmerge_isa::avx2:
+			return "AVX2";
+		case texmerge_isa::neon:
+			return "NEON";
+		default:
+			return "unknown";
+	}
+}
+
+bool texmerge_merge(const texmerge_isa isa, const unsigned wh, const unsigned rotation, const texmerge_transform transform, const uint8_t *const top, const uint8_t *const bottom, uint8_t *const dest)
+{
+	if (!texmerge_isa_supported(isa))
+		return false;
+	switch (isa)
+	{
+		case texmerge_isa::scalar:
+		default:
+			merge_textures_scalar(wh, rotation, transform, top, bottom, dest);
+			break;
+#if DXX_TEXMERGE_SSE2
+		case texmerge_isa::sse2:
+			merge_textures_sse2(wh, rotation, transform, top, bottom, dest);
+			break;
+#endif
+#if DXX_TEXMERGE_AVX2
+		case texmerge_isa::avx2:
+			merge_textures_avx2(wh, rotation, transform, top, bottom, dest);
+			break;
+#endif
+#if DXX_TEXMERGE_NEON
+		case texmerge_isa::neon:
+			merge_textures_neon(wh, rotation, transform, top, bottom, dest);
+			break;
+#endif
+	}
+	return true;
+}
+
+void texmerge_merge(const unsigned wh, const unsigned rotation, const texmerge_transform transform, const uint8_t *const top, const uint8_t *const bottom, uint8_t *const dest)
+{
+	texmerge_merge(texmerge_best_isa(), wh, rotation, transform, top, bottom, dest);
+}
+
+}
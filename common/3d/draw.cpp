@@ -62,6 +62,8 @@ void g3_draw_line(grs_canvas &canvas, g3s_point &p0, g3s_point &p1, const uint8_
 {
 	ubyte codes_or;
 
+	tmap_batch_flush();
+
 	if (p0.p3_codes & p1.p3_codes)
 		return;
 
@@ -254,6 +256,7 @@ free_points:
 //radius, but not to the distance from the eye
 void g3_draw_sphere(grs_canvas &canvas, cg3s_point &pnt, const fix rad, const uint8_t color)
 {
+	tmap_batch_flush();
 	if (! (pnt.p3_codes & CC_BEHIND)) {
 
 		if (! (pnt.p3_flags & PF_PROJECTED))
@@ -16,21 +16,21 @@
 
 namespace dcx {
 
-vms_vector	View_position;
-fix			View_zoom;
+thread_local vms_vector	View_position;
+thread_local fix			View_zoom;
 
-vms_matrix	Unscaled_matrix;	//before scaling
-vms_matrix	View_matrix;
+thread_local vms_matrix	Unscaled_matrix;	//before scaling
+thread_local vms_matrix	View_matrix;
 
-vms_vector	Window_scale;		//scaling for window aspect
-vms_vector	Matrix_scale;		//how the matrix is scaled, window_scale * zoom
+thread_local vms_vector	Window_scale;		//scaling for window aspect
+thread_local vms_vector	Matrix_scale;		//how the matrix is scaled, window_scale * zoom
 
-fix			Canv_w2;				//fixed-point width/2
-fix			Canv_h2;				//fixed-point height/2
+thread_local fix			Canv_w2;				//fixed-point width/2
+thread_local fix			Canv_h2;				//fixed-point height/2
 
 #ifdef __powerc
-double		fCanv_w2;
-double		fCanv_h2;
+thread_local double		fCanv_w2;
+thread_local double		fCanv_h2;
 #endif
 
 //vertex buffers for polygon drawing and clipping
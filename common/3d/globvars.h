@@ -19,17 +19,17 @@ struct g3s_point;
 
 namespace dcx {
 
-extern fix Canv_w2,Canv_h2;				//fixed-point width,height/2
+extern thread_local fix Canv_w2,Canv_h2;				//fixed-point width,height/2
 
 #ifdef __powerc
-extern double fCanv_w2, fCanv_h2;
+extern thread_local double fCanv_w2, fCanv_h2;
 #endif
 
-extern vms_vector Window_scale;
+extern thread_local vms_vector Window_scale;
 
-extern fix View_zoom;
-extern vms_vector View_position,Matrix_scale;
-extern vms_matrix View_matrix,Unscaled_matrix;
+extern thread_local fix View_zoom;
+extern thread_local vms_vector View_position,Matrix_scale;
+extern thread_local vms_matrix View_matrix,Unscaled_matrix;
 
 }
 
@@ -16,6 +16,7 @@
 #include "maths.h"
 #if !DXX_USE_OGL
 #include "gr.h"
+#include "texmap.h"
 #endif
 
 #include "compiler-range_for.h"
@@ -129,6 +130,7 @@ void g3_draw_bitmap(grs_canvas &canvas, const vms_vector &pos, fix width, fix he
 {
 	g3s_point pnt;
 	fix w,h;
+	tmap_batch_flush();
 	if (g3_rotate_point(pnt,pos) & CC_BEHIND)
 		return;
 	g3_project_point(pnt);
@@ -27,14 +27,13 @@
 
 namespace dcx {
 
-//start the frame
-void g3_start_frame(grs_canvas &canvas)
+//set up the projection for a canvas of the given size, without
+//preparing to draw to it
+void g3_set_projection(const int Canvas_width, const int Canvas_height)
 {
 	fix s;
 
 	//set int w,h & fixed-point w,h/2
-	const int Canvas_width = canvas.cv_bitmap.bm_w;
-	const int Canvas_height = canvas.cv_bitmap.bm_h;
 	Canv_w2 = Canvas_width << 15;
 	Canv_h2 = Canvas_height << 15;
 #ifdef __powerc
@@ -56,7 +55,12 @@ void g3_start_frame(grs_canvas &canvas)
 	}
 	
 	Window_scale.z = f1_0;		//always 1
+}
 
+//start the frame
+void g3_start_frame(grs_canvas &canvas)
+{
+	g3_set_projection(canvas.cv_bitmap.bm_w, canvas.cv_bitmap.bm_h);
 #if DXX_USE_OGL
 	ogl_start_frame(canvas);
 #else
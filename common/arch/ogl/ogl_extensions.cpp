@@ -27,6 +27,14 @@ PFNGLFENCESYNCPROC glFenceSyncFunc = NULL;
 PFNGLDELETESYNCPROC glDeleteSyncFunc = NULL;
 PFNGLCLIENTWAITSYNCPROC glClientWaitSyncFunc = NULL;
 
+/* GL_ARB_vertex_buffer_object */
+bool ogl_have_ARB_vertex_buffer_object = false;
+glGenBuffers_fp glGenBuffersFunc = NULL;
+glDeleteBuffers_fp glDeleteBuffersFunc = NULL;
+glBindBuffer_fp glBindBufferFunc = NULL;
+glBufferData_fp glBufferDataFunc = NULL;
+glBufferSubData_fp glBufferSubDataFunc = NULL;
+
 /* GL_EXT_texture_filter_anisotropic */
 GLfloat ogl_maxanisotropy = 0.0f;
 
@@ -137,6 +145,34 @@ void ogl_extensions_init()
 		s = "DXX-Rebirth: OpenGL: GL_ARB_sync not available";
 	}
 	con_puts(CON_VERBOSE, s);
+
+	/* GL_ARB_vertex_buffer_object */
+	switch (is_supported(extension_str, version, "GL_ARB_vertex_buffer_object", 1, 5, 1, 1))
+	{
+		case SUPPORT_CORE:
+			glGenBuffersFunc = reinterpret_cast<glGenBuffers_fp>(SDL_GL_GetProcAddress("glGenBuffers"));
+			glDeleteBuffersFunc = reinterpret_cast<glDeleteBuffers_fp>(SDL_GL_GetProcAddress("glDeleteBuffers"));
+			glBindBufferFunc = reinterpret_cast<glBindBuffer_fp>(SDL_GL_GetProcAddress("glBindBuffer"));
+			glBufferDataFunc = reinterpret_cast<glBufferData_fp>(SDL_GL_GetProcAddress("glBufferData"));
+			glBufferSubDataFunc = reinterpret_cast<glBufferSubData_fp>(SDL_GL_GetProcAddress("glBufferSubData"));
+			break;
+		case SUPPORT_EXT:
+			glGenBuffersFunc = reinterpret_cast<glGenBuffers_fp>(SDL_GL_GetProcAddress("glGenBuffersARB"));
+			glDeleteBuffersFunc = reinterpret_cast<glDeleteBuffers_fp>(SDL_GL_GetProcAddress("glDeleteBuffersARB"));
+			glBindBufferFunc = reinterpret_cast<glBindBuffer_fp>(SDL_GL_GetProcAddress("glBindBufferARB"));
+			glBufferDataFunc = reinterpret_cast<glBufferData_fp>(SDL_GL_GetProcAddress("glBufferDataARB"));
+			glBufferSubDataFunc = reinterpret_cast<glBufferSubData_fp>(SDL_GL_GetProcAddress("glBufferSubDataARB"));
+			break;
+		case NO_SUPPORT:
+			break;
+	}
+	if (glGenBuffersFunc && glDeleteBuffersFunc && glBindBufferFunc && glBufferDataFunc && glBufferSubDataFunc) {
+		ogl_have_ARB_vertex_buffer_object=true;
+		s = "DXX-Rebirth: OpenGL: GL_ARB_vertex_buffer_object available";
+	} else {
+		s = "DXX-Rebirth: OpenGL: GL_ARB_vertex_buffer_object not available";
+	}
+	con_puts(CON_VERBOSE, s);
 }
 
 }
@@ -108,6 +108,10 @@ typedef g3s_point cg3s_point;
 //start the frame
 void g3_start_frame(grs_canvas &);
 
+//set up the projection for a canvas of the given size, without
+//preparing to draw to it.  The projection and view are per thread.
+void g3_set_projection(int width, int height);
+
 //set view from x,y,z, viewer matrix, and zoom.  Must call one of g3_set_view_*() 
 void g3_set_view_matrix(const vms_vector &view_pos,const vms_matrix &view_matrix,fix zoom);
 
@@ -56,6 +56,7 @@ enum SyncGLMethod : uint8_t {
 //   Edi - Editor Options
 //   Dbg - Debugging/Undocumented Options
 #include <string>
+#include <vector>
 #include "dxxsconf.h"
 #include "dsx-ns.h"
 #include "pack.h"
@@ -106,17 +107,32 @@ struct CArg : prohibit_void_ptr<CArg>
 #else
 	bool DbgSdlHWSurface;
 	bool DbgSdlASyncBlit;
+	unsigned DbgTexMapThreads;
 #endif
 	bool DbgNoRun;
 	bool DbgNoDoubleBuffer;
 	bool DbgNoCompressPigBitmap;
 	bool DbgRenderStats;
+	bool DbgProfile;
+	bool DbgDemoStatsCsv;
 	uint8_t DbgBpp;
+	unsigned DbgBenchmarkFrames;
+	unsigned DbgExportFps;
+	unsigned DbgDemoStatsJobs;
 	int8_t DbgVerbose;
 	bool SysNoNiceFPS;
 	int SysMaxFPS;
+	unsigned GfxTexMergeCacheSize;
 	uint16_t MplUdpHostPort;
 	uint16_t MplUdpMyPort;
+	bool MplDedicated;
+	uint8_t MplDedicatedMaxPlayers;
+	unsigned MplDedicatedLevel;
+	uint8_t MplUdpSimLoss;
+	uint8_t MplUdpSimReorder;
+	uint16_t MplUdpSimLatency;
+	uint16_t MplUdpSimJitter;
+	uint32_t MplUdpSimSeed;
 #if DXX_USE_TRACKER
 	uint16_t MplTrackerPort;
 	std::string MplTrackerAddr;
@@ -126,7 +142,20 @@ struct CArg : prohibit_void_ptr<CArg>
 	std::string SysPilot;
 	std::string SysRecordDemoNameTemplate;
 	std::string MplUdpHostAddr;
+	std::string MplDedicatedMission;
+	std::string MplDedicatedMode;
+	std::string MplDedicatedName;
+	std::string MplUdpCapture;
+	std::string MplUdpReplay;
 	std::string DbgAltTex;
+	std::string DbgBenchmarkDemo;
+	std::string DbgExportDemo;
+	std::string DbgExportPng;
+	std::string DbgExportVideo;
+	std::string DbgExportAudio;
+	std::vector<std::string> DbgDemoStats;
+	std::string DbgDemoStatsChild;
+	std::string DbgProfileCsv;
 #if !DXX_USE_OGL
 	std::string DbgTexMap;
 #endif
@@ -28,6 +28,13 @@ void digi_audio_set_channel_pan(int, int );
 void digi_audio_stop_sound(int );
 void digi_audio_end_sound(int );
 void digi_audio_set_digi_volume(int);
+/* Fill `len` bytes of `stream` with the next unsigned 8-bit stereo
+ * samples, as the device would have played them.  Only meaningful when
+ * the sound system was started for -export-audio, which opens no
+ * device.
+ */
+void digi_audio_mix_offline(uint8_t *stream, std::size_t len);
+unsigned digi_audio_get_sample_rate();
 }
 #endif
 
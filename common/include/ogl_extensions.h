@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 #if defined(__APPLE__) && defined(__MACH__)
@@ -47,6 +48,27 @@ typedef void (APIENTRYP PFNGLWAITSYNCPROC) (GLsync sync, GLbitfield flags, GLuin
 #define GL_SYNC_GPU_COMMANDS_COMPLETE     0x9117
 #define GL_TIMEOUT_EXPIRED                0x911B
 
+/* GL_ARB_vertex_buffer_object
+ * The size and offset parameters are GLsizeiptr and GLintptr, which
+ * glext.h may or may not define, so these use std::ptrdiff_t, which has
+ * the same size.
+ */
+typedef void (APIENTRYP glGenBuffers_fp) (GLsizei n, GLuint *buffers);
+typedef void (APIENTRYP glDeleteBuffers_fp) (GLsizei n, const GLuint *buffers);
+typedef void (APIENTRYP glBindBuffer_fp) (GLenum target, GLuint buffer);
+typedef void (APIENTRYP glBufferData_fp) (GLenum target, std::ptrdiff_t size, const void *data, GLenum usage);
+typedef void (APIENTRYP glBufferSubData_fp) (GLenum target, std::ptrdiff_t offset, std::ptrdiff_t size, const void *data);
+
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER                   0x8892
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW                    0x88E0
+#endif
+#ifndef GL_STATIC_DRAW
+#define GL_STATIC_DRAW                    0x88E4
+#endif
+
 /* GL_EXT_texture */
 #ifndef GL_VERSION_1_1
 #ifdef GL_EXT_texture
@@ -69,6 +91,12 @@ extern bool ogl_have_ARB_sync;
 extern PFNGLFENCESYNCPROC glFenceSyncFunc;
 extern PFNGLDELETESYNCPROC glDeleteSyncFunc;
 extern PFNGLCLIENTWAITSYNCPROC glClientWaitSyncFunc;
+extern bool ogl_have_ARB_vertex_buffer_object;
+extern glGenBuffers_fp glGenBuffersFunc;
+extern glDeleteBuffers_fp glDeleteBuffersFunc;
+extern glBindBuffer_fp glBindBufferFunc;
+extern glBufferData_fp glBufferDataFunc;
+extern glBufferSubData_fp glBufferSubDataFunc;
 extern GLfloat ogl_maxanisotropy;
 
 /* Global initialization:
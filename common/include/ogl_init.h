@@ -106,6 +106,24 @@ void ogl_ulinec(grs_canvas &, int left, int top, int right, int bot, int c);
 #ifdef dsx
 namespace dsx {
 void ogl_cache_level_textures();
+
+//	Bake the sides of the level into a vertex buffer.  ogl_cache_level_textures does this when
+//	a level is loaded.
+void ogl_level_mesh_build();
+
+//	Mark the mesh out of date, so that the next view bakes the level again.  LoadLevel calls
+//	this, since not every path that loads a level reaches ogl_cache_level_textures.
+void ogl_level_mesh_invalidate();
+
+//	Start drawing a view with the level mesh, at the current view matrix.  Until the current
+//	ogl_tmap_batch_scope ends, ogl_level_mesh_draw_tmap queues faces from the mesh, if it
+//	can be used.
+void ogl_level_mesh_begin_view();
+
+//	Queue the face of a side whose corners are `corners`, with the side's current uvls and
+//	the light of each corner.  Returns false if nothing was queued, in which case the face
+//	must be drawn with g3_draw_tmap or g3_draw_tmap_2.
+bool ogl_level_mesh_draw_tmap(grs_canvas &, vcsegptridx_t seg, unsigned sidenum, const std::array<uint8_t, 4> &corners, unsigned nv, const std::array<g3s_lrgb, 4> &light, grs_bitmap &bm, grs_bitmap *bm2, texture2_rotation_low orient);
 }
 #endif
 
@@ -128,6 +146,22 @@ void ogl_draw_vertex_reticle(int cross,int primary,int secondary,int color,int a
 namespace dcx {
 void ogl_toggle_depth_test(int enable);
 void ogl_set_blending(gr_blend);
+
+//	Draw all queued texture maps.  Code that changes GL state used by queued texture maps, or
+//	draws by other means, must call this first.
+void ogl_tmap_batch_flush();
+
+//	While this exists, texture maps are queued instead of drawn, and consecutive texture maps
+//	with the same texture are drawn with one call.  The queue is drawn when this is destroyed.
+class ogl_tmap_batch_scope
+{
+	const bool previous;
+public:
+	ogl_tmap_batch_scope();
+	~ogl_tmap_batch_scope();
+	ogl_tmap_batch_scope(const ogl_tmap_batch_scope &) = delete;
+	ogl_tmap_batch_scope &operator=(const ogl_tmap_batch_scope &) = delete;
+};
 unsigned pow2ize(unsigned x);//from ogl.c
 }
 
@@ -0,0 +1,104 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+/*
+ *
+ * Scoped timers for the hot paths of a frame.
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include "dxxsconf.h"
+
+#ifdef __cplusplus
+namespace dcx {
+
+/* Each zone has a fixed label, so the per-frame summary is a flat
+ * array indexed by zone.  Add new zones before `end`, and add their
+ * label to `profile_zone_labels` in profile.cpp.
+ */
+enum class profile_zone : uint8_t
+{
+	game_process_frame,
+	render_mine,
+	build_segment_list,
+	do_ai_frame,
+	do_physics_sim,
+	find_vector_intersection,
+	digi_sync_sounds,
+	net_udp_process_packet,
+	end
+};
+
+constexpr std::size_t profile_zone_count = static_cast<std::size_t>(profile_zone::end);
+
+using profile_clock = std::chrono::steady_clock;
+
+struct profile_zone_total
+{
+	profile_clock::duration elapsed;
+	unsigned calls;
+};
+
+struct profile_frame_summary
+{
+	std::array<profile_zone_total, profile_zone_count> zones;
+	/* Events lost because a thread filled its ring buffer before the
+	 * end of the frame.
+	 */
+	unsigned dropped;
+};
+
+/* Set once at startup from -profile.  When clear, a profile_scope costs
+ * one predictable branch on entry and one on exit.
+ */
+extern bool profile_active;
+
+const char *profile_zone_label(profile_zone);
+void profile_record(profile_zone, profile_clock::duration);
+
+class profile_scope
+{
+	const profile_zone zone;
+	const profile_clock::time_point start;
+public:
+	explicit profile_scope(const profile_zone zone) :
+		zone(zone), start(likely(!profile_active) ? profile_clock::time_point() : profile_clock::now())
+	{
+	}
+	profile_scope(const profile_scope &) = delete;
+	profile_scope &operator=(const profile_scope &) = delete;
+	~profile_scope()
+	{
+		if (unlikely(profile_active))
+			profile_record(zone, profile_clock::now() - start);
+	}
+};
+
+/* Collect the events recorded by every thread since the previous call,
+ * publish them as the most recent frame, and append a row to the CSV
+ * file, if one is open.  Call exactly once per frame, from the main
+ * thread.
+ */
+void profile_end_frame();
+
+/* The totals for the most recently completed frame. */
+const profile_frame_summary &profile_last_frame();
+/* Per-frame averages over the most recently completed group of
+ * frames.  This changes slowly enough to be readable on screen.
+ */
+const profile_frame_summary &profile_average_frame();
+
+void profile_open_csv(const char *filename);
+void profile_close_csv();
+
+}
+#endif
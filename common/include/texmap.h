@@ -83,7 +83,7 @@ struct g3ds_tmap {
 //	Set Interpolation_method to 0/1/2 for linear/linear, perspective/linear, perspective/perspective
 #if !DXX_USE_OGL
 extern	int	Interpolation_method;
-extern uint8_t Transparency_on;
+extern thread_local uint8_t Transparency_on;
 
 // Set Lighting_on to 0/1/2 for no lighting/intensity lighting/rgb lighting
 extern	int	Lighting_on;
@@ -91,6 +91,32 @@ extern	int	Lighting_on;
 // HACK INTERFACE: how far away the current segment (& thus texture) is
 extern unsigned Current_seg_depth;
 void init_interface_vars_to_assembler();
+
+//	Batched texture mapping, for drawing with several threads.
+//	Start `threads` - 1 helper threads.  `threads` is cut to one per CPU, and 0 means one per
+//	CPU.  With fewer than 2 threads, texture maps are always drawn immediately.
+void tmap_batch_init(unsigned threads);
+void tmap_batch_close();
+//	Draw all recorded texture maps.  Anything drawn by other means while a batch is recording
+//	must call this first, so that it lands on top of the texture maps recorded before it.
+void tmap_batch_flush();
+//	Free a cached texture that is being replaced.  While texture maps that may read it are
+//	recorded, it is kept until they are drawn.
+void tmap_batch_retire(grs_bitmap_ptr &&texture);
+
+//	While this exists, draw_tmap records texture maps instead of drawing them.  The recorded
+//	texture maps are split into bands of rows, which the threads draw in parallel.  Within a
+//	band, they are drawn in the order they were recorded, so the result matches drawing them
+//	immediately.
+class tmap_batch_scope
+{
+	const bool previous;
+public:
+	explicit tmap_batch_scope(bool enable);
+	~tmap_batch_scope();
+	tmap_batch_scope(const tmap_batch_scope &) = delete;
+	tmap_batch_scope &operator=(const tmap_batch_scope &) = delete;
+};
 #endif
 class push_interpolation_method
 {
@@ -116,7 +142,7 @@ public:
 //	These are pointers to texture maps.  If you want to render texture map #7, then you will render
 //	the texture map defined by Texmap_ptrs[7].
 
-extern int Window_clip_left, Window_clip_bot, Window_clip_right, Window_clip_top;
+extern thread_local int Window_clip_left, Window_clip_bot, Window_clip_right, Window_clip_top;
 
 // for ugly hack put in to be sure we don't overflow render buffer
 
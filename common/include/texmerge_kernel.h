@@ -0,0 +1,64 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+/*
+ *
+ * Pixel loops that merge an overlay texture onto a base texture.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#ifdef __cplusplus
+namespace dcx {
+
+enum class texmerge_transform : uint8_t
+{
+	/* Copy opaque top texels unchanged. */
+	none,
+	/* Also map palette entry 254 of the top texture to
+	 * TRANSPARENCY_COLOR, so that the merged texture shows through
+	 * where the top texture is supertransparent.
+	 */
+	super_transparent,
+};
+
+/* Instruction sets that may have a merge kernel.  Which ones are built
+ * depends on the target; which ones run depends on the CPU.
+ */
+enum class texmerge_isa : uint8_t
+{
+	scalar,
+	sse2,
+	avx2,
+	neon,
+};
+
+/* Merge a `wh` x `wh` top texture onto a bottom texture of the same
+ * size, writing `wh` * `wh` bytes to `dest`.  The top texture is
+ * rotated by `rotation` quarter turns, as given by
+ * texture2_rotation_low.  Where the rotated top texel is
+ * TRANSPARENCY_COLOR, the bottom texel is used instead.
+ *
+ * This uses the fastest kernel available on the running CPU.
+ */
+void texmerge_merge(unsigned wh, unsigned rotation, texmerge_transform, const uint8_t *top, const uint8_t *bottom, uint8_t *dest);
+
+/* As above, but use the kernel for `isa`.  Returns false without
+ * writing to `dest` if that kernel was not built or cannot run on this
+ * CPU.  For testing kernels against each other.
+ */
+bool texmerge_merge(texmerge_isa isa, unsigned wh, unsigned rotation, texmerge_transform, const uint8_t *top, const uint8_t *bottom, uint8_t *dest);
+
+/* The kernel chosen by texmerge_merge without an explicit `isa`. */
+texmerge_isa texmerge_best_isa();
+const char *texmerge_isa_name(texmerge_isa);
+
+}
+#endif
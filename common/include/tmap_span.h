@@ -0,0 +1,76 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+/*
+ *
+ * Pixel loops that draw one lighted span of a 64x64 texture map.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#ifdef __cplusplus
+namespace dcx {
+
+/* Instruction sets that may have a span kernel.  AVX2 is the first x86
+ * extension with gathers, which the texel and fade table lookups need,
+ * so there is no SSE kernel.
+ */
+enum class tmap_span_isa : uint8_t
+{
+	scalar,
+	avx2,
+};
+
+/* One span of `count` pixels, written left to right from `dest`.  All
+ * coordinates are 16.16 fixed point.  The texel at pixel i is at column
+ * (u + i * du) and row (v + i * dv), both wrapped to 0-63.  Its color is
+ * looked up in row ((l + i * dl) >> 8) of `fade_table`, which must have
+ * `fade_levels` rows of 256 entries.  If `transparent` is set, pixels
+ * whose texel is TRANSPARENCY_COLOR are left unchanged.
+ */
+struct tmap_span
+{
+	const uint8_t *texels;
+	const uint8_t *fade_table;
+	uint8_t *dest;
+	unsigned count;
+	unsigned fade_levels;
+	bool transparent;
+	int32_t u, v, l;
+	int32_t du, dv, dl;
+};
+
+/* A span whose u and v are interpolated with perspective.  Here `u`,
+ * `v`, `du` and `dv` are multiplied by the depth `z`, which changes by
+ * `dz` per pixel.  The exact texel coordinate is computed every
+ * tmap_span_subdivision pixels, and interpolated linearly in between.
+ */
+struct tmap_span_perspective : tmap_span
+{
+	int32_t z, dz;
+};
+
+constexpr unsigned tmap_span_subdivision = 16;
+
+/* Draw `span` with the fastest kernel available on the running CPU. */
+void tmap_span_linear(const tmap_span &span);
+void tmap_span_perspective_draw(const tmap_span_perspective &span);
+
+/* As above, but use the kernel for `isa`.  Returns false without
+ * drawing if that kernel was not built or cannot run on this CPU.
+ */
+bool tmap_span_linear(tmap_span_isa isa, const tmap_span &span);
+bool tmap_span_perspective_draw(tmap_span_isa isa, const tmap_span_perspective &span);
+
+tmap_span_isa tmap_span_best_isa();
+const char *tmap_span_isa_name(tmap_span_isa);
+
+}
+#endif
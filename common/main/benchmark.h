@@ -0,0 +1,28 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+/*
+ *
+ * Headless demo playback benchmark.
+ *
+ */
+
+#pragma once
+
+#ifdef dsx
+namespace dsx {
+
+/* Play `filename` (relative to DEMO_DIR) with a fixed frame step, no
+ * pacing and no presentation, rendering each frame into an offscreen
+ * canvas.  Stop after `frames` frames or at the end of the demo,
+ * whichever comes first, and report the distribution of frame times
+ * to the console.  Returns the number of frames measured.
+ */
+unsigned benchmark_demo_playback(const char *filename, unsigned frames);
+
+}
+#endif
@@ -38,6 +38,11 @@ struct d_level_unique_object_state
 	d_thief_unique_state ThiefState;
 	d_guided_missile_indices Guided_missile;
 #endif
+	/* Objects are allocated only while fewer than this are in use.  It
+	 * is MAX_OBJECTS, except in a multiplayer game, which uses the
+	 * host's limit so that every player can hold every object number.
+	 */
+	unsigned object_limit = MAX_OBJECTS;
 	object_number_array<imobjidx_t, MAX_OBJECTS> free_obj_list;
 	object_array Objects;
 	d_level_unique_boss_state BossState;
@@ -0,0 +1,38 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+/*
+ *
+ * Offline demo export to images, raw video and raw sound.
+ *
+ */
+
+#pragma once
+
+#ifdef dsx
+#include <string>
+
+namespace dsx {
+
+/* Play `filename` (relative to DEMO_DIR) with a fixed step of 1/`fps`
+ * second of demo time per frame, with no pacing and no presentation.
+ * Render each frame as the player saw it, cockpit and HUD included,
+ * and write it to every output that is not empty:
+ *
+ *	`png_dir`: one PNG per frame, numbered from 000000.png, in this
+ *		directory of the write directory
+ *	`video_path`: raw 24-bit RGB at the screen size, top row first
+ *	`audio_path`: raw unsigned 8-bit stereo sound effects, exactly
+ *		1/`fps` second per frame
+ *
+ * The raw outputs are opened with the host's file API, so they may be
+ * named pipes to an encoder.  Returns the number of frames written.
+ */
+unsigned export_demo(const char *filename, unsigned fps, const std::string &png_dir, const std::string &video_path, const std::string &audio_path);
+
+}
+#endif
@@ -0,0 +1,36 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+/*
+ *
+ * Statistics extracted from recorded demos, without rendering.
+ *
+ */
+
+#pragma once
+
+#ifdef dsx
+#include <string>
+#include <vector>
+
+namespace dsx {
+
+/* Read each demo in `demos` (relative to DEMO_DIR) as fast as it can be
+ * decoded, and write its kills, deaths, damage to the recording player,
+ * weapons fired and player positions to DEMO_DIR, next to the demo, as
+ * JSON or, if `csv`, as CSV.
+ *
+ * The decoder works on the global game state, so one process can read
+ * only one demo at a time.  Given several demos, this runs a copy of
+ * the program (`argv`, minus the demo options) for each one, with up to
+ * `jobs` copies at once, or one per CPU if `jobs` is 0.  Returns the
+ * number of demos that were read.
+ */
+unsigned demo_stats(const std::vector<std::string> &demos, unsigned jobs, bool csv, int argc, char **argv);
+
+}
+#endif
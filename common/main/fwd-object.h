@@ -17,14 +17,21 @@
 #include "fwd-window.h"
 #include "fwd-valptridx.h"
 #include <array>
+#include <vector>
 
 struct bitmap_index;
 
 namespace dcx {
 
 // Movement types
-constexpr std::integral_constant<std::size_t, 350> MAX_OBJECTS{};
-constexpr std::integral_constant<std::size_t, MAX_OBJECTS - 20> MAX_USED_OBJECTS{};
+/* Room is reserved for this many objects.  A level may allow fewer; see
+ * d_level_unique_object_state::object_limit.
+ */
+constexpr std::integral_constant<std::size_t, 1000> MAX_OBJECTS{};
+/* Effects are culled to keep this many slots below the limit free. */
+constexpr std::integral_constant<std::size_t, 20> RESERVED_OBJECT_SLOTS{};
+/* The smallest limit a host may set: the size of the old fixed array. */
+constexpr std::integral_constant<std::size_t, 350> MIN_OBJECT_LIMIT{};
 struct d_level_unique_control_center_state;
 
 // Render types
@@ -299,6 +306,17 @@ void wake_up_rendered_objects(const object &gmissp, window_rendered_data &window
 void fuelcen_check_for_goal(object &plrobj, const shared_segment &segp);
 #endif
 imobjptridx_t obj_find_first_of_type(fvmobjptridx &, object_type_t type);
+/* The objects of `type` when this frame first asked, plus any that were
+ * created since.  An object that has since changed type, or been
+ * deleted, may still be listed, so callers must check the type.
+ */
+const std::vector<objnum_t> &obj_list_of_type(object_type_t type);
+#if defined(DXX_BUILD_DESCENT_II)
+/* As obj_list_of_type, for proximity bombs and player smart mines. */
+const std::vector<objnum_t> &obj_list_of_mines();
+#endif
+/* Call after objects are replaced other than by obj_create. */
+void obj_invalidate_type_lists();
 
 void object_rw_swap(struct object_rw *obj_rw, int swap);
 void reset_player_object();
@@ -29,6 +29,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "maths.h"
 
 #include <chrono>
+#include <ctime>
 #include <cstdint>
 #include "pack.h"
 #include "fwd-object.h"
@@ -257,6 +258,7 @@ extern d_level_unique_seismic_state LevelUniqueSeismicState;
 extern d_game_shared_state GameSharedState;
 extern d_game_unique_state GameUniqueState;
 void game_render_frame(const control_info &Controls);
+window_event_result game_process_fixed_frame(fix frame_time);
 }
 #endif
 
@@ -287,6 +289,22 @@ namespace dcx {
 #if DXX_USE_SCREENSHOT_FORMAT_LEGACY
 void write_bmp(PHYSFS_File *, unsigned w, unsigned h);
 #endif
+#if DXX_USE_SCREENSHOT_FORMAT_PNG
+/* Write `bitmap` to `file` as a PNG.  With OpenGL, the pixels are read
+ * from the current read buffer, at the size of `bitmap`, and there is
+ * no palette.  `tm`, if not nullptr, is recorded as the image time.
+ * Returns nonzero on failure.
+ */
+#if DXX_USE_OGL
+unsigned write_screenshot_png(PHYSFS_File *file, const struct tm *tm, const grs_bitmap &bitmap);
+static inline unsigned write_screenshot_png(PHYSFS_File *const file, const struct tm *const tm, const grs_bitmap &bitmap, const palette_array_t &)
+{
+	return write_screenshot_png(file, tm, bitmap);
+}
+#else
+unsigned write_screenshot_png(PHYSFS_File *file, const struct tm *tm, const grs_bitmap &bitmap, const palette_array_t &pal);
+#endif
+#endif
 extern void save_screen_shot(int automap_flag);
 
 }
@@ -215,10 +215,8 @@ static inline vms_vector pick_random_point_in_seg(fvcvertptr &vcvertptr, const s
 
 int check_segment_connections(void);
 unsigned set_segment_depths(vcsegidx_t start_seg, const std::array<uint8_t, MAX_SEGMENTS> *limit, segment_depth_array_t &depths);
-#if defined(DXX_BUILD_DESCENT_I)
-static inline void flush_fcd_cache() {}
-#elif defined(DXX_BUILD_DESCENT_II)
 void flush_fcd_cache();
+#if defined(DXX_BUILD_DESCENT_II)
 void apply_all_changed_light(const d_level_shared_destructible_light_state &LevelSharedDestructibleLightState, fvmsegptridx &vmsegptridx);
 void	set_ambient_sound_flags(void);
 #endif
@@ -96,7 +96,7 @@ extern int multi_protocol; // set and determinate used protocol
 #define MULTI_PROTO_UDP 1 // UDP protocol
 
 // What version of the multiplayer protocol is this? Increment each time something drastic changes in Multiplayer without the version number changes. Reset to 0 each time the version of the game changes
-#define MULTI_PROTO_VERSION	static_cast<uint16_t>(12)
+#define MULTI_PROTO_VERSION	static_cast<uint16_t>(13)
 // PROTOCOL VARIABLES AND DEFINES - END
 
 // limits for Packets (i.e. positional updates) per sec
@@ -629,6 +629,8 @@ struct bit_game_flags {
 #define NETGAME_FLAG_REALLY_ENDLEVEL    32
 #define NETGAME_FLAG_REALLY_FORMING     64
 #endif
+	unsigned dedicated_host : 1;
+#define NETGAME_FLAG_DEDICATED_HOST     128
 } __pack__;
 }
 
@@ -661,6 +663,7 @@ static inline bit_game_flags unpack_game_flags(const packed_game_flags *p)
 	flags.endlevel = !!(p->value & NETGAME_FLAG_REALLY_ENDLEVEL);
 	flags.forming = !!(p->value & NETGAME_FLAG_REALLY_FORMING);
 #endif
+	flags.dedicated_host = !!(p->value & NETGAME_FLAG_DEDICATED_HOST);
 	return flags;
 }
 
@@ -676,6 +679,7 @@ static inline packed_game_flags pack_game_flags(const bit_game_flags *flags)
 		(flags->endlevel ? NETGAME_FLAG_REALLY_ENDLEVEL : 0) |
 		(flags->forming ? NETGAME_FLAG_REALLY_FORMING : 0) |
 #endif
+		(flags->dedicated_host ? NETGAME_FLAG_DEDICATED_HOST : 0) |
 		0;
 	return p;
 }
@@ -817,6 +821,8 @@ struct netgame_info : prohibit_void_ptr<netgame_info>
 	ubyte   					team_vector;
 	uint8_t						SecludedSpawns;
 	uint8_t MouselookFlags;
+	/* The host's object_limit, which every player uses. */
+	uint16_t ObjectLimit;
 	uint32_t					AllowedItems;
 	packed_spawn_granted_items SpawnGrantedItems;
 	packed_netduplicate_items DuplicatePowerups;
@@ -45,6 +45,7 @@ using udp::dispatch;
 }
 
 window_event_result net_udp_setup_game(void);
+window_event_result net_udp_start_dedicated_game();
 }
 #endif
 void net_udp_manual_join_game();
@@ -124,6 +125,10 @@ constexpr std::integral_constant<unsigned, 12> UDP_NETGAMES_PPAGE{}; // Netgames
 #define UPID_TRACKER_ACK			 25 // An ACK packet from the tracker
 #define UPID_TRACKER_HOLEPUNCH			 26 // Hole punching process. Sent from client to tracker to request hole punching from game host and received by host from tracker to initiate hole punching to requesting client
 #endif
+#define UPID_PDATA_DELTA			 27 // Packet from player containing his movement data as a difference from an earlier packet the receiver ACK'd. Only sent to players who sent UPID_PDATA_ACK.
+#define UPID_PDATA_DELTA_HEADER_SIZE		  7
+#define UPID_PDATA_ACK				 28 // ACK packet for UPID_PDATA_DELTA. Also tells the receiver that UPID_PDATA_DELTA is understood.
+#define UPID_PDATA_ACK_SIZE_MAX			 (3 + 3 * MAX_PLAYERS)
 
 // Structure keeping lite game infos (for netlist, etc.)
 #if defined(DXX_BUILD_DESCENT_I) || defined(DXX_BUILD_DESCENT_II)
@@ -171,6 +176,7 @@ struct UDP_mdata_store : prohibit_void_ptr<UDP_mdata_store>
 	std::array<uint32_t, MAX_PLAYERS>	pkt_num;			// Packet number
 	sbyte				used;
 	ubyte				Player_num;				// sender of this packet
+	ubyte				needack;				// number of players that have not ACK'd this packet
 	uint16_t			data_size;
 	std::array<uint8_t, MAX_PLAYERS>		player_ack; 		// 0 if player has not ACK'd this packet, 1 if ACK'd or not connected
 	std::array<uint8_t, UPID_MDATA_BUF_SIZE> data;		// extra data of a packet - contains all multibuf data we don't want to loose
@@ -179,8 +185,7 @@ struct UDP_mdata_store : prohibit_void_ptr<UDP_mdata_store>
 // structure to keep track of MDATA packets we already got, which we expect from another player and the pkt_num for the next packet we want to send to another player
 struct UDP_mdata_check : public prohibit_void_ptr<UDP_mdata_check>
 {
-	std::array<uint32_t, UDP_MDATA_STOR_QUEUE_SIZE>			pkt_num; 	// all those we got just recently, so we can ignore them if we get them again
-	int				cur_slot; 				// index we can use for a new pkt_num
+	std::array<uint32_t, UDP_MDATA_STOR_QUEUE_SIZE>			pkt_num; 	// all those we got just recently, so we can ignore them if we get them again.  Indexed by pkt_num % UDP_MDATA_STOR_QUEUE_SIZE.
 	uint32_t			pkt_num_torecv; 			// the next pkt_num we await for this player
 	uint32_t			pkt_num_tosend; 			// the next pkt_num we want to send to another player
 };
@@ -26,6 +26,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #pragma once
 
 #ifdef __cplusplus
+#include <vector>
 #include "physfsx.h"
 #include "fwd-object.h"
 #include "fwd-segment.h"
@@ -147,6 +148,32 @@ extern window_event_result newdemo_goto_end(int to_rewrite);
 }
 #endif
 extern window_event_result newdemo_goto_beginning();
+extern window_event_result newdemo_seek_frames(int frames);
+
+/* A kill, death or shield change, as recorded in the demo.  `value` is
+ * the number of kills (negative for a suicide), 1 for a death, or the
+ * new shield level of the recording player.
+ */
+struct newdemo_scan_event
+{
+	enum class kind : uint8_t
+	{
+		kill,
+		death,
+		shields,
+	};
+	kind type;
+	uint8_t player;
+	int value;
+};
+
+/* Read the next frame of the demo being played back, without pacing,
+ * sound or rendering, for tools that only inspect the game state.  Set
+ * `frame_time` to the recorded length of that frame, and append the
+ * events it records to `events`.  At the end of the demo, or if it
+ * cannot be read, stop playback and return false.
+ */
+bool newdemo_read_next_frame(fix &frame_time, std::vector<newdemo_scan_event> &events);
 
 // Interactive functions to control playback/record;
 #ifdef dsx
@@ -0,0 +1,128 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+/*
+ *
+ * Bit-packed differences between two player position snapshots.
+ *
+ * Between two updates of a moving ship most fields change by a small
+ * amount, and a ship at rest changes by nothing, so most differences fit
+ * in 0 or 8 bits instead of the 16 or 32 bits of the full value.
+ *
+ */
+
+#include "pdata_delta.h"
+
+namespace dcx {
+
+namespace {
+
+constexpr std::array<uint8_t, 4> width_class_bits{{0, 8, 16, 32}};
+
+/* Bits are packed from the least significant bit of each byte up, so
+ * that the stream does not depend on host byte order.
+ */
+class bit_writer
+{
+	uint8_t *const out;
+	std::size_t bit = 0;
+public:
+	bit_writer(uint8_t *const o) :
+		out(o)
+	{
+	}
+	void write(uint32_t value, unsigned bits)
+	{
+		for (; bits; --bits, value >>= 1, ++bit)
+		{
+			auto &b = out[bit >> 3];
+			const uint8_t mask = 1 << (bit & 7);
+			b = (value & 1) ? (b | mask) : (b & ~mask);
+		}
+	}
+	std::size_t size() const
+	{
+		return (bit + 7) >> 3;
+	}
+};
+
+class bit_reader
+{
+	const uint8_t *const in;
+	const std::size_t limit;
+	std::size_t bit = 0;
+public:
+	bit_reader(const uint8_t *const i, const std::size_t size) :
+		in(i), limit(size * 8)
+	{
+	}
+	bool read(uint32_t &value, const unsigned bits)
+	{
+		if (limit - bit < bits)
+			return false;
+		value = 0;
+		for (unsigned i = 0; i < bits; ++i, ++bit)
+			value |= static_cast<uint32_t>((in[bit >> 3] >> (bit & 7)) & 1) << i;
+		return true;
+	}
+};
+
+static uint32_t zigzag_encode(const uint32_t d)
+{
+	return (d << 1) ^ -(d >> 31);
+}
+
+static uint32_t zigzag_decode(const uint32_t z)
+{
+	return (z >> 1) ^ -(z & 1);
+}
+
+static unsigned get_width_class(const uint32_t z)
+{
+	if (!z)
+		return 0;
+	if (z <= UINT8_MAX)
+		return 1;
+	if (z <= UINT16_MAX)
+		return 2;
+	return 3;
+}
+
+}
+
+std::size_t pdata_delta_encode(const pdata_snapshot &baseline, const pdata_snapshot &snapshot, uint8_t *const out)
+{
+	bit_writer w(out);
+	for (std::size_t i = 0; i < pdata_delta_fields; ++i)
+	{
+		/* Differences are taken modulo 2^32, so that every pair of
+		 * values has one, and decoding restores the value exactly.
+		 */
+		const uint32_t z = zigzag_encode(static_cast<uint32_t>(snapshot[i]) - static_cast<uint32_t>(baseline[i]));
+		const auto width_class = get_width_class(z);
+		w.write(width_class, 2);
+		w.write(z, width_class_bits[width_class]);
+	}
+	return w.size();
+}
+
+bool pdata_delta_decode(const pdata_snapshot &baseline, const uint8_t *const in, const std::size_t size, pdata_snapshot &snapshot)
+{
+	bit_reader r(in, size);
+	pdata_snapshot result;
+	for (std::size_t i = 0; i < pdata_delta_fields; ++i)
+	{
+		uint32_t width_class, z;
+		if (!r.read(width_class, 2) || !r.read(z, width_class_bits[width_class]))
+			return false;
+		result[i] = static_cast<int32_t>(static_cast<uint32_t>(baseline[i]) + zigzag_decode(z));
+	}
+	snapshot = result;
+	return true;
+}
+
+}
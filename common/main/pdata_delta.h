@@ -0,0 +1,50 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+/*
+ *
+ * Bit-packed differences between two player position snapshots.
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __cplusplus
+namespace dcx {
+
+/* The fields of one position update: orientation (4), position (3),
+ * segment (1), velocity (3) and rotational velocity (3).  The codec does
+ * not care what they mean; the caller only has to use the same order on
+ * both ends.
+ */
+constexpr std::size_t pdata_delta_fields = 14;
+using pdata_snapshot = std::array<int32_t, pdata_delta_fields>;
+
+/* Each field is stored as a 2-bit width class followed by that many bits
+ * of its zigzag-encoded difference from the baseline.  The worst case
+ * is every field needing all 32 bits.
+ */
+constexpr std::size_t pdata_delta_max_size = (pdata_delta_fields * (2 + 32) + 7) / 8;
+
+/* Write the difference of `snapshot` from `baseline` to `out`, which
+ * must hold pdata_delta_max_size bytes.  Returns the number of bytes
+ * written.  A snapshot with no baseline is encoded against a
+ * value-initialized pdata_snapshot.
+ */
+std::size_t pdata_delta_encode(const pdata_snapshot &baseline, const pdata_snapshot &snapshot, uint8_t *out);
+
+/* Apply the difference in the `size` bytes at `in` to `baseline`, and
+ * store the result in `snapshot`.  Returns false if `in` is truncated.
+ */
+bool pdata_delta_decode(const pdata_snapshot &baseline, const uint8_t *in, std::size_t size, pdata_snapshot &snapshot);
+
+}
+#endif
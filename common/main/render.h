@@ -129,6 +129,21 @@ void render_mine(grs_canvas &, const vms_vector &, vcsegidx_t start_seg_num, fix
 
 #if defined(DXX_BUILD_DESCENT_II)
 void update_rendered_data(window_rendered_data &window, const object &viewer, int rear_view_flag);
+
+// While this exists, render_mine records each view that it draws.  When
+// the next scope is created, the segment lists of those views are built
+// again on several threads, and render_mine uses each list if its view
+// has not changed since then.  This lets the extra cockpit views build
+// their lists at the same time as the main view.
+class render_view_prefetch_scope
+{
+public:
+	render_view_prefetch_scope();
+	~render_view_prefetch_scope();
+	render_view_prefetch_scope(const render_view_prefetch_scope &) = delete;
+	render_view_prefetch_scope &operator=(const render_view_prefetch_scope &) = delete;
+};
+void render_view_prefetch_close();
 #endif
 
 static inline void render_frame(grs_canvas &canvas, fix eye_offset)
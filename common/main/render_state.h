@@ -1,10 +1,10 @@
 #pragma once
 
-#include <unordered_map>
 #include <vector>
 #include "dxxsconf.h"
 #include "fwd-segment.h"
 #include "objnum.h"
+#include "compiler-range_for.h"
 #include <array>
 
 constexpr std::integral_constant<unsigned, 500> MAX_RENDER_SEGS{};
@@ -26,15 +26,56 @@ struct render_state_t
 		};
 		std::vector<distant_object> objects;
 		uint16_t Seg_depth = 0;		//depth for this seg in Render_list
+		uint16_t generation = 0;	//traversal that last reset this entry
+		short render_pos = -1;		//where in render_list does this segment appear?
 		bool processed = false;		//whether this entry has been processed
+		bool rendered = false;		//whether this segment has been drawn
 		rect render_window;
 	};
+	/* One entry per segment of the level, not per MAX_SEGMENTS.
+	 * Entries are reset when first used in a traversal, rather than all
+	 * at once, and keep the capacity of their object lists, so that a
+	 * state which is reused does not allocate once the level has been
+	 * seen.
+	 */
+	class per_segment_table_t
+	{
+		std::vector<per_segment_state_t> states;
+		uint16_t generation = 0;
+	public:
+		void reset(std::size_t segment_count);
+		per_segment_state_t &operator[](const segnum_t segnum)
+		{
+			auto &s = states[segnum];
+			if (s.generation != generation)
+			{
+				s.objects.clear();
+				s.Seg_depth = 0;
+				s.generation = generation;
+				s.render_pos = -1;
+				s.processed = false;
+				s.rendered = false;
+			}
+			return s;
+		}
+	};
 	unsigned N_render_segs = 0;
+	unsigned first_terminal_seg = 0;
 	std::array<segnum_t, MAX_RENDER_SEGS> Render_list;
-	std::array<short, MAX_SEGMENTS> render_pos;	//where in render_list does this segment appear?
-	std::unordered_map<segnum_t, per_segment_state_t> render_seg_map;
+	per_segment_table_t render_seg_map;
 };
 
+inline void render_state_t::per_segment_table_t::reset(const std::size_t segment_count)
+{
+	if (states.size() != segment_count)
+		states.resize(segment_count);
+	if (++generation)
+		return;
+	range_for (auto &s, states)
+		s.generation = 0;
+	generation = 1;
+}
+
 }
 
 #ifdef dsx
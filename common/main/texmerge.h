@@ -31,9 +31,19 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 
 struct grs_bitmap;
 
+#define TEXMERGE_CACHE_SIZE_DEFAULT	64
+
+struct texmerge_cache_stats
+{
+	unsigned hits;
+	unsigned misses;
+};
+
 int texmerge_init();
 grs_bitmap &texmerge_get_cached_bitmap(texture1_value tmap_bottom, texture2_value tmap_top);
 void texmerge_close();
 void texmerge_flush();
+/* Lookups since texmerge_init. */
+const texmerge_cache_stats &texmerge_get_stats();
 
 #endif /* _TEXMERGE_H */
@@ -0,0 +1,126 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+/*
+ *
+ * Recorded UDP datagrams, and a simulated link that delays, drops and
+ * reorders them.
+ *
+ * The link has its own random number generator, so that a simulated
+ * run does not disturb, and is not disturbed by, the game's d_rand.
+ *
+ */
+
+#include <algorithm>
+#include "udp_capture.h"
+
+namespace dcx {
+
+namespace {
+
+static void put_le(std::vector<uint8_t> &out, uint32_t value, unsigned bytes)
+{
+	for (; bytes; --bytes, value >>= 8)
+		out.emplace_back(static_cast<uint8_t>(value));
+}
+
+static uint32_t get_le(const uint8_t *const in, const unsigned bytes)
+{
+	uint32_t value = 0;
+	for (unsigned i = bytes; i--;)
+		value = (value << 8) | in[i];
+	return value;
+}
+
+}
+
+void udp_capture_encode(const udp_capture_record &record, std::vector<uint8_t> &out)
+{
+	const std::size_t address_size = std::min(record.address.size(), udp_capture_max_address);
+	const std::size_t payload_size = std::min<std::size_t>(record.payload.size(), UINT16_MAX);
+	out.reserve(out.size() + 4 + 1 + address_size + 2 + payload_size);
+	put_le(out, record.time, 4);
+	put_le(out, address_size, 1);
+	out.insert(out.end(), record.address.begin(), record.address.begin() + address_size);
+	put_le(out, payload_size, 2);
+	out.insert(out.end(), record.payload.begin(), record.payload.begin() + payload_size);
+}
+
+std::size_t udp_capture_decode(const uint8_t *const in, const std::size_t size, udp_capture_record &record)
+{
+	std::size_t used = 4 + 1;
+	if (size < used)
+		return 0;
+	const std::size_t address_size = in[4];
+	if (size < used + address_size + 2)
+		return 0;
+	const auto address = in + used;
+	used += address_size;
+	const std::size_t payload_size = get_le(in + used, 2);
+	used += 2;
+	if (size < used + payload_size)
+		return 0;
+	record.time = get_le(in, 4);
+	record.address.assign(address, address + address_size);
+	record.payload.assign(in + used, in + used + payload_size);
+	return used + payload_size;
+}
+
+udp_link_queue::udp_link_queue(const udp_link_model &m) :
+	model(m), random_state(m.seed ? m.seed : 0x9e3779b9u)
+{
+}
+
+/* xorshift32, which is enough to pick which datagrams to disturb. */
+uint32_t udp_link_queue::next_random()
+{
+	auto x = random_state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return random_state = x;
+}
+
+/* Order for std::push_heap, which keeps the largest element first, so
+ * the earliest due datagram compares largest.
+ */
+bool udp_link_queue::later(const entry &a, const entry &b)
+{
+	if (a.due != b.due)
+		return a.due > b.due;
+	return a.sequence > b.sequence;
+}
+
+bool udp_link_queue::push(udp_capture_record &&record)
+{
+	/* Draw every random number for every datagram, so that changing one
+	 * parameter does not change which datagrams the others pick.
+	 */
+	const bool lost = next_random() % 100 < model.loss;
+	const bool reordered = next_random() % 100 < model.reorder;
+	const uint32_t jitter = next_random() % (uint32_t{model.jitter} + 1);
+	if (lost)
+		return false;
+	uint32_t due = record.time + model.latency + jitter;
+	if (reordered)
+		due += uint32_t{model.latency} + model.jitter + 1;
+	in_flight.push_back(entry{due, sequence++, std::move(record)});
+	std::push_heap(in_flight.begin(), in_flight.end(), later);
+	return true;
+}
+
+bool udp_link_queue::pop(const uint32_t now, udp_capture_record &record)
+{
+	if (in_flight.empty() || in_flight.front().due > now)
+		return false;
+	std::pop_heap(in_flight.begin(), in_flight.end(), later);
+	record = std::move(in_flight.back().record);
+	in_flight.pop_back();
+	return true;
+}
+
+}
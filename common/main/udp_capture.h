@@ -0,0 +1,110 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+/*
+ *
+ * Recorded UDP datagrams, and a simulated link that delays, drops and
+ * reorders them.
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifdef __cplusplus
+namespace dcx {
+
+/* A capture file starts with this header, followed by one record per
+ * datagram.  Each record is, in little endian:
+ *
+ *	uint32_t time, in milliseconds since the capture started
+ *	uint8_t address size, then that many bytes of the sender address
+ *	uint16_t payload size, then that many bytes of payload
+ *
+ * The sender address is stored as the bytes of the host's socket
+ * address, so it is only meaningful when replayed on the same platform.
+ */
+constexpr std::array<uint8_t, 8> udp_capture_header{{'D', 'X', 'X', 'U', 'D', 'P', 'C', 1}};
+constexpr std::size_t udp_capture_max_address = 255;
+
+struct udp_capture_record
+{
+	uint32_t time;
+	std::vector<uint8_t> address;
+	std::vector<uint8_t> payload;
+};
+
+/* Append `record` to `out`. */
+void udp_capture_encode(const udp_capture_record &record, std::vector<uint8_t> &out);
+
+/* Read one record from the `size` bytes at `in`.  Returns the number of
+ * bytes used, or 0 if `in` does not hold a whole record.
+ */
+std::size_t udp_capture_decode(const uint8_t *in, std::size_t size, udp_capture_record &record);
+
+/* How the simulated link treats each datagram: `loss` and `reorder` are
+ * percentages, and `latency` and `jitter` are in milliseconds.  A
+ * datagram that is not lost is delayed by `latency` plus a random part
+ * of `jitter`.  A reordered datagram is held back a further `latency`
+ * plus `jitter` and 1 millisecond, so that the datagrams sent after it
+ * can overtake it.  The same `seed` and input always give the same
+ * output.
+ */
+struct udp_link_model
+{
+	uint8_t loss, reorder;
+	uint16_t latency, jitter;
+	uint32_t seed;
+	bool active() const
+	{
+		return loss || reorder || latency || jitter;
+	}
+};
+
+/* Datagrams in flight on a simulated link.  Datagrams that become due
+ * at the same time are delivered in the order they were pushed.
+ */
+class udp_link_queue
+{
+	struct entry
+	{
+		uint32_t due;
+		uint32_t sequence;
+		udp_capture_record record;
+	};
+	std::vector<entry> in_flight;
+	udp_link_model model;
+	uint32_t random_state;
+	uint32_t sequence = 0;
+	uint32_t next_random();
+	static bool later(const entry &a, const entry &b);
+public:
+	explicit udp_link_queue(const udp_link_model &m = {});
+	/* Send `record`, which arrives at `record.time`.  Returns false if
+	 * the link drops it.
+	 */
+	bool push(udp_capture_record &&record);
+	/* Remove the next datagram that is due at or before `now`.  Returns
+	 * false if none is due.
+	 */
+	bool pop(uint32_t now, udp_capture_record &record);
+	bool empty() const
+	{
+		return in_flight.empty();
+	}
+	void clear()
+	{
+		in_flight.clear();
+	}
+};
+
+}
+#endif
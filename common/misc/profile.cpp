@@ -0,0 +1,198 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+/*
+ *
+ * Scoped timers for the hot paths of a frame.
+ *
+ * Each thread that records a zone gets its own single-producer ring
+ * buffer, so recording never takes a lock.  The main thread drains
+ * every ring once per frame.
+ *
+ */
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <stdio.h>
+#include "profile.h"
+#include "console.h"
+#include "physfsx.h"
+
+#include "compiler-range_for.h"
+#include "d_enumerate.h"
+
+namespace dcx {
+
+bool profile_active;
+
+namespace {
+
+constexpr std::array<const char *, profile_zone_count> profile_zone_labels{{
+	"GameProcessFrame",
+	"render_mine",
+	"build_segment_list",
+	"do_ai_frame",
+	"do_physics_sim",
+	"find_vector_intersection",
+	"digi_sync_sounds",
+	"net_udp_process_packet",
+}};
+
+/* Number of frames folded into each published average. */
+constexpr unsigned profile_average_frames = 30;
+
+struct profile_event
+{
+	profile_zone zone;
+	profile_clock::duration elapsed;
+};
+
+class profile_ring
+{
+	std::array<profile_event, 4096> events;
+	std::atomic<std::size_t> head{0}, tail{0};
+	std::atomic<unsigned> dropped{0};
+public:
+	void push(const profile_event &e)
+	{
+		const auto h = head.load(std::memory_order_relaxed);
+		if (h - tail.load(std::memory_order_acquire) >= events.size())
+		{
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		events[h % events.size()] = e;
+		head.store(h + 1, std::memory_order_release);
+	}
+	template <typename F>
+		void drain(profile_frame_summary &summary, F &&f)
+		{
+			const auto h = head.load(std::memory_order_acquire);
+			auto t = tail.load(std::memory_order_relaxed);
+			for (; t != h; ++t)
+				f(events[t % events.size()]);
+			tail.store(t, std::memory_order_release);
+			summary.dropped += dropped.exchange(0, std::memory_order_relaxed);
+		}
+};
+
+/* Rings are never freed, so a thread that exits mid-frame does not
+ * race with the drain.  The number of threads is small and fixed.
+ */
+static std::mutex profile_ring_registry_mutex;
+static std::vector<std::unique_ptr<profile_ring>> profile_ring_registry;
+static thread_local profile_ring *profile_thread_ring;
+
+static profile_frame_summary profile_last, profile_average, profile_accumulator;
+static unsigned profile_accumulated_frames;
+static unsigned profile_frame_number;
+static RAIIPHYSFS_File profile_csv;
+
+static profile_ring &profile_get_thread_ring()
+{
+	if (const auto r = profile_thread_ring)
+		return *r;
+	std::lock_guard<std::mutex> lock(profile_ring_registry_mutex);
+	profile_ring_registry.emplace_back(std::make_unique<profile_ring>());
+	return *(profile_thread_ring = profile_ring_registry.back().get());
+}
+
+static void profile_write_csv_row(const profile_frame_summary &frame)
+{
+	char buf[32];
+	PHYSFSX_puts(profile_csv, buf, snprintf(buf, sizeof(buf), "%u", profile_frame_number));
+	range_for (auto &z, frame.zones)
+	{
+		const auto us = std::chrono::duration_cast<std::chrono::microseconds>(z.elapsed).count();
+		PHYSFSX_puts(profile_csv, buf, snprintf(buf, sizeof(buf), ",%lld,%u", static_cast<long long>(us), z.calls));
+	}
+	PHYSFSX_puts(profile_csv, buf, snprintf(buf, sizeof(buf), ",%u\n", frame.dropped));
+}
+
+}
+
+const char *profile_zone_label(const profile_zone zone)
+{
+	return profile_zone_labels[static_cast<std::size_t>(zone)];
+}
+
+void profile_record(const profile_zone zone, const profile_clock::duration elapsed)
+{
+	profile_get_thread_ring().push({zone, elapsed});
+}
+
+void profile_end_frame()
+{
+	if (!profile_active)
+		return;
+	profile_frame_summary frame{};
+	{
+		std::lock_guard<std::mutex> lock(profile_ring_registry_mutex);
+		range_for (auto &r, profile_ring_registry)
+			r->drain(frame, [&frame](const profile_event &e) {
+				auto &z = frame.zones[static_cast<std::size_t>(e.zone)];
+				z.elapsed += e.elapsed;
+				++ z.calls;
+			});
+	}
+	profile_last = frame;
+	range_for (auto &&e, enumerate(frame.zones))
+	{
+		auto &a = profile_accumulator.zones[e.idx];
+		a.elapsed += e.value.elapsed;
+		a.calls += e.value.calls;
+	}
+	profile_accumulator.dropped += frame.dropped;
+	if (++ profile_accumulated_frames == profile_average_frames)
+	{
+		range_for (auto &&e, enumerate(profile_accumulator.zones))
+		{
+			auto &a = profile_average.zones[e.idx];
+			a.elapsed = e.value.elapsed / profile_average_frames;
+			a.calls = e.value.calls / profile_average_frames;
+		}
+		profile_average.dropped = profile_accumulator.dropped;
+		profile_accumulator = {};
+		profile_accumulated_frames = 0;
+	}
+	if (profile_csv)
+		profile_write_csv_row(frame);
+	++ profile_frame_number;
+}
+
+const profile_frame_summary &profile_last_frame()
+{
+	return profile_last;
+}
+
+const profile_frame_summary &profile_average_frame()
+{
+	return profile_average;
+}
+
+void profile_open_csv(const char *const filename)
+{
+	profile_csv = PHYSFSX_openWriteBuffered(filename);
+	if (!profile_csv)
+	{
+		con_printf(CON_URGENT, "Failed to open profile CSV \"%s\": %s", filename, PHYSFS_getLastError());
+		return;
+	}
+	PHYSFSX_puts_literal(profile_csv, "frame");
+	range_for (const auto label, profile_zone_labels)
+		PHYSFSX_printf(profile_csv, ",%s_us,%s_calls", label, label);
+	PHYSFSX_puts_literal(profile_csv, ",dropped\n");
+}
+
+void profile_close_csv()
+{
+	profile_csv.reset();
+}
+
+}
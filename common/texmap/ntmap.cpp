@@ -38,6 +38,7 @@ COPYRIGHT 1993-1998 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 
 #include "dxxsconf.h"
 #include "dsx-ns.h"
+#include <climits>
 #include <utility>
 
 namespace dcx {
@@ -54,14 +55,15 @@ unsigned	Current_seg_depth;		// HACK INTERFACE: how far away the current segment
 // These variables are the interface to assembler.  They get set for each texture map, which is a real waste of time.
 //	They should be set only when they change, which is generally when the window bounds change.  And, even still, it's
 //	a pretty bad interface.
-int	bytes_per_row=-1;
-unsigned char *write_buffer;
+//	They are thread_local so that batched texture maps can be drawn by several threads at once.
+thread_local int	bytes_per_row=-1;
+thread_local unsigned char *write_buffer;
 
-fix fx_l, fx_u, fx_v, fx_z, fx_du_dx, fx_dv_dx, fx_dz_dx, fx_dl_dx;
-int fx_xleft, fx_xright, fx_y;
-const unsigned char *pixptr;
-uint8_t Transparency_on = 0;
-uint8_t tmap_flat_color;
+thread_local fix fx_l, fx_u, fx_v, fx_z, fx_du_dx, fx_dv_dx, fx_dz_dx, fx_dl_dx;
+thread_local int fx_xleft, fx_xright, fx_y;
+thread_local const unsigned char *pixptr;
+thread_local uint8_t Transparency_on = 0;
+thread_local uint8_t tmap_flat_color;
 
 int	Interpolation_method;	// 0 = choose best method
 // -------------------------------------------------------------------------------------
@@ -99,7 +101,10 @@ void init_interface_vars_to_assembler(void)
 	Window_clip_bot = static_cast<int>(bp->bm_h)-1;
 }
 
-static int Lighting_enabled;
+static thread_local int Lighting_enabled;
+//	Rows outside [Band_top, Band_bot] are stepped over but not drawn.  A batched texture map is drawn
+//	once per band of rows that it touches, each time by whichever thread owns that band.
+static thread_local int Band_top = INT_MIN, Band_bot = INT_MAX;
 // -------------------------------------------------------------------------------------
 //                             VARIABLES
 
@@ -280,7 +285,7 @@ static fix compute_dz_dy(const g3ds_tmap &t, int top_vertex,int bottom_vertex, f
 // -------------------------------------------------------------------------------------
 //	Texture map current scanline in perspective.
 // -------------------------------------------------------------------------------------
-static void ntmap_scanline_lighted(const grs_bitmap &srcb, int y, fix xleft, fix xright, fix uleft, fix uright, fix vleft, fix vright, fix zleft, fix zright, fix lleft, fix lright)
+static void ntmap_scanline_lighted(const uint8_t *const texels, int y, fix xleft, fix xright, fix uleft, fix uright, fix vleft, fix vright, fix zleft, fix zright, fix lleft, fix lright)
 {
 	fix	dx,recip_dx;
 
@@ -308,7 +313,7 @@ static void ntmap_scanline_lighted(const grs_bitmap &srcb, int y, fix xleft, fix
 	fx_dv_dx = fixmul(vright - vleft,recip_dx);
 	fx_dz_dx = fixmul(zright - zleft,recip_dx);
 	fx_y = y;
-	pixptr = srcb.bm_data;
+	pixptr = texels;
 
 	switch (Lighting_enabled) {
 		case 0:
@@ -367,7 +372,7 @@ static void ntmap_scanline_lighted(const grs_bitmap &srcb, int y, fix xleft, fix
 // -------------------------------------------------------------------------------------
 //	Render a texture map with lighting using perspective interpolation in inner and outer loops.
 // -------------------------------------------------------------------------------------
-static void ntexture_map_lighted(const grs_bitmap &srcb, const g3ds_tmap &t)
+static void ntexture_map_lighted(const uint8_t *const texels, const g3ds_tmap &t)
 {
 	int	vlt,vrt,vlb,vrb;	// vertex left top, vertex right top, vertex left bottom, vertex right bottom
 	int	topy,boty,dy;
@@ -442,6 +447,8 @@ static void ntexture_map_lighted(const grs_bitmap &srcb, const g3ds_tmap &t)
 	next_break_right = f2i(v3d[vrb].y2d);
 
 	for (int y = topy; y < boty; y++) {
+		if (y > Band_bot)
+			return;
 
 		// See if we have reached the end of the current left edge, and if so, set
 		// new values for dx_dy and x,u,v
@@ -511,13 +518,13 @@ static void ntexture_map_lighted(const grs_bitmap &srcb, const g3ds_tmap &t)
 		}
 
 		if (Lighting_enabled) {
-			if (y >= Window_clip_top)
-				ntmap_scanline_lighted(srcb,y,xleft,xright,uleft,uright,vleft,vright,zleft,zright,lleft,lright);
+			if (y >= Window_clip_top && y >= Band_top)
+				ntmap_scanline_lighted(texels,y,xleft,xright,uleft,uright,vleft,vright,zleft,zright,lleft,lright);
 			lleft += dl_dy_left;
 			lright += dl_dy_right;
 		} else
-			if (y >= Window_clip_top)
-				ntmap_scanline_lighted(srcb,y,xleft,xright,uleft,uright,vleft,vright,zleft,zright,lleft,lright);
+			if (y >= Window_clip_top && y >= Band_top)
+				ntmap_scanline_lighted(texels,y,xleft,xright,uleft,uright,vleft,vright,zleft,zright,lleft,lright);
 
 		uleft += du_dy_left;
 		vleft += dv_dy_left;
@@ -536,14 +543,15 @@ static void ntexture_map_lighted(const grs_bitmap &srcb, const g3ds_tmap &t)
 	// We can get lleft or lright out of bounds here because we compute dl_dy using fixed point values,
 	//	but we plot an integer number of scanlines, therefore doing an integer number of additions of the delta.
 
-	ntmap_scanline_lighted(srcb,boty,xleft,xright,uleft,uright,vleft,vright,zleft,zright,lleft,lright);
+	if (boty >= Band_top && boty <= Band_bot)
+		ntmap_scanline_lighted(texels,boty,xleft,xright,uleft,uright,vleft,vright,zleft,zright,lleft,lright);
 }
 
 
 // -------------------------------------------------------------------------------------
 //	Texture map current scanline using linear interpolation.
 // -------------------------------------------------------------------------------------
-static void ntmap_scanline_lighted_linear(const grs_bitmap &srcb, int y, fix xleft, fix xright, fix uleft, fix uright, fix vleft, fix vright, fix lleft, fix lright)
+static void ntmap_scanline_lighted_linear(const uint8_t *const texels, int y, fix xleft, fix xright, fix uleft, fix uright, fix vleft, fix vright, fix lleft, fix lright)
 {
 	fix	dx,recip_dx,du_dx,dv_dx,dl_dx;
 
@@ -564,7 +572,7 @@ static void ntmap_scanline_lighted_linear(const grs_bitmap &srcb, int y, fix xle
 		fx_y = y;
 		fx_xright = f2i(xright);
 		fx_xleft = f2i(xleft);
-		pixptr = srcb.bm_data;
+		pixptr = texels;
 
 		switch (Lighting_enabled) {
 			case 0:
@@ -626,7 +634,7 @@ static void ntmap_scanline_lighted_linear(const grs_bitmap &srcb, int y, fix xle
 // -------------------------------------------------------------------------------------
 //	Render a texture map with lighting using perspective interpolation in inner and outer loops.
 // -------------------------------------------------------------------------------------
-static void ntexture_map_lighted_linear(const grs_bitmap &srcb, const g3ds_tmap &t)
+static void ntexture_map_lighted_linear(const uint8_t *const texels, const g3ds_tmap &t)
 {
 	int	vlt,vrt,vlb,vrb;	// vertex left top, vertex right top, vertex left bottom, vertex right bottom
 	int	topy,boty,dy;
@@ -697,6 +705,8 @@ static void ntexture_map_lighted_linear(const grs_bitmap &srcb, const g3ds_tmap
 	next_break_right = f2i(v3d[vrb].y2d);
 
 	for (int y = topy; y < boty; y++) {
+		if (y > Band_bot)
+			return;
 
 		// See if we have reached the end of the current left edge, and if so, set
 		// new values for dx_dy and x,u,v
@@ -761,11 +771,13 @@ static void ntexture_map_lighted_linear(const grs_bitmap &srcb, const g3ds_tmap
 		}
 
 		if (Lighting_enabled) {
-			ntmap_scanline_lighted_linear(srcb,y,xleft,xright,uleft,uright,vleft,vright,lleft,lright);
+			if (y >= Band_top)
+				ntmap_scanline_lighted_linear(texels,y,xleft,xright,uleft,uright,vleft,vright,lleft,lright);
 			lleft += dl_dy_left;
 			lright += dl_dy_right;
 		} else
-			ntmap_scanline_lighted_linear(srcb,y,xleft,xright,uleft,uright,vleft,vright,lleft,lright);
+			if (y >= Band_top)
+				ntmap_scanline_lighted_linear(texels,y,xleft,xright,uleft,uright,vleft,vright,lleft,lright);
 
 		uleft += du_dy_left;
 		vleft += dv_dy_left;
@@ -781,7 +793,26 @@ static void ntexture_map_lighted_linear(const grs_bitmap &srcb, const g3ds_tmap
 	// We can get lleft or lright out of bounds here because we compute dl_dy using fixed point values,
 	//	but we plot an integer number of scanlines, therefore doing an integer number of additions of the delta.
 
-	ntmap_scanline_lighted_linear(srcb,boty,xleft,xright,uleft,uright,vleft,vright,lleft,lright);
+	if (boty >= Band_top && boty <= Band_bot)
+		ntmap_scanline_lighted_linear(texels,boty,xleft,xright,uleft,uright,vleft,vright,lleft,lright);
+}
+
+// -------------------------------------------------------------------------------------
+//	Draw a texture map whose vertices have been converted by draw_tmap, limited to the rows
+//	[band_top, band_bot].
+// -------------------------------------------------------------------------------------
+void ntmap_rasterize(const uint8_t *const texels, const g3ds_tmap &t, const int lighting, const uint8_t transparency, const bool linear, const int band_top, const int band_bot)
+{
+	Lighting_enabled = lighting;
+	Transparency_on = transparency;
+	Band_top = band_top;
+	Band_bot = band_bot;
+	if (linear)
+		ntexture_map_lighted_linear(texels, t);
+	else
+		ntexture_map_lighted(texels, t);
+	Band_top = INT_MIN;
+	Band_bot = INT_MAX;
 }
 
 // fix	DivNum = F1_0*12;
@@ -793,7 +824,6 @@ void draw_tmap(grs_canvas &canvas, const grs_bitmap &rbp, uint_fast32_t nverts,
 {
 	//	These variables are used in system which renders texture maps which lie on one scanline as a line.
 	// fix	div_numerator;
-	int	lighting_on_save = Lighting_on;
 
 	Assert(nverts <= MAX_TMAP_VERTS);
 
@@ -804,12 +834,27 @@ void draw_tmap(grs_canvas &canvas, const grs_bitmap &rbp, uint_fast32_t nverts,
 		return;
 	}
 
-	bp = rle_expand_texture(*bp);		// Expand if rle'd
+	bool linear;
+	switch (Interpolation_method) {	// 0 = choose, 1 = linear, 2 = /8 perspective, 3 = full perspective
+		case 0:								// choose best interpolation
+			linear = (Current_seg_depth > Max_perspective_depth);
+			break;
+		case 1:								// linear interpolation
+			linear = true;
+			break;
+		case 2:								// perspective every 8th pixel interpolation
+		case 3:								// perspective every pixel interpolation
+			linear = false;
+			break;
+		default:
+			Assert(0);				// Illegal value for Interpolation_method, must be 0,1,2,3
+			return;
+	}
 
-	Transparency_on = bp->get_flag_mask(BM_FLAG_TRANSPARENT);
-	if (bp->get_flag_mask(BM_FLAG_NO_LIGHTING))
-		Lighting_on = 0;
+	bp = rle_expand_texture(*bp);		// Expand if rle'd
 
+	const uint8_t transparency = bp->get_flag_mask(BM_FLAG_TRANSPARENT);
+	const int lighting = bp->get_flag_mask(BM_FLAG_NO_LIGHTING) ? 0 : Lighting_on;
 
 	// Setup texture map in Tmap1
 	g3ds_tmap Tmap1;
@@ -830,37 +875,17 @@ void draw_tmap(grs_canvas &canvas, const grs_bitmap &rbp, uint_fast32_t nverts,
 		tvp->u = vp->p3_u << 6; //* bp->bm_w;
 		tvp->v = vp->p3_v << 6; //* bp->bm_h;
 
-		Assert(Lighting_on < 3);
+		Assert(lighting < 3);
 
-		if (Lighting_on)
+		if (lighting)
 			tvp->l = vp->p3_l * NUM_LIGHTING_LEVELS;
 	}
 
-
-	Lighting_enabled = Lighting_on;
-
 	// Now, call my texture mapper.
-		switch (Interpolation_method) {	// 0 = choose, 1 = linear, 2 = /8 perspective, 3 = full perspective
-			case 0:								// choose best interpolation
-				if (Current_seg_depth > Max_perspective_depth)
-				{
-				case 1:								// linear interpolation
-					ntexture_map_lighted_linear(*bp, Tmap1);
-				}
-				else
-				{
-					DXX_BOOST_FALLTHROUGH;
-				case 2:								// perspective every 8th pixel interpolation
-				case 3:								// perspective every pixel interpolation
-					ntexture_map_lighted(*bp, Tmap1);
-				}
-				break;
-			default:
-				Assert(0);				// Illegal value for Interpolation_method, must be 0,1,2,3
-		}
-
-	Lighting_on = lighting_on_save;
-
+	if (tmap_batch_recording)
+		tmap_batch_record(*bp, Tmap1, lighting, transparency, linear);
+	else
+		ntmap_rasterize(bp->bm_data, Tmap1, lighting, transparency, linear, INT_MIN, INT_MAX);
 }
 
 }
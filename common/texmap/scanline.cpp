@@ -23,6 +23,7 @@ COPYRIGHT 1993-1998 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
  *
  */
 
+#include <algorithm>
 #include <math.h>
 #include <limits.h>
 #include <stdio.h>
@@ -35,6 +36,7 @@ COPYRIGHT 1993-1998 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "texmap.h"
 #include "texmapl.h"
 #include "scanline.h"
+#include "tmap_span.h"
 #include "strutil.h"
 #include "dxxerror.h"
 
@@ -659,11 +661,56 @@ static void c_tmap_scanline_quad()
 	}
 }
 
+// These texture mappers hand the scanline to the span kernels in tmap_span.cpp, which draw
+// 8 pixels per step where the CPU has AVX2.  The perspective mapper divides by z every
+// tmap_span_subdivision pixels, and interpolates linearly in between.
+static void simd_tmap_span_setup(tmap_span &span)
+{
+	const int index = fx_xleft + (bytes_per_row * fx_y);
+	const int count = std::min(fx_xright - fx_xleft + 1, static_cast<int>(SWIDTH * SHEIGHT) - 1 - index);
+	span.texels = pixptr;
+	span.fade_table = &gr_fade_table[0][0];
+	span.dest = &write_buffer[index];
+	span.count = count > 0 ? count : 0;
+	span.fade_levels = GR_FADE_LEVELS;
+	span.transparent = Transparency_on;
+	span.u = fx_u;
+	span.v = fx_v;
+	span.l = fx_l >> 8;
+	span.du = fx_du_dx;
+	span.dv = fx_dv_dx;
+	span.dl = fx_dl_dx / 256;
+}
+
+static void simd_tmap_scanline_lin()
+{
+	tmap_span span;
+	simd_tmap_span_setup(span);
+	if (span.count)
+		tmap_span_linear(span);
+}
+
+static void simd_tmap_scanline_per()
+{
+	tmap_span_perspective span;
+	simd_tmap_span_setup(span);
+	span.z = fx_z;
+	span.dz = fx_dz_dx;
+	if (span.count)
+		tmap_span_perspective_draw(span);
+}
+
 //runtime selection of optimized tmappers.  12/07/99  Matthew Mueller
 //the reason I did it this way rather than having a *tmap_funcs that then points to a c_tmap or fp_tmap struct thats already filled in, is to avoid a second pointer dereference.
 void select_tmap(const std::string &type)
 {
-	if (type == "fp")
+	cur_tmap_scanline_lin=c_tmap_scanline_lin;
+	if (type == "simd")
+	{
+		cur_tmap_scanline_per=simd_tmap_scanline_per;
+		cur_tmap_scanline_lin=simd_tmap_scanline_lin;
+	}
+	else if (type == "fp")
 	{
 		cur_tmap_scanline_per=c_fp_tmap_scanline_per;
 	}
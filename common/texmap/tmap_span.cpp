@@ -0,0 +1,278 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+/*
+ *
+ * Pixel loops that draw one lighted span of a 64x64 texture map.
+ *
+ * Every kernel draws the same pixels.  The perspective kernel divides
+ * by z only at the ends of each subdivision, and then draws the pixels
+ * in between with the linear kernel, so it is exact for each ISA in the
+ * same way.
+ *
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include "tmap_span.h"
+#include "fwd-gr.h"
+
+/* AVX2 is not part of any baseline x86 target, so it is compiled with a
+ * function-specific target and selected only if the CPU reports it.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DXX_TMAP_SPAN_AVX2	1
+#include <immintrin.h>
+#else
+#define DXX_TMAP_SPAN_AVX2	0
+#endif
+
+namespace dcx {
+
+namespace {
+
+constexpr uint8_t tmap_span_transparent = static_cast<uint8_t>(TRANSPARENCY_COLOR);
+
+/* The fade row is masked the same way as c_tmap_scanline_lin, and then
+ * limited to the table, so that an overflowed light value cannot read
+ * past the end of the table.
+ */
+static inline unsigned get_fade_row(const uint32_t l, const unsigned max_row)
+{
+	return std::min((l >> 8) & 0x7f, max_row);
+}
+
+/* The coordinates are stepped in unsigned arithmetic, so that a
+ * coordinate which wraps has defined behavior, and matches the vector
+ * kernels.  Only bits 16-21 of u and v are used.
+ */
+static void span_linear_scalar(const tmap_span &span)
+{
+	uint32_t u = span.u, v = span.v, l = span.l;
+	const uint32_t du = span.du, dv = span.dv, dl = span.dl;
+	const unsigned max_row = span.fade_levels - 1;
+	auto dest = span.dest;
+	for (unsigned i = span.count; i--; ++dest, u += du, v += dv, l += dl)
+	{
+		const uint8_t c = span.texels[(((v >> 16) & 63) << 6) | ((u >> 16) & 63)];
+		if (span.transparent && c == tmap_span_transparent)
+			continue;
+		*dest = span.fade_table[(get_fade_row(l, max_row) << 8) | c];
+	}
+}
+
+/* Advance `span` past its first `n` pixels. */
+static tmap_span skip_pixels(const tmap_span &span, const unsigned n)
+{
+	tmap_span r = span;
+	r.dest += n;
+	r.count -= n;
+	r.u = static_cast<uint32_t>(span.u) + n * static_cast<uint32_t>(span.du);
+	r.v = static_cast<uint32_t>(span.v) + n * static_cast<uint32_t>(span.dv);
+	r.l = static_cast<uint32_t>(span.l) + n * static_cast<uint32_t>(span.dl);
+	return r;
+}
+
+static int32_t perspective_divide(const int64_t a, int64_t z)
+{
+	/* Faces that reach this far are in front of the eye, so z is
+	 * positive except for rounding at the edge of the view.
+	 */
+	if (z < 1)
+		z = 1;
+	return static_cast<int32_t>(a * 65536 / z);
+}
+
+template <typename F>
+static void span_perspective(const tmap_span_perspective &span, F draw_linear)
+{
+	tmap_span chunk = span;
+	int64_t u = span.u, v = span.v, z = span.z;
+	int32_t u0 = perspective_divide(u, z), v0 = perspective_divide(v, z);
+	for (unsigned remaining = span.count; remaining;)
+	{
+		const unsigned n = std::min(remaining, tmap_span_subdivision);
+		u += int64_t{span.du} * n;
+		v += int64_t{span.dv} * n;
+		z += int64_t{span.dz} * n;
+		const int32_t u1 = perspective_divide(u, z), v1 = perspective_divide(v, z);
+		chunk.count = n;
+		chunk.u = u0;
+		chunk.v = v0;
+		chunk.du = static_cast<int32_t>((int64_t{u1} - u0) / n);
+		chunk.dv = static_cast<int32_t>((int64_t{v1} - v0) / n);
+		draw_linear(chunk);
+		chunk.dest += n;
+		chunk.l = static_cast<uint32_t>(chunk.l) + n * static_cast<uint32_t>(span.dl);
+		u0 = u1;
+		v0 = v1;
+		remaining -= n;
+	}
+}
+
+#if DXX_TMAP_SPAN_AVX2
+/* Load one byte per lane from `base` + `index`.  Gathers load 32 bits,
+ * so the load is done from the aligned word that holds the byte, and
+ * never reads from a page that does not also hold part of the table.
+ */
+__attribute__((target("avx2")))
+static inline __m256i gather_bytes_avx2(const int *const aligned, const __m256i misalignment, const __m256i index)
+{
+	const auto offset = _mm256_add_epi32(index, misalignment);
+	const auto words = _mm256_i32gather_epi32(aligned, _mm256_srli_epi32(offset, 2), 4);
+	const auto shift = _mm256_slli_epi32(_mm256_and_si256(offset, _mm256_set1_epi32(3)), 3);
+	return _mm256_and_si256(_mm256_srlv_epi32(words, shift), _mm256_set1_epi32(0xff));
+}
+
+/* Pack the low byte of each lane into 8 consecutive bytes. */
+__attribute__((target("avx2")))
+static inline __m128i pack_bytes_avx2(const __m256i v)
+{
+	const auto shuffle = _mm256_setr_epi8(
+		0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const auto b = _mm256_shuffle_epi8(v, shuffle);
+	return _mm_unpacklo_epi32(_mm256_castsi256_si128(b), _mm256_extracti128_si256(b, 1));
+}
+
+static const int *get_aligned_base(const uint8_t *const p, int &misalignment)
+{
+	const auto address = reinterpret_cast<uintptr_t>(p);
+	misalignment = address & 3;
+	return reinterpret_cast<const int *>(address - misalignment);
+}
+
+__attribute__((target("avx2")))
+static void span_linear_avx2(const tmap_span &span)
+{
+	int texel_misalignment, fade_misalignment;
+	const auto texels = get_aligned_base(span.texels, texel_misalignment);
+	const auto fade_table = get_aligned_base(span.fade_table, fade_misalignment);
+	const auto vtexel_misalignment = _mm256_set1_epi32(texel_misalignment);
+	const auto vfade_misalignment = _mm256_set1_epi32(fade_misalignment);
+	const auto lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	auto u = _mm256_add_epi32(_mm256_set1_epi32(span.u), _mm256_mullo_epi32(lane, _mm256_set1_epi32(span.du)));
+	auto v = _mm256_add_epi32(_mm256_set1_epi32(span.v), _mm256_mullo_epi32(lane, _mm256_set1_epi32(span.dv)));
+	auto l = _mm256_add_epi32(_mm256_set1_epi32(span.l), _mm256_mullo_epi32(lane, _mm256_set1_epi32(span.dl)));
+	const auto step_u = _mm256_set1_epi32(static_cast<uint32_t>(span.du) * 8u);
+	const auto step_v = _mm256_set1_epi32(static_cast<uint32_t>(span.dv) * 8u);
+	const auto step_l = _mm256_set1_epi32(static_cast<uint32_t>(span.dl) * 8u);
+	const auto mask63 = _mm256_set1_epi32(63);
+	const auto mask7f = _mm256_set1_epi32(0x7f);
+	const auto max_row = _mm256_set1_epi32(span.fade_levels - 1);
+	const auto vtransparent = _mm256_set1_epi32(tmap_span_transparent);
+	const auto dest = span.dest;
+	unsigned i = 0;
+	for (; i + 8 <= span.count; i += 8)
+	{
+		const auto column = _mm256_and_si256(_mm256_srli_epi32(u, 16), mask63);
+		const auto row = _mm256_and_si256(_mm256_srli_epi32(v, 16), mask63);
+		const auto texel = gather_bytes_avx2(texels, vtexel_misalignment, _mm256_or_si256(_mm256_slli_epi32(row, 6), column));
+		const auto fade_row = _mm256_min_epu32(_mm256_and_si256(_mm256_srli_epi32(l, 8), mask7f), max_row);
+		const auto color = gather_bytes_avx2(fade_table, vfade_misalignment, _mm256_or_si256(_mm256_slli_epi32(fade_row, 8), texel));
+		auto out = pack_bytes_avx2(color);
+		const auto p = reinterpret_cast<__m128i *>(&dest[i]);
+		if (span.transparent)
+			out = _mm_blendv_epi8(out, _mm_loadl_epi64(p), pack_bytes_avx2(_mm256_cmpeq_epi32(texel, vtransparent)));
+		_mm_storel_epi64(p, out);
+		u = _mm256_add_epi32(u, step_u);
+		v = _mm256_add_epi32(v, step_v);
+		l = _mm256_add_epi32(l, step_l);
+	}
+	if (i < span.count)
+		span_linear_scalar(skip_pixels(span, i));
+}
+#endif
+
+static bool tmap_span_isa_supported(const tmap_span_isa isa)
+{
+	switch (isa)
+	{
+		case tmap_span_isa::scalar:
+			return true;
+		case tmap_span_isa::avx2:
+#if DXX_TMAP_SPAN_AVX2
+			return __builtin_cpu_supports("avx2");
+#else
+			return false;
+#endif
+		default:
+			return false;
+	}
+}
+
+static tmap_span_isa tmap_span_detect_isa()
+{
+	return tmap_span_isa_supported(tmap_span_isa::avx2) ? tmap_span_isa::avx2 : tmap_span_isa::scalar;
+}
+
+using span_linear_function = void(const tmap_span &);
+
+static span_linear_function *get_span_linear(const tmap_span_isa isa)
+{
+	switch (isa)
+	{
+		case tmap_span_isa::scalar:
+		default:
+			return span_linear_scalar;
+#if DXX_TMAP_SPAN_AVX2
+		case tmap_span_isa::avx2:
+			return span_linear_avx2;
+#endif
+	}
+}
+
+}
+
+tmap_span_isa tmap_span_best_isa()
+{
+	static const tmap_span_isa best = tmap_span_detect_isa();
+	return best;
+}
+
+const char *tmap_span_isa_name(const tmap_span_isa isa)
+{
+	switch (isa)
+	{
+		case tmap_span_isa::scalar:
+			return "scalar";
+		case tmap_span_isa::avx2:
+			return "AVX2";
+		default:
+			return "unknown";
+	}
+}
+
+bool tmap_span_linear(const tmap_span_isa isa, const tmap_span &span)
+{
+	if (!tmap_span_isa_supported(isa))
+		return false;
+	get_span_linear(isa)(span);
+	return true;
+}
+
+bool tmap_span_perspective_draw(const tmap_span_isa isa, const tmap_span_perspective &span)
+{
+	if (!tmap_span_isa_supported(isa))
+		return false;
+	span_perspective(span, get_span_linear(isa));
+	return true;
+}
+
+void tmap_span_linear(const tmap_span &span)
+{
+	static span_linear_function *const draw = get_span_linear(tmap_span_best_isa());
+	draw(span);
+}
+
+void tmap_span_perspective_draw(const tmap_span_perspective &span)
+{
+	static span_linear_function *const draw = get_span_linear(tmap_span_best_isa());
+	span_perspective(span, draw);
+}
+
+}
@@ -0,0 +1,285 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+/*
+ *
+ * Batched texture mapping for the software renderer.
+ *
+ * While a batch records, draw_tmap saves each converted texture map
+ * and a pointer to its texels.  At a flush, the canvas is cut into bands
+ * of rows, and each texture map is added to the list for every band it
+ * touches.  The threads claim bands one at a time, and draw the band's
+ * list in order, so overlapping faces are painted in the same order as
+ * when drawn immediately.
+ *
+ * The texture is usually owned by the RLE or texture merge cache, and
+ * may be replaced by a later draw_tmap call in the same batch.  The
+ * caches pass a replaced texture to tmap_batch_retire, which keeps it
+ * until the batch is drawn, so faces share their texture without
+ * copying it.
+ *
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "gr.h"
+#include "texmap.h"
+#include "texmapl.h"
+
+#include "compiler-range_for.h"
+
+#if !DXX_USE_OGL
+namespace dcx {
+
+bool tmap_batch_recording;
+
+namespace {
+
+struct tmap_batch_job
+{
+	g3ds_tmap tmap;
+	const uint8_t *texels;
+	unsigned char *write_buffer;
+	int bytes_per_row;
+	int clip_left, clip_top, clip_right, clip_bot;
+	int lighting;
+	uint8_t transparency;
+	bool linear;
+};
+
+class tmap_batch_pool
+{
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable start_work, finished_work;
+	unsigned generation = 0;
+	unsigned busy_threads = 0;
+	bool stopping = false;
+	std::atomic<unsigned> next_band;
+	void run_bands();
+	void run_thread();
+public:
+	std::vector<tmap_batch_job> jobs;
+	std::vector<grs_bitmap_ptr> retired;
+	std::vector<std::vector<unsigned>> bands;
+	unsigned band_height = 0;
+	unsigned thread_count() const
+	{
+		return threads.size() + 1;
+	}
+	void start(unsigned helpers);
+	void stop();
+	void draw();
+};
+
+static tmap_batch_pool tmap_batch;
+
+static void draw_job_band(const tmap_batch_job &job, const uint8_t *const texels, const int band_top, const int band_bot)
+{
+	write_buffer = job.write_buffer;
+	bytes_per_row = job.bytes_per_row;
+	Window_clip_left = job.clip_left;
+	Window_clip_top = job.clip_top;
+	Window_clip_right = job.clip_right;
+	Window_clip_bot = job.clip_bot;
+	ntmap_rasterize(texels, job.tmap, job.lighting, job.transparency, job.linear, band_top, band_bot);
+}
+
+void tmap_batch_pool::run_bands()
+{
+	const auto band_count = bands.size();
+	for (unsigned b; (b = next_band.fetch_add(1, std::memory_order_relaxed)) < band_count;)
+	{
+		const int band_top = b * band_height;
+		const int band_bot = band_top + band_height - 1;
+		range_for (const auto j, bands[b])
+		{
+			auto &job = jobs[j];
+			draw_job_band(job, job.texels, band_top, band_bot);
+		}
+	}
+}
+
+void tmap_batch_pool::run_thread()
+{
+	unsigned seen = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			start_work.wait(lock, [this, seen]{ return stopping || generation != seen; });
+			if (stopping)
+				return;
+			seen = generation;
+		}
+		run_bands();
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!--busy_threads)
+			finished_work.notify_one();
+	}
+}
+
+void tmap_batch_pool::start(const unsigned helpers)
+{
+	threads.reserve(helpers);
+	for (unsigned i = helpers; i--;)
+		threads.emplace_back(&tmap_batch_pool::run_thread, this);
+}
+
+void tmap_batch_pool::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	start_work.notify_all();
+	range_for (auto &t, threads)
+		t.join();
+	threads.clear();
+	stopping = false;
+}
+
+/* Bin every job into the bands it touches, then draw the bands on all
+ * threads.  The calling thread draws bands too, and returns only after
+ * every band is done.
+ */
+void tmap_batch_pool::draw()
+{
+	int canvas_bot = 0;
+	range_for (auto &job, jobs)
+		canvas_bot = std::max(canvas_bot, job.clip_bot);
+	/* Several bands per thread, so that a thread that draws a busy band
+	 * does not leave the others idle for long.
+	 */
+	band_height = std::max(8u, static_cast<unsigned>(canvas_bot + 1) / (thread_count() * 4) + 1);
+	const unsigned band_count = canvas_bot / band_height + 1;
+	if (bands.size() < band_count)
+		bands.resize(band_count);
+	range_for (auto &b, bands)
+		b.clear();
+	range_for (auto &&j, jobs)
+	{
+		fix min_y = j.tmap.verts[0].y2d, max_y = min_y;
+		for (int i = 1; i < j.tmap.nv; ++i)
+		{
+			min_y = std::min(min_y, j.tmap.verts[i].y2d);
+			max_y = std::max(max_y, j.tmap.verts[i].y2d);
+		}
+		/* One row of margin, since the mappers round the bottom edge
+		 * up.
+		 */
+		const int top = std::max(f2i(min_y), 0);
+		const int bot = std::min(f2i(max_y) + 1, j.clip_bot);
+		if (top > bot)
+			continue;
+		const unsigned index = &j - jobs.data();
+		for (unsigned b = top / band_height, e = bot / band_height; b <= e; ++b)
+			bands[b].emplace_back(index);
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		next_band.store(0, std::memory_order_relaxed);
+		busy_threads = threads.size();
+		++generation;
+	}
+	start_work.notify_all();
+	run_bands();
+	std::unique_lock<std::mutex> lock(mutex);
+	finished_work.wait(lock, [this]{ return !busy_threads; });
+}
+
+}
+
+void tmap_batch_record(const grs_bitmap &texture, const g3ds_tmap &t, const int lighting, const uint8_t transparency, const bool linear)
+{
+	tmap_batch.jobs.emplace_back();
+	auto &job = tmap_batch.jobs.back();
+	job.tmap.nv = t.nv;
+	std::copy_n(t.verts.begin(), t.nv, job.tmap.verts.begin());
+	job.texels = texture.bm_data;
+	job.write_buffer = write_buffer;
+	job.bytes_per_row = bytes_per_row;
+	job.clip_left = Window_clip_left;
+	job.clip_top = Window_clip_top;
+	job.clip_right = Window_clip_right;
+	job.clip_bot = Window_clip_bot;
+	job.lighting = lighting;
+	job.transparency = transparency;
+	job.linear = linear;
+}
+
+void tmap_batch_flush()
+{
+	if (tmap_batch.jobs.empty())
+		return;
+	/* The drawing threads overwrite the calling thread's interface
+	 * variables, since it draws bands too.  Restore them for whatever
+	 * is drawn after the flush.
+	 */
+	const auto save_write_buffer = write_buffer;
+	const auto save_bytes_per_row = bytes_per_row;
+	const auto save_clip_left = Window_clip_left;
+	const auto save_clip_top = Window_clip_top;
+	const auto save_clip_right = Window_clip_right;
+	const auto save_clip_bot = Window_clip_bot;
+	tmap_batch.draw();
+	tmap_batch.jobs.clear();
+	tmap_batch.retired.clear();
+	write_buffer = save_write_buffer;
+	bytes_per_row = save_bytes_per_row;
+	Window_clip_left = save_clip_left;
+	Window_clip_top = save_clip_top;
+	Window_clip_right = save_clip_right;
+	Window_clip_bot = save_clip_bot;
+}
+
+void tmap_batch_retire(grs_bitmap_ptr &&texture)
+{
+	if (!texture)
+		return;
+	if (tmap_batch.jobs.empty())
+		texture.reset();
+	else
+		tmap_batch.retired.emplace_back(std::move(texture));
+}
+
+void tmap_batch_init(unsigned threads)
+{
+	/* More threads than CPUs only take turns. */
+	const unsigned cpus = std::max(std::thread::hardware_concurrency(), 1u);
+	if (!threads || threads > cpus)
+		threads = cpus;
+	if (threads > 1)
+		tmap_batch.start(threads - 1);
+}
+
+void tmap_batch_close()
+{
+	tmap_batch.stop();
+}
+
+tmap_batch_scope::tmap_batch_scope(const bool enable) :
+	previous(tmap_batch_recording)
+{
+	if (enable && tmap_batch.thread_count() > 1)
+		tmap_batch_recording = true;
+}
+
+tmap_batch_scope::~tmap_batch_scope()
+{
+	tmap_batch_flush();
+	tmap_batch_recording = previous;
+}
+
+}
+#endif
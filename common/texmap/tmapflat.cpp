@@ -222,6 +222,10 @@ void draw_tmap_flat(grs_canvas &canvas, const grs_bitmap &bp, uint_fast32_t nver
 //function with ylr values
 static void gr_upoly_tmap_ylr(grs_canvas &canvas, uint_fast32_t nverts, const int *vert, const uint8_t color)
 {
+	/* Pending texture maps must be drawn first, or this polygon would
+	 * be painted under them.
+	 */
+	tmap_batch_flush();
 	g3ds_tmap	my_tmap;
 	my_tmap.nv = nverts;
 
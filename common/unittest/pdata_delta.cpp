@@ -0,0 +1,62 @@
+#include "pdata_delta.h"
+#include <array>
+#include <climits>
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Rebirth pdata_delta
+#include <boost/test/unit_test.hpp>
+
+namespace {
+
+static dcx::pdata_snapshot roundtrip(const dcx::pdata_snapshot &baseline, const dcx::pdata_snapshot &snapshot, std::size_t &size)
+{
+	std::array<uint8_t, dcx::pdata_delta_max_size> buf;
+	size = dcx::pdata_delta_encode(baseline, snapshot, buf.data());
+	dcx::pdata_snapshot result{};
+	BOOST_TEST(dcx::pdata_delta_decode(baseline, buf.data(), size, result));
+	return result;
+}
+
+}
+
+/* Test that an unchanged snapshot costs only the width classes.
+ */
+BOOST_AUTO_TEST_CASE(pdata_delta_unchanged)
+{
+	dcx::pdata_snapshot s;
+	for (std::size_t i = 0; i < s.size(); ++i)
+		s[i] = static_cast<int32_t>(i * 123457);
+	std::size_t size;
+	BOOST_TEST(roundtrip(s, s, size) == s);
+	BOOST_TEST(size == (dcx::pdata_delta_fields * 2 + 7) / 8);
+}
+
+/* Test differences at the edges of each width class, and the extremes
+ * of int32_t in both directions.
+ */
+BOOST_AUTO_TEST_CASE(pdata_delta_width_classes)
+{
+	const dcx::pdata_snapshot baseline{{0, 1, -1, 100, INT32_MAX, INT32_MIN, 0, 0, 0, 0, 0, 0, 0, 0}};
+	const dcx::pdata_snapshot snapshot{{127, -128, 32767, -32668, INT32_MIN, INT32_MAX, 128, -129, 32768, -32769, 1, -1, 0, 5}};
+	std::size_t size;
+	BOOST_TEST(roundtrip(baseline, snapshot, size) == snapshot);
+	BOOST_TEST(size <= dcx::pdata_delta_max_size);
+	const dcx::pdata_snapshot keyframe{};
+	BOOST_TEST(roundtrip(keyframe, snapshot, size) == snapshot);
+}
+
+/* Test that a truncated packet is rejected instead of read past its end.
+ */
+BOOST_AUTO_TEST_CASE(pdata_delta_truncated)
+{
+	const dcx::pdata_snapshot baseline{};
+	dcx::pdata_snapshot snapshot;
+	snapshot.fill(0x12345678);
+	std::array<uint8_t, dcx::pdata_delta_max_size> buf;
+	const auto size = dcx::pdata_delta_encode(baseline, snapshot, buf.data());
+	BOOST_TEST(size == dcx::pdata_delta_max_size);
+	dcx::pdata_snapshot result;
+	BOOST_TEST(!dcx::pdata_delta_decode(baseline, buf.data(), size - 1, result));
+	BOOST_TEST(dcx::pdata_delta_decode(baseline, buf.data(), size, result));
+	BOOST_TEST(result == snapshot);
+}
@@ -0,0 +1,90 @@
+#include "texmerge_kernel.h"
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Rebirth texmerge_kernel
+#include <boost/test/unit_test.hpp>
+
+namespace {
+
+constexpr std::array<dcx::texmerge_transform, 2> transforms{{
+	dcx::texmerge_transform::none,
+	dcx::texmerge_transform::super_transparent,
+}};
+
+/* Fill `v` with a repeatable pattern in which both transparent colors
+ * are common, so that every kernel sees long runs of each case.
+ */
+static void fill_texture(std::vector<uint8_t> &v, uint32_t seed)
+{
+	for (auto &c : v)
+	{
+		seed = seed * 1103515245u + 12345u;
+		const uint8_t r = seed >> 16;
+		c = (r & 3) == 0 ? 255 : (r & 3) == 1 ? 254 : r;
+	}
+}
+
+}
+
+/* Test the scalar kernel on a texture small enough to check by hand.
+ */
+BOOST_AUTO_TEST_CASE(texmerge_scalar_2x2)
+{
+	const std::array<uint8_t, 4> top{{255, 254, 7, 255}};
+	const std::array<uint8_t, 4> bottom{{1, 2, 3, 4}};
+	std::array<uint8_t, 4> dest{};
+	BOOST_TEST(dcx::texmerge_merge(dcx::texmerge_isa::scalar, 2, 0, dcx::texmerge_transform::none, top.data(), bottom.data(), dest.data()));
+	const std::array<uint8_t, 4> expected_none{{1, 254, 7, 4}};
+	BOOST_TEST(dest == expected_none);
+	BOOST_TEST(dcx::texmerge_merge(dcx::texmerge_isa::scalar, 2, 0, dcx::texmerge_transform::super_transparent, top.data(), bottom.data(), dest.data()));
+	const std::array<uint8_t, 4> expected_super{{1, 255, 7, 4}};
+	BOOST_TEST(dest == expected_super);
+	/* A quarter turn moves the top texel at (x=1, y=0) to (x=0, y=0).
+	 */
+	BOOST_TEST(dcx::texmerge_merge(dcx::texmerge_isa::scalar, 2, 1, dcx::texmerge_transform::none, top.data(), bottom.data(), dest.data()));
+	const std::array<uint8_t, 4> expected_rotated{{254, 2, 3, 7}};
+	BOOST_TEST(dest == expected_rotated);
+}
+
+/* Test that every kernel that runs on this CPU matches the scalar
+ * kernel for each rotation and transform.  The sizes include widths
+ * that are not a multiple of any vector width.
+ */
+BOOST_AUTO_TEST_CASE(texmerge_vector_matches_scalar)
+{
+	for (const unsigned wh : {1u, 15u, 33u, 64u, 256u})
+	{
+		const std::size_t size = std::size_t{wh} * wh;
+		std::vector<uint8_t> top(size), bottom(size), expected(size), actual(size);
+		fill_texture(top, wh);
+		fill_texture(bottom, ~wh);
+		for (const auto transform : transforms)
+			for (unsigned rotation = 0; rotation < 4; ++rotation)
+			{
+				BOOST_TEST(dcx::texmerge_merge(dcx::texmerge_isa::scalar, wh, rotation, transform, top.data(), bottom.data(), expected.data()));
+				for (const auto isa : {dcx::texmerge_isa::sse2, dcx::texmerge_isa::avx2, dcx::texmerge_isa::neon})
+				{
+					BOOST_TEST_CONTEXT(dcx::texmerge_isa_name(isa) << " wh=" << wh << " rotation=" << rotation << " transform=" << static_cast<unsigned>(transform))
+					{
+						std::fill(actual.begin(), actual.end(), 0);
+						if (!dcx::texmerge_merge(isa, wh, rotation, transform, top.data(), bottom.data(), actual.data()))
+							continue;
+						BOOST_TEST(actual == expected);
+					}
+				}
+			}
+	}
+}
+
+/* Test that the default kernel is one that can run.
+ */
+BOOST_AUTO_TEST_CASE(texmerge_best_isa_runs)
+{
+	const std::array<uint8_t, 1> top{{9}}, bottom{{3}};
+	std::array<uint8_t, 1> dest{};
+	BOOST_TEST(dcx::texmerge_merge(dcx::texmerge_best_isa(), 1, 0, dcx::texmerge_transform::none, top.data(), bottom.data(), dest.data()));
+	BOOST_TEST(dest[0] == 9);
+}
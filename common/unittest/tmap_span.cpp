@@ -0,0 +1,154 @@
+#include "tmap_span.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <vector>
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Rebirth tmap_span
+#include <boost/test/unit_test.hpp>
+
+namespace {
+
+constexpr unsigned fade_levels = 34;
+constexpr unsigned canvas_width = 1920;
+
+/* A repeatable texture in which TRANSPARENCY_COLOR is common, and a fade
+ * table whose entries identify the row and texel that produced them.
+ */
+struct span_fixture
+{
+	std::array<uint8_t, 64 * 64> texels;
+	std::array<uint8_t, fade_levels * 256> fade_table;
+	span_fixture()
+	{
+		uint32_t seed = 1;
+		for (auto &c : texels)
+		{
+			seed = seed * 1103515245u + 12345u;
+			const uint8_t r = seed >> 16;
+			c = (r & 7) == 0 ? 255 : r;
+		}
+		for (unsigned i = 0; i < fade_table.size(); ++i)
+			fade_table[i] = static_cast<uint8_t>(i * 7 + (i >> 8));
+	}
+	dcx::tmap_span make_span(uint8_t *const dest, const unsigned count, const bool transparent) const
+	{
+		dcx::tmap_span span{};
+		span.texels = texels.data();
+		span.fade_table = fade_table.data();
+		span.dest = dest;
+		span.count = count;
+		span.fade_levels = fade_levels;
+		span.transparent = transparent;
+		return span;
+	}
+};
+
+/* Pick span parameters that cover negative coordinates, wrapping and
+ * light values beyond the end of the fade table.
+ */
+static void randomize_span(dcx::tmap_span &span, uint32_t &seed)
+{
+	const auto next = [&seed]() {
+		seed = seed * 1664525u + 1013904223u;
+		return static_cast<int32_t>(seed);
+	};
+	span.u = next() >> 6;
+	span.v = next() >> 6;
+	span.l = (next() & 0x3fff) + 0x100;
+	span.du = next() >> 12;
+	span.dv = next() >> 12;
+	span.dl = next() >> 20;
+}
+
+}
+
+/* Test the scalar kernel on a span small enough to check by hand.
+ */
+BOOST_FIXTURE_TEST_CASE(tmap_span_scalar_hand_checked, span_fixture)
+{
+	texels[0] = 10;
+	texels[1] = 255;
+	texels[64 + 2] = 20;
+	std::array<uint8_t, 3> dest{{1, 2, 3}};
+	auto span = make_span(dest.data(), dest.size(), true);
+	/* Texels (0, 0), (1, 0) and (2, 1), at fade rows 0, 1 and 2. */
+	span.du = 1 << 16;
+	span.dv = 1 << 15;
+	span.dl = 1 << 8;
+	BOOST_TEST(dcx::tmap_span_linear(dcx::tmap_span_isa::scalar, span));
+	BOOST_TEST(dest[0] == fade_table[10]);
+	BOOST_TEST(dest[1] == 2);
+	BOOST_TEST(dest[2] == fade_table[2 * 256 + 20]);
+}
+
+/* Test that every kernel that runs on this CPU matches the scalar
+ * kernel, including lengths that are not a multiple of the vector
+ * width or of the perspective subdivision.
+ */
+BOOST_FIXTURE_TEST_CASE(tmap_span_vector_matches_scalar, span_fixture)
+{
+	uint32_t seed = 1;
+	for (const unsigned count : {1u, 7u, 8u, 9u, 16u, 31u, 64u, 333u})
+		for (const bool transparent : {false, true})
+			for (unsigned trial = 0; trial < 16; ++trial)
+			{
+				std::vector<uint8_t> expected(count), actual(count);
+				std::fill(expected.begin(), expected.end(), 0x5a);
+				std::fill(actual.begin(), actual.end(), 0x5a);
+				auto span = make_span(nullptr, count, transparent);
+				randomize_span(span, seed);
+				dcx::tmap_span_perspective pspan;
+				static_cast<dcx::tmap_span &>(pspan) = span;
+				pspan.z = 0x10000 + (span.u & 0xfffff);
+				pspan.dz = span.dl;
+				const auto isa = dcx::tmap_span_isa::avx2;
+				BOOST_TEST_CONTEXT(dcx::tmap_span_isa_name(isa) << " count=" << count << " transparent=" << transparent << " trial=" << trial)
+				{
+					span.dest = expected.data();
+					BOOST_TEST(dcx::tmap_span_linear(dcx::tmap_span_isa::scalar, span));
+					span.dest = actual.data();
+					if (!dcx::tmap_span_linear(isa, span))
+						continue;
+					BOOST_TEST(actual == expected);
+					pspan.dest = expected.data();
+					BOOST_TEST(dcx::tmap_span_perspective_draw(dcx::tmap_span_isa::scalar, pspan));
+					pspan.dest = actual.data();
+					BOOST_TEST(dcx::tmap_span_perspective_draw(isa, pspan));
+					BOOST_TEST(actual == expected);
+				}
+			}
+}
+
+/* Time each kernel on synthetic full-width spans.  This is not run by
+ * default; run it with --run_test=tmap_span_benchmark.
+ */
+BOOST_FIXTURE_TEST_CASE(tmap_span_benchmark, span_fixture, *boost::unit_test::disabled())
+{
+	constexpr unsigned spans = 20000;
+	std::vector<uint8_t> dest(canvas_width);
+	for (const auto isa : {dcx::tmap_span_isa::scalar, dcx::tmap_span_isa::avx2})
+		for (const bool perspective : {false, true})
+		{
+			if (!dcx::tmap_span_linear(isa, make_span(dest.data(), 0, false)))
+				continue;
+			uint32_t seed = 1;
+			auto span = make_span(dest.data(), canvas_width, false);
+			dcx::tmap_span_perspective pspan;
+			const auto start = std::chrono::steady_clock::now();
+			for (unsigned i = 0; i < spans; ++i)
+			{
+				randomize_span(span, seed);
+				static_cast<dcx::tmap_span &>(pspan) = span;
+				pspan.z = 0x10000;
+				pspan.dz = 16;
+				if (perspective)
+					dcx::tmap_span_perspective_draw(isa, pspan);
+				else
+					dcx::tmap_span_linear(isa, span);
+			}
+			const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+			BOOST_TEST_MESSAGE(dcx::tmap_span_isa_name(isa) << (perspective ? " perspective: " : " linear: ") << elapsed.count() / (double{spans} * canvas_width) << " ns/pixel");
+		}
+}
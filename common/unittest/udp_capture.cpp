@@ -0,0 +1,109 @@
+#include "udp_capture.h"
+#include <algorithm>
+#include <vector>
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Rebirth udp_capture
+#include <boost/test/unit_test.hpp>
+
+namespace {
+
+static dcx::udp_capture_record make_record(const uint32_t time, const uint8_t tag)
+{
+	return dcx::udp_capture_record{time, {2, 0, tag}, {tag, static_cast<uint8_t>(tag + 1)}};
+}
+
+/* Push `count` datagrams 10ms apart through a link with `model`, and
+ * return the tags of the datagrams it delivers, in delivery order.
+ */
+static std::vector<uint8_t> run_link(const dcx::udp_link_model &model, const unsigned count)
+{
+	dcx::udp_link_queue link(model);
+	for (unsigned i = 0; i < count; ++i)
+		link.push(make_record(i * 10, i));
+	std::vector<uint8_t> delivered;
+	dcx::udp_capture_record r;
+	while (link.pop(UINT32_MAX, r))
+		delivered.emplace_back(r.payload[0]);
+	return delivered;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(udp_capture_round_trip)
+{
+	std::vector<uint8_t> file;
+	const auto a = make_record(1, 7);
+	const dcx::udp_capture_record b{0x12345678, {}, std::vector<uint8_t>(1500, 0x5a)};
+	dcx::udp_capture_encode(a, file);
+	dcx::udp_capture_encode(b, file);
+	dcx::udp_capture_record r;
+	const auto used = dcx::udp_capture_decode(file.data(), file.size(), r);
+	BOOST_TEST(used == 4u + 1 + 3 + 2 + 2);
+	BOOST_TEST(r.time == a.time);
+	BOOST_TEST(r.address == a.address);
+	BOOST_TEST(r.payload == a.payload);
+	BOOST_TEST(dcx::udp_capture_decode(file.data() + used, file.size() - used, r) == file.size() - used);
+	BOOST_TEST(r.time == b.time);
+	BOOST_TEST(r.address.empty());
+	BOOST_TEST(r.payload == b.payload);
+}
+
+/* A record cut anywhere short of its end must not be read.
+ */
+BOOST_AUTO_TEST_CASE(udp_capture_truncated)
+{
+	std::vector<uint8_t> file;
+	dcx::udp_capture_encode(make_record(3, 9), file);
+	dcx::udp_capture_record r;
+	for (std::size_t size = 0; size < file.size(); ++size)
+		BOOST_TEST(dcx::udp_capture_decode(file.data(), size, r) == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(udp_link_perfect)
+{
+	const std::vector<uint8_t> expected{0, 1, 2, 3, 4};
+	BOOST_TEST(run_link({}, 5) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(udp_link_latency)
+{
+	dcx::udp_link_model model{};
+	model.latency = 100;
+	dcx::udp_link_queue link(model);
+	link.push(make_record(5, 1));
+	dcx::udp_capture_record r;
+	BOOST_TEST(!link.pop(104, r));
+	BOOST_TEST(link.pop(105, r));
+	BOOST_TEST(r.payload[0] == 1);
+	BOOST_TEST(link.empty());
+}
+
+BOOST_AUTO_TEST_CASE(udp_link_loss)
+{
+	dcx::udp_link_model model{};
+	model.loss = 100;
+	BOOST_TEST(run_link(model, 20).empty());
+	model.loss = 50;
+	model.seed = 3;
+	const auto delivered = run_link(model, 200);
+	BOOST_TEST(delivered.size() > 50u);
+	BOOST_TEST(delivered.size() < 150u);
+	BOOST_TEST(delivered == run_link(model, 200));
+}
+
+/* Reordering must change the order, but not the set of datagrams.
+ */
+BOOST_AUTO_TEST_CASE(udp_link_reorder)
+{
+	dcx::udp_link_model model{};
+	model.reorder = 25;
+	model.latency = 20;
+	model.seed = 11;
+	auto delivered = run_link(model, 100);
+	BOOST_TEST(delivered.size() == 100u);
+	BOOST_TEST(!std::is_sorted(delivered.begin(), delivered.end()));
+	std::sort(delivered.begin(), delivered.end());
+	for (unsigned i = 0; i < delivered.size(); ++i)
+		BOOST_TEST(delivered[i] == i);
+}
@@ -44,6 +44,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "console.h"
 #include "config.h"
 #if DXX_USE_OGL
+#include "args.h"
 #include "ogl_init.h"
 #endif
 
@@ -497,6 +498,9 @@ static void ogl_font_choose_size(grs_font * font,int gap,int *rw,int *rh){
 
 static void ogl_init_font(grs_font * font)
 {
+	/* A dedicated host has no OpenGL context and never draws text. */
+	if (CGameArg.MplDedicated)
+		return;
 	int oglflags = OGL_FLAG_ALPHA;
 	int	nchars = font->ft_maxchar-font->ft_minchar+1;
 	int w,h,tw,th,curx=0,cury=0;
@@ -801,6 +801,27 @@ int gr_init()
 	if (gr_installed==1)
 		return -1;
 
+	if (CGameArg.MplDedicated)
+	{
+		/* A dedicated host has no window, no video mode and no OpenGL
+		 * context.  Its screen only records the size that fonts and
+		 * canvases are laid out for, and nothing ever presents it.
+		 */
+		ogl_init_texture_list_internal();
+		grd_curscreen = std::make_unique<grs_screen>();
+		*grd_curscreen = {};
+		const auto mode = Game_screen_mode;
+		const uint_fast32_t w = SM_W(mode), h = SM_H(mode);
+		grd_curscreen->set_screen_width_height(w, h);
+		grd_curscreen->sc_aspect = fixdiv(grd_curscreen->get_screen_width() * GameCfg.AspectX, grd_curscreen->get_screen_height() * GameCfg.AspectY);
+		gr_init_canvas(grd_curscreen->sc_canvas, reinterpret_cast<uint8_t *>(d_malloc(w * h)), bm_mode::ogl, w, h);
+		grd_curscreen->sc_canvas.cv_fade_level = GR_FADE_OFF;
+		gr_set_default_canvas();
+		ogl_init_pixel_buffers(w, h);
+		gr_installed = 1;
+		return 0;
+	}
+
 #ifdef RPI
 	// Initialize the broadcom host library
 	// we have to call this before we can create an OpenGL ES context
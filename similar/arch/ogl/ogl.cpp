@@ -28,6 +28,7 @@
 #include <GL/glu.h>
 #endif
 #endif
+#include <stdint.h>
 #include <string.h>
 #include <math.h>
 #include <stdio.h>
@@ -61,12 +62,15 @@
 
 #include "compiler-range_for.h"
 #include "d_levelstate.h"
+#include "d_range.h"
 #include "d_zip.h"
 #include "partial_range.h"
 
 #include <algorithm>
+#include <cstddef>
 #include <memory>
 #include <utility>
+#include <vector>
 using std::max;
 
 //change to 1 for lots of spew.
@@ -130,7 +134,7 @@ static int ogl_rgb_internalformat = GL_RGB8;
 #endif
 static std::unique_ptr<GLfloat[]> sphere_va, circle_va, disk_va;
 static std::array<std::unique_ptr<GLfloat[]>, 3> secondary_lva;
-static int r_polyc,r_tpolyc,r_bitmapc,r_ubitbltc;
+static int r_polyc,r_tpolyc,r_bitmapc,r_ubitbltc,r_tbatchc;
 #define f2glf(x) (f2fl(x))
 
 #define OGL_BINDTEXTURE(a) glBindTexture(GL_TEXTURE_2D, a);
@@ -153,6 +157,408 @@ static void ogl_loadbmtexture(grs_bitmap &bm, bool edgepad)
 	ogl_loadbmtexture_f(bm, CGameCfg.TexFilt, CGameCfg.TexAnisotropy, edgepad);
 }
 
+namespace {
+
+struct ogl_tmap_vertex
+{
+	std::array<GLfloat, 3> position;
+	std::array<GLfloat, 4> color;
+	std::array<GLfloat, 2> texcoord;
+};
+
+/* Draw `count` vertices whose array starts at `base`, which is either a
+ * client pointer or an offset into the bound array buffer.
+ */
+static void ogl_draw_tmap_vertices(const bool textured, const char *const base, const GLenum mode, const unsigned count)
+{
+	ogl_client_states<int, GL_VERTEX_ARRAY, GL_COLOR_ARRAY> cs;
+	(void)cs;
+	glVertexPointer(3, GL_FLOAT, sizeof(ogl_tmap_vertex), base + offsetof(ogl_tmap_vertex, position));
+	glColorPointer(4, GL_FLOAT, sizeof(ogl_tmap_vertex), base + offsetof(ogl_tmap_vertex, color));
+	if (textured)
+	{
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glTexCoordPointer(2, GL_FLOAT, sizeof(ogl_tmap_vertex), base + offsetof(ogl_tmap_vertex, texcoord));
+	}
+	glDrawArrays(mode, 0, count);
+	if (textured)
+		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+}
+
+/* The sides of the level, baked into a vertex buffer when the level is
+ * loaded.  Corner c of side s of segment n is vertex
+ * (n * MAX_SIDES_PER_SEGMENT + s) * 4 + c.  The buffer holds every
+ * world space position, followed by every texture coordinate.  While a
+ * view is drawn, the first pass queues the indices of a face's corners
+ * instead of its rotated points, and the modelview matrix does the work
+ * of g3_rotate_point.
+ *
+ * When a side is drawn, its uvls are compared to the ones it was baked
+ * with, and its texture coordinates are rewritten if they differ.  This
+ * covers sliding textures, and every way that walls, triggers, demos
+ * and the network change a side.
+ *
+ * Light changes every frame, so it is a second buffer of colors in the
+ * same order.  A face sets the colors of its corners when it is queued.
+ * Each draw first uploads the range of colors set since the last one.
+ */
+class ogl_level_mesh
+{
+	GLuint vbo = 0;
+	GLuint color_vbo = 0;
+	std::vector<std::array<uvl, 4>> side_uvls;
+	std::vector<std::array<GLubyte, 4>> colors;
+	std::array<GLfloat, 16> view_matrix;
+	/* The colors set since the last upload are in [dirty_begin, dirty_end). */
+	std::size_t dirty_begin = SIZE_MAX, dirty_end = 0;
+	std::size_t texcoord_offset() const
+	{
+		return colors.size() * sizeof(std::array<GLfloat, 3>);
+	}
+public:
+	/* Set from the start of a view until its batch scope ends. */
+	bool in_view = false;
+	/* Set until the level is baked, or after the buffers are released. */
+	bool stale = true;
+	void build(const std::vector<std::array<GLfloat, 3>> &positions, std::vector<std::array<uvl, 4>> &&uvls);
+	void begin_view();
+	void set_light(std::size_t side, const std::array<uint8_t, 4> &corners, unsigned nv, const std::array<g3s_lrgb, 4> &light);
+	bool update_side(std::size_t side, const std::array<uvl, 4> &uvls);
+	void draw(texture2_rotation_low orient, const std::vector<GLuint> &indices);
+	void reset();
+};
+
+using ogl_side_texcoords = std::array<std::array<GLfloat, 2>, 4>;
+
+static ogl_side_texcoords ogl_get_side_texcoords(const std::array<uvl, 4> &uvls)
+{
+	ogl_side_texcoords texcoords;
+	for (auto &&[t, u] : zip(texcoords, uvls))
+	{
+		t[0] = f2glf(u.u);
+		t[1] = f2glf(u.v);
+	}
+	return texcoords;
+}
+
+void ogl_level_mesh::build(const std::vector<std::array<GLfloat, 3>> &positions, std::vector<std::array<uvl, 4>> &&uvls)
+{
+	reset();
+	stale = false;
+#if DXX_USE_OGLES
+	/* OpenGL ES 1 cannot draw with 32-bit indices. */
+	(void)positions;
+	(void)uvls;
+#else
+	if (!ogl_have_ARB_vertex_buffer_object || positions.empty())
+		return;
+	side_uvls = std::move(uvls);
+	colors.resize(positions.size());
+	std::vector<ogl_side_texcoords> texcoords;
+	texcoords.reserve(side_uvls.size());
+	range_for (auto &s, side_uvls)
+		texcoords.emplace_back(ogl_get_side_texcoords(s));
+	const std::size_t position_size = positions.size() * sizeof(positions[0]);
+	const std::size_t texcoord_size = texcoords.size() * sizeof(texcoords[0]);
+	glGenBuffersFunc(1, &vbo);
+	glGenBuffersFunc(1, &color_vbo);
+	glBindBufferFunc(GL_ARRAY_BUFFER, vbo);
+	glBufferDataFunc(GL_ARRAY_BUFFER, position_size + texcoord_size, nullptr, GL_STATIC_DRAW);
+	glBufferSubDataFunc(GL_ARRAY_BUFFER, 0, position_size, positions.data());
+	glBufferSubDataFunc(GL_ARRAY_BUFFER, position_size, texcoord_size, texcoords.data());
+	glBindBufferFunc(GL_ARRAY_BUFFER, color_vbo);
+	glBufferDataFunc(GL_ARRAY_BUFFER, colors.size() * sizeof(colors[0]), nullptr, GL_DYNAMIC_DRAW);
+	glBindBufferFunc(GL_ARRAY_BUFFER, 0);
+#endif
+}
+
+/* Sum of the products of `axis` and `p`, in double precision, so that
+ * a translation far from the origin keeps the precision of fix.
+ */
+static GLfloat ogl_view_translation(const vms_vector &axis, const vms_vector &p)
+{
+	return (static_cast<double>(axis.x) * p.x + static_cast<double>(axis.y) * p.y + static_cast<double>(axis.z) * p.z) / (static_cast<double>(F1_0) * F1_0);
+}
+
+void ogl_level_mesh::begin_view()
+{
+	if (!vbo)
+		return;
+	const auto &r = View_matrix.rvec;
+	const auto &u = View_matrix.uvec;
+	const auto &f = View_matrix.fvec;
+	/* As in g3_rotate_point, then with z negated, as for rotated
+	 * points.
+	 */
+	view_matrix = {{
+		f2glf(r.x), f2glf(u.x), -f2glf(f.x), 0,
+		f2glf(r.y), f2glf(u.y), -f2glf(f.y), 0,
+		f2glf(r.z), f2glf(u.z), -f2glf(f.z), 0,
+		-ogl_view_translation(r, View_position), -ogl_view_translation(u, View_position), ogl_view_translation(f, View_position), 1,
+	}};
+	in_view = true;
+}
+
+/* Set the colors of the corners of a face of `side`, from the light of
+ * each of its `nv` points.
+ */
+void ogl_level_mesh::set_light(const std::size_t side, const std::array<uint8_t, 4> &corners, const unsigned nv, const std::array<g3s_lrgb, 4> &light)
+{
+	const auto byte = [](const fix l) -> GLubyte {
+		return std::clamp(l, 0, F1_0) * 255 / F1_0;
+	};
+	const std::size_t first = side * 4;
+	for (unsigned i = 0; i < nv; ++i)
+	{
+		auto &l = light[i];
+		colors[first + corners[i]] = {{byte(l.r), byte(l.g), byte(l.b), 255}};
+	}
+	dirty_begin = std::min(dirty_begin, first);
+	dirty_end = std::max(dirty_end, first + 4);
+}
+
+/* Bring the texture coordinates of `side` up to date.  Returns false if
+ * the side was not baked.
+ */
+bool ogl_level_mesh::update_side(const std::size_t side, const std::array<uvl, 4> &uvls)
+{
+	if (side >= side_uvls.size())
+		return false;
+	auto &baked = side_uvls[side];
+	for (auto &&[b, u] : zip(baked, uvls))
+		if (b.u != u.u || b.v != u.v)
+		{
+			baked = uvls;
+			const auto texcoords = ogl_get_side_texcoords(uvls);
+			glBindBufferFunc(GL_ARRAY_BUFFER, vbo);
+			glBufferSubDataFunc(GL_ARRAY_BUFFER, texcoord_offset() + side * sizeof(texcoords), sizeof(texcoords), texcoords.data());
+			glBindBufferFunc(GL_ARRAY_BUFFER, 0);
+			break;
+		}
+	return true;
+}
+
+void ogl_level_mesh::draw(const texture2_rotation_low orient, const std::vector<GLuint> &indices)
+{
+#if DXX_USE_OGLES
+	(void)orient;
+	(void)indices;
+#else
+	if (dirty_begin < dirty_end)
+	{
+		glBindBufferFunc(GL_ARRAY_BUFFER, color_vbo);
+		glBufferSubDataFunc(GL_ARRAY_BUFFER, dirty_begin * sizeof(colors[0]), (dirty_end - dirty_begin) * sizeof(colors[0]), &colors[dirty_begin]);
+		dirty_begin = SIZE_MAX;
+		dirty_end = 0;
+	}
+	glPushMatrix();
+	glLoadMatrixf(view_matrix.data());
+	/* Overlay textures are rotated as in _g3_draw_tmap_2. */
+	if (orient != texture2_rotation_low::Normal)
+	{
+		static constexpr std::array<std::array<GLfloat, 16>, 3> rotations{{
+			{{0, 1, 0, 0, -1, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0, 1}},
+			{{-1, 0, 0, 0, 0, -1, 0, 0, 0, 0, 1, 0, 1, 1, 0, 1}},
+			{{0, -1, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1}},
+		}};
+		glMatrixMode(GL_TEXTURE);
+		glLoadMatrixf(rotations[static_cast<unsigned>(orient) - 1].data());
+		glMatrixMode(GL_MODELVIEW);
+	}
+	{
+		ogl_client_states<int, GL_VERTEX_ARRAY, GL_COLOR_ARRAY, GL_TEXTURE_COORD_ARRAY> cs;
+		(void)cs;
+		glBindBufferFunc(GL_ARRAY_BUFFER, vbo);
+		glVertexPointer(3, GL_FLOAT, 0, nullptr);
+		glTexCoordPointer(2, GL_FLOAT, 0, reinterpret_cast<const char *>(texcoord_offset()));
+		glBindBufferFunc(GL_ARRAY_BUFFER, color_vbo);
+		glColorPointer(4, GL_UNSIGNED_BYTE, 0, nullptr);
+		glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, indices.data());
+		glBindBufferFunc(GL_ARRAY_BUFFER, 0);
+	}
+	if (orient != texture2_rotation_low::Normal)
+	{
+		glMatrixMode(GL_TEXTURE);
+		glLoadIdentity();
+		glMatrixMode(GL_MODELVIEW);
+	}
+	glPopMatrix();
+#endif
+}
+
+/* Release the buffers before their context is destroyed.  The next view
+ * bakes the level again.
+ */
+void ogl_level_mesh::reset()
+{
+	in_view = false;
+	stale = true;
+	side_uvls.clear();
+	colors.clear();
+	dirty_begin = SIZE_MAX;
+	dirty_end = 0;
+	if (vbo)
+	{
+		glDeleteBuffersFunc(1, &vbo);
+		glDeleteBuffersFunc(1, &color_vbo);
+		vbo = color_vbo = 0;
+	}
+}
+
+static ogl_level_mesh level_mesh;
+
+/* Texture maps queued while an ogl_tmap_batch_scope exists.  Faces are
+ * split into triangles, and consecutive faces with the same texture
+ * are drawn with one glDrawArrays call.  Faces are never reordered, so
+ * the result is the same as drawing each face as it arrives.  Faces of
+ * the level mesh are queued as indices instead, and drawn with one
+ * glDrawElements call.
+ *
+ * The triangles are streamed into one vertex buffer object.  Each flush
+ * appends to the buffer, and when it is full, the storage is replaced,
+ * so that the driver need not wait for draws still reading the old
+ * storage.
+ */
+class ogl_tmap_batch
+{
+	static constexpr std::size_t vbo_size = 1024 * 1024;
+	std::vector<ogl_tmap_vertex> vertices;
+	std::vector<GLuint> indices;
+	/* Texture of the queued triangles, or 0 if they are untextured. */
+	GLuint texture = 0;
+	texture2_rotation_low orient = texture2_rotation_low::Normal;
+	GLuint vbo = 0;
+	std::size_t vbo_used = vbo_size;
+public:
+	bool recording = false;
+	void add(GLuint texture, const ogl_tmap_vertex *fan, unsigned nv);
+	void add_mesh(GLuint texture, texture2_rotation_low orient, GLuint first, const std::array<uint8_t, 4> &corners, unsigned nv);
+	void flush();
+	void reset();
+};
+
+void ogl_tmap_batch::add(const GLuint face_texture, const ogl_tmap_vertex *const fan, const unsigned nv)
+{
+	if (texture != face_texture || !indices.empty())
+	{
+		flush();
+		texture = face_texture;
+	}
+	for (unsigned i = 2; i < nv; ++i)
+	{
+		vertices.emplace_back(fan[0]);
+		vertices.emplace_back(fan[i - 1]);
+		vertices.emplace_back(fan[i]);
+	}
+}
+
+/* Queue a face whose corners are level mesh vertices `first` plus each
+ * of `corners`.
+ */
+void ogl_tmap_batch::add_mesh(const GLuint face_texture, const texture2_rotation_low face_orient, const GLuint first, const std::array<uint8_t, 4> &corners, const unsigned nv)
+{
+	if (texture != face_texture || orient != face_orient || !vertices.empty())
+	{
+		flush();
+		texture = face_texture;
+		orient = face_orient;
+	}
+	for (unsigned i = 2; i < nv; ++i)
+	{
+		indices.emplace_back(first + corners[0]);
+		indices.emplace_back(first + corners[i - 1]);
+		indices.emplace_back(first + corners[i]);
+	}
+}
+
+void ogl_tmap_batch::flush()
+{
+	if (!indices.empty())
+	{
+		OGL_ENABLE(TEXTURE_2D);
+		OGL_BINDTEXTURE(texture);
+		level_mesh.draw(orient, indices);
+		indices.clear();
+		r_tbatchc++;
+		return;
+	}
+	if (vertices.empty())
+		return;
+	const std::size_t size = vertices.size() * sizeof(ogl_tmap_vertex);
+	const char *base;
+	if (ogl_have_ARB_vertex_buffer_object)
+	{
+		if (!vbo)
+			glGenBuffersFunc(1, &vbo);
+		glBindBufferFunc(GL_ARRAY_BUFFER, vbo);
+		if (vbo_used + size > vbo_size)
+		{
+			glBufferDataFunc(GL_ARRAY_BUFFER, std::max(size, vbo_size), nullptr, GL_STREAM_DRAW);
+			vbo_used = 0;
+		}
+		glBufferSubDataFunc(GL_ARRAY_BUFFER, vbo_used, size, vertices.data());
+		base = reinterpret_cast<const char *>(vbo_used);
+		vbo_used += size;
+	}
+	else
+		base = reinterpret_cast<const char *>(vertices.data());
+	if (texture)
+	{
+		OGL_ENABLE(TEXTURE_2D);
+		OGL_BINDTEXTURE(texture);
+	}
+	else
+		OGL_DISABLE(TEXTURE_2D);
+	ogl_draw_tmap_vertices(texture, base, GL_TRIANGLES, vertices.size());
+	if (ogl_have_ARB_vertex_buffer_object)
+		glBindBufferFunc(GL_ARRAY_BUFFER, 0);
+	vertices.clear();
+	r_tbatchc++;
+}
+
+/* Release the vertex buffer before its context is destroyed. */
+void ogl_tmap_batch::reset()
+{
+	vertices.clear();
+	indices.clear();
+	if (vbo)
+	{
+		glDeleteBuffersFunc(1, &vbo);
+		vbo = 0;
+	}
+	vbo_used = vbo_size;
+}
+
+static ogl_tmap_batch tmap_batch;
+
+/* Draw one face, or queue it if a batch is recording. */
+static void ogl_draw_tmap_fan(const GLuint texture, const ogl_tmap_vertex *const fan, const unsigned nv)
+{
+	if (tmap_batch.recording)
+		tmap_batch.add(texture, fan, nv);
+	else
+		ogl_draw_tmap_vertices(texture, reinterpret_cast<const char *>(fan), GL_TRIANGLE_FAN, nv);
+}
+
+}
+
+void ogl_tmap_batch_flush()
+{
+	tmap_batch.flush();
+}
+
+ogl_tmap_batch_scope::ogl_tmap_batch_scope() :
+	previous(std::exchange(tmap_batch.recording, true))
+{
+}
+
+ogl_tmap_batch_scope::~ogl_tmap_batch_scope()
+{
+	tmap_batch.flush();
+	tmap_batch.recording = previous;
+	level_mesh.in_view = false;
+}
+
 }
 
 #if DXX_USE_OGLES
@@ -259,6 +665,8 @@ void ogl_init_texture_list_internal(void){
 }
 
 void ogl_smash_texture_list_internal(void){
+	tmap_batch.reset();
+	level_mesh.reset();
 	sphere_va.reset();
 	circle_va.reset();
 	disk_va.reset();
@@ -343,10 +751,11 @@ static void ogl_texture_stats(void)
 	const auto &&fspacx2 = FSPACX(2);
 	const auto &&fspacy1 = FSPACY(1);
 	const auto &&line_spacing = LINE_SPACING(game_font, game_font);
-	gr_printf(canvas, game_font, fspacx2, fspacy1, "%i flat %i tex %i bitmaps", r_polyc, r_tpolyc, r_bitmapc);
+	gr_printf(canvas, game_font, fspacx2, fspacy1, "%i flat %i tex (%i batches) %i bitmaps", r_polyc, r_tpolyc, r_tbatchc, r_bitmapc);
 	gr_printf(canvas, game_font, fspacx2, fspacy1 + line_spacing, "%i(%i,%i,%i,%i) %iK(%iK wasted) (%i postcachedtex)", used, usedrgba, usedrgb, usedidx, usedother, truebytes / 1024, (truebytes - databytes) / 1024, r_texcount - r_cachedtexcount);
 	gr_printf(canvas, game_font, fspacx2, fspacy1 + (line_spacing * 2), "%ibpp(r%i,g%i,b%i,a%i)x%i=%iK depth%i=%iK", idx, r, g, b, a, dbl, colorsize / 1024, depth, depthsize / 1024);
-	gr_printf(canvas, game_font, fspacx2, fspacy1 + (line_spacing * 3), "total=%iK", (colorsize + depthsize + truebytes) / 1024);
+	const auto &texmerge_stats = texmerge_get_stats();
+	gr_printf(canvas, game_font, fspacx2, fspacy1 + (line_spacing * 3), "total=%iK texmerge %u hit %u miss", (colorsize + depthsize + truebytes) / 1024, texmerge_stats.hits, texmerge_stats.misses);
 }
 
 static void ogl_bindbmtex(grs_bitmap &bm, bool edgepad){
@@ -547,6 +956,70 @@ void ogl_cache_level_textures(void)
 	}
 	glmprintf((CON_DEBUG, "finished caching"));
 	r_cachedtexcount = r_texcount;
+	ogl_level_mesh_build();
+}
+
+void ogl_level_mesh_build()
+{
+	auto &LevelSharedVertexState = LevelSharedSegmentState.get_vertex_state();
+	auto &Vertices = LevelSharedVertexState.get_vertices();
+	auto &vcvertptr = Vertices.vcptr;
+	const std::size_t sides = (Highest_segment_index + 1) * MAX_SIDES_PER_SEGMENT;
+	std::vector<std::array<GLfloat, 3>> positions(sides * 4);
+	std::vector<std::array<uvl, 4>> uvls(sides);
+	range_for (const auto &&seg, vcsegptridx)
+	{
+		range_for (const uint_fast32_t sidenum, xrange(MAX_SIDES_PER_SEGMENT))
+		{
+			const std::size_t side = static_cast<segnum_t>(seg) * MAX_SIDES_PER_SEGMENT + sidenum;
+			for (auto &&[position, vi] : zip(partial_range(positions, side * 4, side * 4 + 4), Side_to_verts[sidenum]))
+			{
+				auto &v = *vcvertptr(seg->verts[vi]);
+				position = {{f2glf(v.x), f2glf(v.y), f2glf(v.z)}};
+			}
+			uvls[side] = seg->unique_segment::sides[sidenum].uvls;
+		}
+	}
+	level_mesh.build(positions, std::move(uvls));
+}
+
+void ogl_level_mesh_invalidate()
+{
+	level_mesh.stale = true;
+}
+
+void ogl_level_mesh_begin_view()
+{
+	if (level_mesh.stale)
+		ogl_level_mesh_build();
+	level_mesh.begin_view();
+}
+
+bool ogl_level_mesh_draw_tmap(grs_canvas &canvas, const vcsegptridx_t seg, const unsigned sidenum, const std::array<uint8_t, 4> &corners, const unsigned nv, const std::array<g3s_lrgb, 4> &light, grs_bitmap &bm, grs_bitmap *const bm2, const texture2_rotation_low orient)
+{
+	/* The mesh colors have no alpha, and are always lit. */
+	if (!level_mesh.in_view || !tmap_batch.recording || tmap_drawer_ptr != draw_tmap || canvas.cv_fade_level < GR_FADE_OFF)
+		return false;
+	if (bm.get_flag_mask(BM_FLAG_NO_LIGHTING) || (bm2 && bm2->get_flag_mask(BM_FLAG_NO_LIGHTING)))
+		return false;
+	const std::size_t side = static_cast<segnum_t>(seg) * MAX_SIDES_PER_SEGMENT + sidenum;
+	if (!level_mesh.update_side(side, seg->unique_segment::sides[sidenum].uvls))
+		return false;
+	level_mesh.set_light(side, corners, nv, light);
+	const GLuint first = side * 4;
+	OGL_ENABLE(TEXTURE_2D);
+	ogl_bindbmtex(bm, 0);
+	ogl_texwrap(bm.gltexture, GL_REPEAT);
+	r_tpolyc++;
+	tmap_batch.add_mesh(bm.gltexture->handle, texture2_rotation_low::Normal, first, corners, nv);
+	if (bm2)
+	{
+		ogl_bindbmtex(*bm2, 1);
+		ogl_texwrap(bm2->gltexture, GL_REPEAT);
+		r_tpolyc++;
+		tmap_batch.add_mesh(bm2->gltexture->handle, orient, first, corners, nv);
+	}
+	return true;
 }
 
 }
@@ -555,6 +1028,7 @@ namespace dcx {
 
 void g3_draw_line(grs_canvas &canvas, const g3s_point &p0, const g3s_point &p1, const uint8_t c)
 {
+	ogl_tmap_batch_flush();
 	GLfloat color_r, color_g, color_b;
 	GLfloat color_array[] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
   
@@ -792,6 +1266,7 @@ namespace dcx {
  */
 void g3_draw_sphere(grs_canvas &canvas, cg3s_point &pnt, fix rad, const uint8_t c)
 {
+	ogl_tmap_batch_flush();
 	int i;
 	const float scale = (static_cast<float>(canvas.cv_bitmap.bm_w) / canvas.cv_bitmap.bm_h);
 	std::array<GLfloat, 20 * 4> color_array;
@@ -870,6 +1345,7 @@ int gr_disk(grs_canvas &canvas, const fix x, const fix y, const fix r, const uin
  */
 void _g3_draw_poly(grs_canvas &canvas, const uint_fast32_t nv, cg3s_point *const *const pointlist, const uint8_t palette_color_index)
 {
+	ogl_tmap_batch_flush();
 	if (nv > MAX_POINTS_PER_POLY)
 		return;
 	flatten_array<GLfloat, 4, MAX_POINTS_PER_POLY> color_array;
@@ -912,17 +1388,18 @@ void _g3_draw_poly(grs_canvas &canvas, const uint_fast32_t nv, cg3s_point *const
 void _g3_draw_tmap(grs_canvas &canvas, const unsigned nv, cg3s_point *const *const pointlist, const g3s_uvl *const uvl_list, const g3s_lrgb *const light_rgb, grs_bitmap &bm)
 {
 	GLfloat color_alpha = 1.0;
+	GLuint texture;
 
-	ogl_client_states<int, GL_VERTEX_ARRAY, GL_COLOR_ARRAY> cs;
 	if (tmap_drawer_ptr == draw_tmap) {
-		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 		OGL_ENABLE(TEXTURE_2D);
 		ogl_bindbmtex(bm, 0);
 		ogl_texwrap(bm.gltexture, GL_REPEAT);
+		texture = bm.gltexture->handle;
 		r_tpolyc++;
 		color_alpha = (canvas.cv_fade_level >= GR_FADE_OFF) ? 1.0 : (1.0 - static_cast<float>(canvas.cv_fade_level) / (static_cast<float>(GR_FADE_LEVELS) - 1.0));
 	} else if (tmap_drawer_ptr == draw_tmap_flat) {
 		OGL_DISABLE(TEXTURE_2D);
+		texture = 0;
 		/* for cloaked state faces */
 		color_alpha = 1.0 - (canvas.cv_fade_level / static_cast<GLfloat>(NUM_LIGHTING_LEVELS));
 	} else {
@@ -930,20 +1407,19 @@ void _g3_draw_tmap(grs_canvas &canvas, const unsigned nv, cg3s_point *const *con
 		return;
 	}
 
-	flatten_array<GLfloat, 3, MAX_POINTS_PER_POLY> vertices;
-	flatten_array<GLfloat, 4, MAX_POINTS_PER_POLY> color_array;
-	flatten_array<GLfloat, 2, MAX_POINTS_PER_POLY> texcoord_array;
+	std::array<ogl_tmap_vertex, MAX_POINTS_PER_POLY> vertices;
 
-	for (auto &&[point, light, uvl, vert, color, texcoord] : zip(
+	for (auto &&[point, light, uvl, v] : zip(
 			unchecked_partial_range(pointlist, nv),
 			unchecked_partial_range(light_rgb, nv),
 			unchecked_partial_range(uvl_list, nv),
-			unchecked_partial_range(vertices.nested.data(), nv),
-			unchecked_partial_range(color_array.nested.data(), nv),
-			partial_range(texcoord_array.nested, nv)
+			partial_range(vertices, nv)
 		)
 	)
 	{
+		auto &vert = v.position;
+		auto &color = v.color;
+		auto &texcoord = v.texcoord;
 		vert[0] = f2glf(point->p3_vec.x);
 		vert[1] = f2glf(point->p3_vec.y);
 		vert[2] = -f2glf(point->p3_vec.z);
@@ -968,17 +1444,7 @@ void _g3_draw_tmap(grs_canvas &canvas, const unsigned nv, cg3s_point *const *con
 		}
 	}
 
-	glVertexPointer(3, GL_FLOAT, 0, vertices.flat.data());
-	glColorPointer(4, GL_FLOAT, 0, color_array.flat.data());
-	if (tmap_drawer_ptr == draw_tmap) {
-		glTexCoordPointer(2, GL_FLOAT, 0, texcoord_array.flat.data());
-	}
-	
-	glDrawArrays(GL_TRIANGLE_FAN, 0, nv);
-	
-	glDisableClientState(GL_VERTEX_ARRAY);
-	glDisableClientState(GL_COLOR_ARRAY);
-	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	ogl_draw_tmap_fan(texture, vertices.data(), nv);
 }
 
 }
@@ -989,35 +1455,35 @@ void _g3_draw_tmap(grs_canvas &canvas, const unsigned nv, cg3s_point *const *con
 void _g3_draw_tmap_2(grs_canvas &canvas, const unsigned nv, const g3s_point *const *const pointlist, const g3s_uvl *uvl_list, const g3s_lrgb *light_rgb, grs_bitmap &bmbot, grs_bitmap &bm, const texture2_rotation_low orient)
 {
 	_g3_draw_tmap(canvas, nv, pointlist, uvl_list, light_rgb, bmbot);//draw the bottom texture first.. could be optimized with multitexturing..
-	ogl_client_states<int, GL_VERTEX_ARRAY, GL_COLOR_ARRAY, GL_TEXTURE_COORD_ARRAY> cs;
-	(void)cs;
 	r_tpolyc++;
 	OGL_ENABLE(TEXTURE_2D);
 	ogl_bindbmtex(bm, 1);
 	ogl_texwrap(bm.gltexture, GL_REPEAT);
 
-	flatten_array<GLfloat, 4, MAX_POINTS_PER_POLY> color_array;
+	std::array<ogl_tmap_vertex, MAX_POINTS_PER_POLY> vertices;
 	{
 		const GLfloat alpha = (canvas.cv_fade_level >= GR_FADE_OFF)
 			? 1.0
 			: (1.0 - static_cast<float>(canvas.cv_fade_level) / (static_cast<float>(GR_FADE_LEVELS) - 1.0));
-		auto &&color_range = unchecked_partial_range(color_array.nested.data(), nv);
+		auto &&vertex_range = partial_range(vertices, nv);
 		if (bm.get_flag_mask(BM_FLAG_NO_LIGHTING))
 		{
-			for (auto &e : color_range)
+			for (auto &v : vertex_range)
 			{
+				auto &e = v.color;
 				e[0] = e[1] = e[2] = 1.0;
 				e[3] = alpha;
 			}
 		}
 		else
 		{
-			for (auto &&[e, l] : zip(
-					color_range,
+			for (auto &&[v, l] : zip(
+					vertex_range,
 					unchecked_partial_range(light_rgb, nv)
 				)
 			)
 			{
+				auto &e = v.color;
 				e[0] = f2glf(l.r);
 				e[1] = f2glf(l.g);
 				e[2] = f2glf(l.b);
@@ -1026,17 +1492,15 @@ void _g3_draw_tmap_2(grs_canvas &canvas, const unsigned nv, const g3s_point *con
 		}
 	}
 
-	flatten_array<GLfloat, 3, MAX_POINTS_PER_POLY> vertices;
-	flatten_array<GLfloat, 2, MAX_POINTS_PER_POLY> texcoord_array;
-
-	for (auto &&[point, uvl, vert, texcoord] : zip(
+	for (auto &&[point, uvl, v] : zip(
 			unchecked_partial_range(pointlist, nv),
 			unchecked_partial_range(uvl_list, nv),
-			unchecked_partial_range(vertices.nested.data(), nv),
-			partial_range(texcoord_array.nested, nv)
+			partial_range(vertices, nv)
 		)
 	)
 	{
+		auto &vert = v.position;
+		auto &texcoord = v.texcoord;
 		const GLfloat uf = f2glf(uvl.u), vf = f2glf(uvl.v);
 		switch(orient){
 			case texture2_rotation_low::_1:
@@ -1060,10 +1524,7 @@ void _g3_draw_tmap_2(grs_canvas &canvas, const unsigned nv, const g3s_point *con
 		vert[1] = f2glf(point->p3_vec.y);
 		vert[2] = -f2glf(point->p3_vec.z);
 	}
-	glVertexPointer(3, GL_FLOAT, 0, vertices.flat.data());
-	glColorPointer(4, GL_FLOAT, 0, color_array.flat.data());
-	glTexCoordPointer(2, GL_FLOAT, 0, texcoord_array.flat.data());
-	glDrawArrays(GL_TRIANGLE_FAN, 0, nv);
+	ogl_draw_tmap_fan(bm.gltexture->handle, vertices.data(), nv);
 }
 
 namespace dcx {
@@ -1073,6 +1534,7 @@ namespace dcx {
  */
 void g3_draw_bitmap(grs_canvas &canvas, const vms_vector &pos, const fix iwidth, const fix iheight, grs_bitmap &bm)
 {
+	ogl_tmap_batch_flush();
 	r_bitmapc++;
 	
 	ogl_client_states<int, GL_VERTEX_ARRAY, GL_COLOR_ARRAY, GL_TEXTURE_COORD_ARRAY> cs;
@@ -1225,6 +1687,7 @@ bool ogl_ubitblt(unsigned w,unsigned h,unsigned dx,unsigned dy, unsigned sx, uns
  */
 void ogl_toggle_depth_test(int enable)
 {
+	ogl_tmap_batch_flush();
 	if (enable)
 		glEnable(GL_DEPTH_TEST);
 	else
@@ -1236,6 +1699,7 @@ void ogl_toggle_depth_test(int enable)
  */
 void ogl_set_blending(const gr_blend cv_blend_func)
 {
+	ogl_tmap_batch_flush();
 	GLenum s, d;
 	switch (cv_blend_func)
 	{
@@ -1258,7 +1722,7 @@ void ogl_set_blending(const gr_blend cv_blend_func)
 
 void ogl_start_frame(grs_canvas &canvas)
 {
-	r_polyc=0;r_tpolyc=0;r_bitmapc=0;r_ubitbltc=0;
+	r_polyc=0;r_tpolyc=0;r_bitmapc=0;r_ubitbltc=0;r_tbatchc=0;
 
 	OGL_VIEWPORT(canvas.cv_bitmap.bm_x, canvas.cv_bitmap.bm_y, canvas.cv_bitmap.bm_w, canvas.cv_bitmap.bm_h);
 	glClearColor(0.0, 0.0, 0.0, 0.0);
@@ -1364,6 +1828,9 @@ void ogl_end_frame(void){
 
 void gr_flip(void)
 {
+	/* A dedicated host has no context to present. */
+	if (CGameArg.MplDedicated)
+		return;
 	if (CGameArg.DbgRenderStats)
 		ogl_texture_stats();
 
@@ -1592,6 +2059,9 @@ static void tex_set_size(ogl_texture &tex)
 //stores OpenGL textured id in *texid and u/v values required to get only the real data in *u/*v
 static int ogl_loadtexture(const palette_array_t &pal, const uint8_t *data, const int dxo, int dyo, ogl_texture &tex, const int bm_flags, const int data_format, opengl_texture_filter texfilt, const bool texanis, const bool edgepad)
 {
+	/* A dedicated host has no context to upload to. */
+	if (CGameArg.MplDedicated)
+		return 0;
 	tex.tw = pow2ize (tex.w);
 	tex.th = pow2ize (tex.h);//calculate smallest texture size that can accomodate us (must be multiples of 2)
 
@@ -1834,6 +2304,8 @@ void ogl_loadbmtexture_f(grs_bitmap &rbm, const opengl_texture_filter texfilt, b
 {
 	assert(!rbm.get_flag_mask(BM_FLAG_PAGED_OUT));
 	assert(rbm.bm_data);
+	if (CGameArg.MplDedicated)
+		return;
 	grs_bitmap *bm = &rbm;
 	while (const auto bm_parent = bm->bm_parent)
 		bm = bm_parent;
@@ -1891,6 +2363,7 @@ void ogl_loadbmtexture_f(grs_bitmap &rbm, const opengl_texture_filter texfilt, b
 
 static void ogl_freetexture(ogl_texture &gltexture)
 {
+	ogl_tmap_batch_flush();
 	if (gltexture.handle>0) {
 		r_texcount--;
 		glmprintf((CON_DEBUG, "ogl_freetexture(%p):%i (%i left)", &gltexture, gltexture.handle, r_texcount));
@@ -122,19 +122,14 @@ namespace dsx {
 
 static SDL_AudioSpec WaveSpec;
 static int next_channel = 0;
+/* Set when there is no device, and the caller pulls the mixed samples
+ * with digi_audio_mix_offline instead.
+ */
+static bool digi_audio_offline;
 
-/* Audio mixing callback */
 //changed on 980905 by adb to cleanup, add pan support and optimize mixer
-static void audio_mixcallback(void *, Uint8 *stream, int len)
+static void audio_mix_slots(Uint8 *const stream, Uint8 *const streamend)
 {
-	Uint8 *streamend = stream + len;
-	if (!digi_initialised)
-		return;
-
-	memset(stream, 0x80, len); // fix "static" sound bug on Mac OS X
-
-	SDL_LockAudio();
-
 	range_for (auto &sl, SoundSlots)
 	{
 		if (sl.playing) {
@@ -170,15 +165,27 @@ static void audio_mixcallback(void *, Uint8 *stream, int len)
 			sl.position = sldata - sl.samples;
 		}
 	}
+}
+//end changes by adb
 
+/* Audio mixing callback */
+static void audio_mixcallback(void *, Uint8 *stream, int len)
+{
+	if (!digi_initialised)
+		return;
+
+	memset(stream, 0x80, len); // fix "static" sound bug on Mac OS X
+
+	SDL_LockAudio();
+	audio_mix_slots(stream, stream + len);
 	SDL_UnlockAudio();
 }
-//end changes by adb
 
 /* Initialise audio devices. */
 int digi_audio_init()
 {
-	if (SDL_InitSubSystem(SDL_INIT_AUDIO)<0) {
+	digi_audio_offline = !CGameArg.DbgExportAudio.empty();
+	if (!digi_audio_offline && SDL_InitSubSystem(SDL_INIT_AUDIO)<0) {
 		Error("SDL audio initialisation failed: %s.",SDL_GetError());
 	}
 
@@ -194,6 +201,11 @@ int digi_audio_init()
 	WaveSpec.samples = SOUND_BUFFER_SIZE;
 	WaveSpec.callback = audio_mixcallback;
 
+	/* Without a device, the export mixes on the game thread, one frame
+	 * at a time.
+	 */
+	if (!digi_audio_offline)
+	{
 	if ( SDL_OpenAudio(&WaveSpec, NULL) < 0 ) {
 		//edited on 10/05/98 by Matt Mueller - should keep running, just with no sound.
 		Warning("\nError: Couldn't open audio: %s\n", SDL_GetError());
@@ -202,6 +214,7 @@ int digi_audio_init()
 		//end edit -MM
 	}
 	SDL_PauseAudio(0);
+	}
 
 	digi_initialised = 1;
 
@@ -217,6 +230,8 @@ void digi_audio_close()
 {
 	if (!digi_initialised) return;
 	digi_initialised = 0;
+	if (digi_audio_offline)
+		return;
 #ifdef __MINGW32__
 	SDL_Delay(500); // CloseAudio hangs if it's called too soon after opening?
 #endif
@@ -300,6 +315,18 @@ int digi_audio_start_sound(short soundnum, fix volume, int pan, int looping, int
 	return i;
 }
 
+void digi_audio_mix_offline(uint8_t *const stream, const std::size_t len)
+{
+	memset(stream, 0x80, len);
+	if (digi_initialised)
+		audio_mix_slots(stream, stream + len);
+}
+
+unsigned digi_audio_get_sample_rate()
+{
+	return WaveSpec.freq;
+}
+
 //added on 980905 by adb from original source to make sfx volume work
 void digi_audio_set_digi_volume( int dvolume )
 {
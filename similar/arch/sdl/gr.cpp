@@ -45,6 +45,10 @@ void gr_flip()
 {
 	SDL_Rect src, dest;
 
+	/* A dedicated host draws into a surface that is never shown. */
+	if (!screen)
+		return;
+
 	dest.x = src.x = dest.y = src.y = 0;
 	dest.w = src.w = canvas->w;
 	dest.h = src.h = canvas->h;
@@ -171,14 +175,31 @@ int gr_init()
 	if (gr_installed==1)
 		return -1;
 
-	if (SDL_Init(SDL_INIT_VIDEO) < 0)
+	grd_curscreen = std::make_unique<grs_screen>();
+	*grd_curscreen = {};
+
+	if (CGameArg.MplDedicated)
+	{
+		/* A dedicated host has no display and no video mode.  Its
+		 * screen is a surface in memory, which is never presented.
+		 */
+		const auto mode = Game_screen_mode;
+		const unsigned w = SM_W(mode), h = SM_H(mode);
+		canvas = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, 8, 0, 0, 0, 0);
+		if (canvas == NULL)
+		{
+			Error("Could not create canvas surface\n");
+			exit(1);
+		}
+		grd_curscreen->set_screen_width_height(w, h);
+		grd_curscreen->sc_aspect = fixdiv(grd_curscreen->get_screen_width() * GameCfg.AspectX, grd_curscreen->get_screen_height() * GameCfg.AspectY);
+		gr_init_canvas(grd_curscreen->sc_canvas, reinterpret_cast<unsigned char *>(canvas->pixels), bm_mode::linear, w, h);
+	}
+	else if (SDL_Init(SDL_INIT_VIDEO) < 0)
 	{
 		Error("SDL library video initialisation failed: %s.",SDL_GetError());
 	}
 
-	grd_curscreen = std::make_unique<grs_screen>();
-	*grd_curscreen = {};
-
 	if (!CGameCfg.WindowMode && !CGameArg.SysWindow)
 		sdl_video_flags|=SDL_FULLSCREEN;
 
@@ -56,7 +56,8 @@ arch_atexit arch_init()
 {
 	int t;
 
-	if (SDL_Init(SDL_INIT_VIDEO) < 0)
+	/* A dedicated host opens no display, so it needs no video. */
+	if (SDL_Init(CGameArg.MplDedicated ? 0 : SDL_INIT_VIDEO) < 0)
 		Error("SDL library initialisation failed: %s.",SDL_GetError());
 #if DXX_USE_SDLIMAGE
 	IMG_Init(0);
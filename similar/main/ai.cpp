@@ -73,6 +73,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "u_mem.h"
 //end addition -MM
 
+#include "profile.h"
 #include "compiler-range_for.h"
 #include "segiter.h"
 #include "d_enumerate.h"
@@ -3167,6 +3168,7 @@ static bool skip_ai_for_time_splice(const vcobjptridx_t robot, const robot_info
 // --------------------------------------------------------------------------------------------------------------------
 void do_ai_frame(const vmobjptridx_t obj)
 {
+	const profile_scope profile{profile_zone::do_ai_frame};
 	auto &LevelSharedVertexState = LevelSharedSegmentState.get_vertex_state();
 	auto &Vertices = LevelSharedVertexState.get_vertices();
 	const auto Difficulty_level = GameUniqueState.Difficulty_level;
@@ -4645,10 +4647,11 @@ void do_ai_frame_all(void)
 		// Clear if supposed misisle camera is not a weapon, or just every so often, just in case.
 		if (((d_tick_count & 0x0f) == 0) || (Ai_last_missile_camera->type != OBJ_WEAPON)) {
 			Ai_last_missile_camera = nullptr;
-			range_for (const auto &&objp, vmobjptr)
+			range_for (const auto i, obj_list_of_type(OBJ_ROBOT))
 			{
-				if (objp->type == OBJ_ROBOT)
-					objp->ctype.ai_info.SUB_FLAGS &= ~SUB_FLAGS_CAMERA_AWAKE;
+				auto &objp = *vmobjptr(i);
+				if (objp.type == OBJ_ROBOT)
+					objp.ctype.ai_info.SUB_FLAGS &= ~SUB_FLAGS_CAMERA_AWAKE;
 			}
 		}
 	}
@@ -4656,8 +4659,13 @@ void do_ai_frame_all(void)
 	// (Moved here from do_d2_boss_stuff() because that only gets called if robot aware of player.)
 	auto &Robot_info = LevelSharedRobotInfoState.Robot_info;
 	if (BossUniqueState.Boss_dying) {
-		range_for (const auto &&objp, vmobjptridx)
+		/* By index, since a dying boss can drop robots, which are added
+		 * to the list.
+		 */
+		auto &robots = obj_list_of_type(OBJ_ROBOT);
+		for (std::size_t j = 0, n = robots.size(); j != n; ++j)
 		{
+			const auto &&objp = vmobjptridx(robots[j]);
 			if (objp->type == OBJ_ROBOT)
 				if (Robot_info[get_robot_id(objp)].boss_flag)
 					do_boss_dying_frame(objp);
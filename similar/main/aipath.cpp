@@ -23,9 +23,12 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
  *
  */
 
+#include <algorithm>
+#include <climits>
 #include <stdio.h>		//	for printf()
 #include <stdlib.h>		// for d_rand() and qsort()
 #include <string.h>		// for memset()
+#include <vector>
 
 #include "inferno.h"
 #include "console.h"
@@ -92,6 +95,60 @@ static void create_random_xlate(std::array<uint8_t, MAX_SIDES_PER_SEGMENT> &xt)
 	}
 }
 
+/* Scratch state for create_path_points.  A node belongs to the current
+ * search only if its generation matches Path_generation, so the arrays
+ * never need to be cleared between searches.
+ */
+struct path_node
+{
+	unsigned generation;
+	segnum_t parent;
+	uint16_t depth;
+	bool closed;
+	/* Center to center distance along the best known route. */
+	fix cost;
+	/* Straight line distance from the center to the goal. */
+	fix estimate;
+	vms_vector center;
+};
+
+struct path_open_entry
+{
+	fix priority;
+	unsigned sequence;
+	fix cost;
+	segnum_t segnum;
+};
+
+/* Orders the open set so that the heap top is the lowest priority, and
+ * the earliest added among equal priorities.
+ */
+struct path_open_order
+{
+	bool operator()(const path_open_entry &a, const path_open_entry &b) const
+	{
+		return a.priority != b.priority ? a.priority > b.priority : a.sequence > b.sequence;
+	}
+};
+
+/* Grows to the number of segments in the largest level played. */
+static std::vector<path_node> Path_nodes;
+static std::vector<path_open_entry> Path_open;
+static unsigned Path_generation;
+
+static void start_path_search(const std::size_t segment_count)
+{
+	if (Path_nodes.size() < segment_count)
+		Path_nodes.resize(segment_count);
+	if (!++Path_generation)
+	{
+		range_for (auto &n, Path_nodes)
+			n.generation = 0;
+		Path_generation = 1;
+	}
+	Path_open.clear();
+}
+
 }
 
 namespace dsx {
@@ -293,17 +350,14 @@ static void move_towards_outside(const d_level_shared_segment_state &LevelShared
 //	like to say that it ensures that the object can move between the points, but that would require knowing what
 //	the object is (which isn't passed, right?) and making fvi calls (slow, right?).  So, consider it the more_or_less_safe_flag.
 //	If end_seg == -2, then end seg will never be found and this routine will drop out due to depth (probably called by create_n_segment_path).
+//	With a real end_seg, the search is A*: it follows the shortest route between segment centers, guided by the
+//	straight line distance to end_seg, instead of the route through the fewest segments.
 std::pair<create_path_result, unsigned> create_path_points(const vmobjptridx_t objp, const vcsegidx_t start_seg, icsegidx_t end_seg, point_seg_array_t::iterator psegs, const unsigned max_depth, create_path_random_flag random_flag, const create_path_safety_flag safety_flag, icsegidx_t avoid_seg)
 {
 #if defined(DXX_BUILD_DESCENT_II)
 	auto &Objects = LevelUniqueObjectState.Objects;
 	auto &vmobjptr = Objects.vmptr;
 #endif
-	segnum_t		cur_seg;
-	int		qtail = 0, qhead = 0;
-	int		i;
-	std::array<seg_seg, MAX_SEGMENTS> seg_queue;
-	int		cur_depth;
 	std::array<uint8_t, MAX_SIDES_PER_SEGMENT> random_xlate;
 	DXX_POISON_VAR(random_xlate, 0xcc);
 	point_seg_array_t::iterator	original_psegs = psegs;
@@ -319,30 +373,78 @@ if ((objp->type == OBJ_ROBOT) && (objp->ctype.ai_info.behavior == ai_behavior::A
 	// Int3();
 }
 
-	visited_segment_bitarray_t visited;
-	std::array<uint16_t, MAX_SEGMENTS> depth{};
+	auto &LevelSharedVertexState = LevelSharedSegmentState.get_vertex_state();
+	auto &Vertices = LevelSharedVertexState.get_vertices();
+	auto &vcvertptr = Vertices.vcptr;
+	auto &Walls = LevelUniqueWallSubsystemState.Walls;
+	auto &vcwallptr = Walls.vcptr;
 
+	start_path_search(Segments.get_count());
 	//	If there is a segment we're not allowed to visit, mark it.
 	if (avoid_seg != segment_none) {
 		Assert(avoid_seg <= Highest_segment_index);
 		if ((start_seg != avoid_seg) && (end_seg != avoid_seg)) {
-			visited[avoid_seg] = true;
+			auto &n = Path_nodes[avoid_seg];
+			n.generation = Path_generation;
+			n.closed = true;
+			//	No route is shorter, so it is never reopened.
+			n.depth = 0;
 		}
 	}
 
 	if (random_flag != create_path_random_flag::nonrandom)
 		create_random_xlate(random_xlate);
 
-	cur_seg = start_seg;
-	visited[cur_seg] = true;
-	cur_depth = 0;
-
-	auto &LevelSharedVertexState = LevelSharedSegmentState.get_vertex_state();
-	auto &Vertices = LevelSharedVertexState.get_vertices();
-	auto &vcvertptr = Vertices.vcptr;
-	auto &Walls = LevelUniqueWallSubsystemState.Walls;
-	auto &vcwallptr = Walls.vcptr;
-	while (cur_seg != end_seg) {
+	//	With a real goal, search A* style, by center to center distance
+	//	plus the straight line distance to the goal.  Without one
+	//	(create_n_segment_path), search by depth alone, which visits
+	//	segments in breadth first order.
+	const bool has_goal = IS_CHILD(end_seg);
+	vms_vector goal_center;
+	if (has_goal)
+		compute_segment_center(vcvertptr, goal_center, vcsegptr(end_seg));
+	const auto estimate = [has_goal, &goal_center](const vms_vector &center) -> fix {
+		return has_goal ? static_cast<fix>(vm_vec_dist_quick(center, goal_center)) : 0;
+	};
+
+	//	A limit of 0 has never stopped the search.  Segments at the limit
+	//	are not expanded.  A segment first reached by a long route may be
+	//	reached again by one with fewer steps, so it is then reopened,
+	//	since the shorter route may lead on past the limit.
+	const unsigned depth_limit = max_depth ? max_depth : UINT_MAX;
+	unsigned sequence = 0;
+	{
+		auto &n = Path_nodes[start_seg];
+		n.generation = Path_generation;
+		n.parent = segment_none;
+		n.depth = 0;
+		n.closed = false;
+		n.cost = 0;
+		compute_segment_center(vcvertptr, n.center, vcsegptr(start_seg));
+		n.estimate = estimate(n.center);
+		Path_open.push_back({n.estimate, sequence++, 0, start_seg});
+	}
+	//	If the goal cannot be reached, end the path at the segment that
+	//	came closest to it, or, without a goal, at the last one found.
+	segnum_t path_end = start_seg;
+	const path_open_order open_order;
+
+	while (!Path_open.empty()) {
+		std::pop_heap(Path_open.begin(), Path_open.end(), open_order);
+		const auto top = Path_open.back();
+		Path_open.pop_back();
+		const segnum_t cur_seg = top.segnum;
+		auto &cur = Path_nodes[cur_seg];
+		if (cur.closed || top.cost != cur.cost)
+			continue;
+		cur.closed = true;
+		if (cur_seg == end_seg)
+		{
+			path_end = cur_seg;
+			break;
+		}
+		if (cur.depth >= depth_limit)
+			continue;
 		const cscusegment &&segp = vcsegptr(cur_seg);
 #if defined(DXX_BUILD_DESCENT_II)
 		if (random_flag != create_path_random_flag::nonrandom)
@@ -362,76 +464,79 @@ if ((objp->type == OBJ_ROBOT) && (objp->ctype.ai_info.behavior == ai_behavior::A
 #define AI_DOOR_OPENABLE_PLAYER_FLAGS	player_info.powerup_flags,
 			auto &player_info = get_local_plrobj().ctype.player_info;
 #endif
-			if ((WALL_IS_DOORWAY(GameBitmaps, Textures, vcwallptr, segp, snum) & WALL_IS_DOORWAY_FLAG::fly) || ai_door_is_openable(objp, AI_DOOR_OPENABLE_PLAYER_FLAGS segp, snum))
+			if (!((WALL_IS_DOORWAY(GameBitmaps, Textures, vcwallptr, segp, snum) & WALL_IS_DOORWAY_FLAG::fly) || ai_door_is_openable(objp, AI_DOOR_OPENABLE_PLAYER_FLAGS segp, snum)))
+				continue;
 #undef AI_DOOR_OPENABLE_PLAYER_FLAGS
-			{
-				const auto this_seg = segp.s.children[snum];
-#if defined(DXX_BUILD_DESCENT_II)
-				Assert(this_seg != segment_none);
-				if (((cur_seg == avoid_seg) || (this_seg == avoid_seg)) && (ConsoleObject->segnum == avoid_seg)) {
-					fvi_query	fq;
-					fvi_info		hit_data;
-					int			hit_type;
-	
-					const auto &&center_point = compute_center_point_on_side(vcvertptr, segp, snum);
-
-					fq.p0						= &objp->pos;
-					fq.startseg				= objp->segnum;
-					fq.p1						= &center_point;
-					fq.rad					= objp->size;
-					fq.thisobjnum			= objp;
-					fq.ignore_obj_list.first = nullptr;
-					fq.flags					= 0;
-
-					hit_type = find_vector_intersection(fq, hit_data);
-					if (hit_type != HIT_NONE) {
-						goto dont_add;
-					}
-				}
-#endif
-
-				if (!visited[this_seg]) {
-					seg_queue[qtail].start = cur_seg;
-					seg_queue[qtail].end = this_seg;
-					visited[this_seg] = true;
-					depth[qtail++] = cur_depth+1;
-					if (depth[qtail-1] == max_depth) {
-						end_seg = seg_queue[qtail-1].end;
-						goto cpp_done1;
-					}	// end if (depth[...
-				}	// end if (!visited...
-			}	// if (WALL_IS_DOORWAY(...
+			const auto this_seg = segp.s.children[snum];
+			auto &n = Path_nodes[this_seg];
+			const bool found = (n.generation == Path_generation);
+			const unsigned depth = cur.depth + 1;
+			if (found && n.closed && depth >= n.depth)
+				continue;
 #if defined(DXX_BUILD_DESCENT_II)
-dont_add: ;
-#endif
-		}
-
-		if (qtail <= 0)
-			break;
-
-		if (qhead >= qtail) {
-			//	Couldn't get to goal, return a path as far as we got, which probably acceptable to the unparticular caller.
-			end_seg = seg_queue[qtail-1].end;
-			break;
-		}
+			Assert(this_seg != segment_none);
+			if (((cur_seg == avoid_seg) || (this_seg == avoid_seg)) && (ConsoleObject->segnum == avoid_seg)) {
+				fvi_query	fq;
+				fvi_info		hit_data;
+				int			hit_type;
 
-		cur_seg = seg_queue[qhead].end;
-		cur_depth = depth[qhead];
-		qhead++;
+				const auto &&center_point = compute_center_point_on_side(vcvertptr, segp, snum);
 
-cpp_done1: ;
-	}	//	while (cur_seg ...
+				fq.p0						= &objp->pos;
+				fq.startseg				= objp->segnum;
+				fq.p1						= &center_point;
+				fq.rad					= objp->size;
+				fq.thisobjnum			= objp;
+				fq.ignore_obj_list.first = nullptr;
+				fq.flags					= 0;
 
-	if (qtail > 0)
-	{
-		//	Set qtail to the segment which ends at the goal.
-		while (seg_queue[--qtail].end != end_seg)
-			if (qtail < 0) {
-				return std::make_pair(create_path_result::early, l_num_points);
+				hit_type = find_vector_intersection(fq, hit_data);
+				if (hit_type != HIT_NONE)
+					continue;
 			}
+#endif
+			if (!found)
+			{
+				n.generation = Path_generation;
+				n.closed = false;
+				compute_segment_center(vcvertptr, n.center, vcsegptr(this_seg));
+				n.estimate = estimate(n.center);
+			}
+			fix cost;
+			if (has_goal)
+			{
+				cost = vm_vec_dist_quick(cur.center, n.center);
+				//	Lengthen each step at random by up to a quarter, so
+				//	that a random path does not always take the same route.
+				if (random_flag != create_path_random_flag::nonrandom)
+					cost += fixmul(cost, d_rand() / 2);
+				cost += cur.cost;
+			}
+			else
+				cost = cur.depth + 1;
+			if (found && !(depth < n.depth || (cost < n.cost && depth == n.depth)))
+				continue;
+			n.parent = cur_seg;
+			n.closed = false;
+			n.depth = depth;
+			n.cost = cost;
+			Path_open.push_back({cost + n.estimate, sequence++, cost, this_seg});
+			std::push_heap(Path_open.begin(), Path_open.end(), open_order);
+			if (has_goal)
+			{
+				if (n.estimate < Path_nodes[path_end].estimate)
+					path_end = this_seg;
+			}
+			else
+			{
+				path_end = this_seg;
+				if (n.depth == depth_limit)
+					break;
+			}
+		}
+		if (!has_goal && Path_nodes[path_end].depth == depth_limit)
+			break;
 	}
-	else
-		qtail = -1;
 
 #if defined(DXX_BUILD_DESCENT_I)
 #if DXX_USE_EDITOR
@@ -439,47 +544,33 @@ cpp_done1: ;
 	#endif
 #endif
 
-	while (qtail >= 0) {
-		segnum_t	parent_seg, this_seg;
-
-		this_seg = seg_queue[qtail].end;
-		parent_seg = seg_queue[qtail].start;
+	//	Write the path from the start, so it needs no reversing.  A
+	//	reopened segment may not have been expanded again yet, so the
+	//	depth of the segments after it can be stale.  Count the points.
+	for (segnum_t this_seg = path_end; this_seg != start_seg; this_seg = Path_nodes[this_seg].parent)
+		++l_num_points;
+	++l_num_points;
+	psegs += l_num_points;
+	for (segnum_t this_seg = path_end;; this_seg = Path_nodes[this_seg].parent)
+	{
+		auto &n = Path_nodes[this_seg];
+		--psegs;
 		psegs->segnum = this_seg;
-		compute_segment_center(vcvertptr, psegs->point, vcsegptr(this_seg));
-		psegs++;
-		l_num_points++;
+		psegs->point = n.center;
+		if (this_seg == start_seg)
+			break;
 #if defined(DXX_BUILD_DESCENT_I)
 #if DXX_USE_EDITOR
 		Selected_segs.emplace_back(this_seg);
 		#endif
 #endif
-
-		if (parent_seg == start_seg)
-			break;
-
-		while (seg_queue[--qtail].end != parent_seg)
-			Assert(qtail >= 0);
 	}
-
-	psegs->segnum = start_seg;
-	compute_segment_center(vcvertptr, psegs->point, vcsegptr(start_seg));
-	psegs++;
-	l_num_points++;
+	psegs += l_num_points;
 
 #if PATH_VALIDATION
 	validate_path(1, original_psegs, l_num_points);
 #endif
 
-	//	Now, reverse point_segs in place.
-	for (i=0; i< l_num_points/2; i++) {
-		point_seg		temp_point_seg = *(original_psegs + i);
-		*(original_psegs + i) = *(original_psegs + l_num_points - i - 1);
-		*(original_psegs + l_num_points - i - 1) = temp_point_seg;
-	}
-#if PATH_VALIDATION
-	validate_path(2, original_psegs, l_num_points);
-#endif
-
 	//	Now, if safety_flag set, then insert the point at the center of the side connecting two segments
 	//	between the two points.  This is messy because we must insert into the list.  The simplest (and not too slow)
 	//	way to do this is to start at the end of the list and go backwards.
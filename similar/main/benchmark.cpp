@@ -0,0 +1,130 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+/*
+ *
+ * Headless demo playback benchmark.
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "benchmark.h"
+#include "console.h"
+#include "game.h"
+#include "gr.h"
+#include "newdemo.h"
+#include "profile.h"
+#include "render.h"
+#include "window.h"
+
+#if DXX_USE_OGL
+#include "ogl_init.h"
+#endif
+
+namespace dsx {
+
+namespace {
+
+using benchmark_clock = std::chrono::steady_clock;
+
+struct benchmark_series
+{
+	const char *const label;
+	std::vector<benchmark_clock::duration> samples;
+	benchmark_series(const char *const label, const unsigned reserve) :
+		label(label)
+	{
+		samples.reserve(reserve);
+	}
+};
+
+static double benchmark_ms(const benchmark_clock::duration d)
+{
+	return std::chrono::duration<double, std::milli>(d).count();
+}
+
+/* Reorders `samples`.  This is safe because each series is reported
+ * exactly once, after all frames have been measured.
+ */
+static benchmark_clock::duration benchmark_percentile(std::vector<benchmark_clock::duration> &samples, const unsigned percent)
+{
+	const auto nth = samples.begin() + (samples.size() - 1) * percent / 100;
+	std::nth_element(samples.begin(), nth, samples.end());
+	return *nth;
+}
+
+static void benchmark_report(benchmark_series &series)
+{
+	auto &samples = series.samples;
+	if (samples.empty())
+		return;
+	const auto minimum = *std::min_element(samples.begin(), samples.end());
+	const auto median = benchmark_percentile(samples, 50);
+	const auto p99 = benchmark_percentile(samples, 99);
+	con_printf(CON_NORMAL, "benchmark: %-6s min %8.3f ms  median %8.3f ms  p99 %8.3f ms", series.label, benchmark_ms(minimum), benchmark_ms(median), benchmark_ms(p99));
+}
+
+}
+
+unsigned benchmark_demo_playback(const char *const filename, const unsigned frames)
+{
+	newdemo_start_playback(filename);
+	if (Newdemo_state != ND_STATE_PLAYBACK)
+	{
+		con_printf(CON_URGENT, "benchmark: failed to start playback of \"%s\"", filename);
+		return 0;
+	}
+	/* Reserve for a half hour demo when no limit is given.  Longer
+	 * demos still work; they just reallocate.
+	 */
+	const unsigned reserve = std::min(frames, 30u * 60u * DESIGNATED_GAME_FPS);
+	benchmark_series simulate("sim", reserve), render("render", reserve), total("total", reserve);
+	const auto &&canvas = gr_create_canvas(SWIDTH, SHEIGHT);
+	window_rendered_data window;
+	unsigned frame = 0;
+	for (; frame < frames; ++frame)
+	{
+		const auto t0 = benchmark_clock::now();
+		/* During playback, object movement comes from the demo rather
+		 * than from physics or AI, so the simulation step is the
+		 * decoder plus the per-frame world updates in GameProcessFrame.
+		 */
+		const auto result = game_process_fixed_frame(DESIGNATED_GAME_FRAMETIME);
+		if (result == window_event_result::close || Newdemo_state != ND_STATE_PLAYBACK)
+			break;
+		const auto t1 = benchmark_clock::now();
+		render_frame(*canvas, 0, window);
+#if DXX_USE_OGL
+		/* Without a buffer swap, the driver may still be working on the
+		 * frame.  Wait for it so that the GPU cost is charged to this
+		 * frame.
+		 */
+		glFinish();
+#endif
+		const auto t2 = benchmark_clock::now();
+		simulate.samples.emplace_back(t1 - t0);
+		render.samples.emplace_back(t2 - t1);
+		total.samples.emplace_back(t2 - t0);
+		profile_end_frame();
+	}
+#if DXX_USE_OGL
+	const auto renderer = "OpenGL";
+#else
+	const auto renderer = "software";
+#endif
+	con_printf(CON_NORMAL, "benchmark: %u frames of \"%s\" at %ux%u (%s renderer)", frame, filename, static_cast<unsigned>(SWIDTH), static_cast<unsigned>(SHEIGHT), renderer);
+	benchmark_report(simulate);
+	benchmark_report(render);
+	benchmark_report(total);
+	if (Game_wind)
+		window_close(Game_wind);
+	return frame;
+}
+
+}
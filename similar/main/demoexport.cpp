@@ -0,0 +1,217 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+/*
+ *
+ * Offline demo export to images, raw video and raw sound.
+ *
+ * Each frame advances the demo by a fixed step instead of by the wall
+ * clock, so the export runs as fast as the frames can be drawn and
+ * written, and always produces the same frames for the same demo.
+ *
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "demoexport.h"
+#include "console.h"
+#include "digi_audio.h"
+#include "game.h"
+#include "gr.h"
+#include "kconfig.h"
+#include "newdemo.h"
+#include "palette.h"
+#include "physfsx.h"
+#include "window.h"
+
+#if DXX_USE_OGL
+#include "ogl_init.h"
+#endif
+
+#include "compiler-range_for.h"
+
+namespace dsx {
+
+namespace {
+
+struct export_file_close
+{
+	void operator()(FILE *const f) const
+	{
+		fclose(f);
+	}
+};
+
+using export_file = std::unique_ptr<FILE, export_file_close>;
+
+static export_file export_open(const std::string &path, const char *const what)
+{
+	if (path.empty())
+		return {};
+	export_file f(fopen(path.c_str(), "wb"));
+	if (!f)
+		con_printf(CON_URGENT, "export: failed to open %s output \"%s\": %s", what, path.c_str(), strerror(errno));
+	return f;
+}
+
+static bool export_write(const export_file &f, const std::vector<uint8_t> &data, const char *const what)
+{
+	if (fwrite(data.data(), 1, data.size(), f.get()) == data.size())
+		return true;
+	con_printf(CON_URGENT, "export: failed to write %s output: %s", what, strerror(errno));
+	return false;
+}
+
+#if !DXX_USE_OGL
+/* The software renderer draws palette indices, so the palette is read
+ * back for every frame, to include flashes and fades.  It is scaled
+ * to 8 bits per channel in the same way as a screenshot.
+ */
+static void export_read_palette(palette_array_t &pal)
+{
+	gr_palette_read(pal);
+	range_for (auto &i, pal)
+	{
+		i.r <<= 2;
+		i.g <<= 2;
+		i.b <<= 2;
+	}
+}
+#endif
+
+static void export_read_rgb(const grs_bitmap &screen, const palette_array_t &pal, std::vector<uint8_t> &rgb)
+{
+	const unsigned w = screen.bm_w, h = screen.bm_h, stride = w * 3;
+	rgb.resize(stride * h);
+#if DXX_USE_OGL
+	(void)pal;
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, w, h, GL_RGB, GL_UNSIGNED_BYTE, rgb.data());
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	/* OpenGL returns the bottom row first. */
+	for (auto top = rgb.begin(), bottom = rgb.end() - stride; top < bottom; top += stride, bottom -= stride)
+		std::swap_ranges(top, top + stride, bottom);
+#else
+	auto o = rgb.begin();
+	for (unsigned y = 0; y != h; ++y)
+	{
+		const auto row = &screen.bm_data[y * screen.bm_rowsize];
+		for (unsigned x = 0; x != w; ++x)
+		{
+			const auto &c = pal[row[x]];
+			*o++ = c.r;
+			*o++ = c.g;
+			*o++ = c.b;
+		}
+	}
+#endif
+}
+
+#if DXX_USE_SCREENSHOT_FORMAT_PNG
+static bool export_write_png(const std::string &dir, const unsigned frame, const grs_bitmap &screen, const palette_array_t &pal)
+{
+	char name[PATH_MAX];
+	snprintf(name, sizeof(name), "%s/%06u.png", dir.c_str(), frame);
+	const auto file = PHYSFSX_openWriteBuffered(name);
+	if (!file)
+	{
+		con_printf(CON_URGENT, "export: failed to open \"%s\" for writing", name);
+		return false;
+	}
+	if (write_screenshot_png(file, nullptr, screen, pal))
+	{
+		con_printf(CON_URGENT, "export: failed to write \"%s\"", name);
+		return false;
+	}
+	return true;
+}
+#endif
+
+}
+
+unsigned export_demo(const char *const filename, const unsigned fps, const std::string &png_dir, const std::string &video_path, const std::string &audio_path)
+{
+#if !DXX_USE_SCREENSHOT_FORMAT_PNG
+	if (!png_dir.empty())
+	{
+		con_puts(CON_URGENT, "export: this build cannot write PNG files");
+		return 0;
+	}
+#endif
+	if (png_dir.empty() && video_path.empty() && audio_path.empty())
+	{
+		con_puts(CON_URGENT, "export: no output given; use -export-png, -export-video or -export-audio");
+		return 0;
+	}
+	const auto video = export_open(video_path, "video");
+	const auto audio = export_open(audio_path, "audio");
+	if ((!video_path.empty() && !video) || (!audio_path.empty() && !audio))
+		return 0;
+	if (!png_dir.empty() && !PHYSFSX_exists(png_dir.c_str(), 0))
+		PHYSFS_mkdir(png_dir.c_str());
+	newdemo_start_playback(filename);
+	if (Newdemo_state != ND_STATE_PLAYBACK)
+	{
+		con_printf(CON_URGENT, "export: failed to start playback of \"%s\"", filename);
+		return 0;
+	}
+	const auto &screen = grd_curscreen->sc_canvas.cv_bitmap;
+	const unsigned sample_rate = audio ? digi_audio_get_sample_rate() : 0;
+	con_printf(CON_NORMAL, "export: \"%s\" at %ux%u, %u frames per second", filename, static_cast<unsigned>(screen.bm_w), static_cast<unsigned>(screen.bm_h), fps);
+	if (audio)
+		con_printf(CON_NORMAL, "export: sound is unsigned 8-bit stereo at %u Hz", sample_rate);
+#if DXX_USE_OGL && !DXX_USE_OGLES
+	/* Nothing is presented, so the frame is still in the back buffer. */
+	glReadBuffer(GL_BACK);
+#endif
+	palette_array_t pal;
+	std::vector<uint8_t> rgb, samples;
+	unsigned frame = 0;
+	for (;; ++frame)
+	{
+		/* Step by the exact share of each frame, so that the demo time,
+		 * like the sound, never drifts from the frame count.
+		 */
+		const fix frame_time = static_cast<fix>(uint64_t{frame + 1} * F1_0 / fps - uint64_t{frame} * F1_0 / fps);
+		const auto result = game_process_fixed_frame(frame_time);
+		if (result == window_event_result::close || Newdemo_state != ND_STATE_PLAYBACK)
+			break;
+		game_render_frame(Controls);
+#if !DXX_USE_OGL
+		export_read_palette(pal);
+#endif
+#if DXX_USE_SCREENSHOT_FORMAT_PNG
+		if (!png_dir.empty() && !export_write_png(png_dir, frame, screen, pal))
+			break;
+#endif
+		if (video)
+		{
+			export_read_rgb(screen, pal, rgb);
+			if (!export_write(video, rgb, "video"))
+				break;
+		}
+		if (audio)
+		{
+			const auto begin = uint64_t{frame} * sample_rate / fps;
+			const auto end = uint64_t{frame + 1} * sample_rate / fps;
+			samples.resize((end - begin) * 2);
+			digi_audio_mix_offline(samples.data(), samples.size());
+			if (!export_write(audio, samples, "audio"))
+				break;
+		}
+	}
+	con_printf(CON_NORMAL, "export: wrote %u frames of \"%s\"", frame, filename);
+	if (Game_wind)
+		window_close(Game_wind);
+	return frame;
+}
+
+}
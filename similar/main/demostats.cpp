@@ -0,0 +1,412 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+/*
+ *
+ * Statistics extracted from recorded demos, without rendering.
+ *
+ * A demo records only the objects that were drawn, so positions of
+ * other players are known only while the recording player could see
+ * them, and weapons are counted when they are first drawn.
+ *
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include "demostats.h"
+#include "console.h"
+#include "d_levelstate.h"
+#include "game.h"
+#include "newdemo.h"
+#include "object.h"
+#include "player.h"
+#include "strutil.h"
+#include "window.h"
+
+#include "compiler-range_for.h"
+
+namespace dsx {
+
+namespace {
+
+/* Signatures wrap, so a weapon that has not been drawn for this many
+ * frames is counted again when it next is.
+ */
+constexpr unsigned demo_stats_forget_frames = 30 * 20;
+
+enum class demo_stats_type : uint8_t
+{
+	kill,
+	death,
+	damage,
+	fire,
+	position,
+};
+
+static const char *demo_stats_type_name(const demo_stats_type type)
+{
+	switch (type)
+	{
+		case demo_stats_type::kill:
+			return "kill";
+		case demo_stats_type::death:
+			return "death";
+		case demo_stats_type::damage:
+			return "damage";
+		case demo_stats_type::fire:
+			return "fire";
+		case demo_stats_type::position:
+		default:
+			return "position";
+	}
+}
+
+/* For a fire row, `value` is the weapon id and there is no player.
+ * Only position rows have a segment and a position.
+ */
+struct demo_stats_row
+{
+	fix64 time;
+	demo_stats_type type;
+	int8_t player;
+	int value;
+	segnum_t segment;
+	vms_vector pos;
+};
+
+struct demo_stats_player
+{
+	callsign_t callsign;
+	int kills;
+	unsigned deaths;
+	unsigned damage;
+};
+
+struct demo_stats_collector
+{
+	fix64 time = 0;
+	fix64 next_position_time = 0;
+	unsigned frames = 0;
+	int shields = -1;
+	std::vector<demo_stats_row> rows;
+	std::array<demo_stats_player, MAX_PLAYERS> players{};
+	std::vector<unsigned> fired;
+	/* The frame, counted from 1, in which each signature was last
+	 * drawn as a weapon.
+	 */
+	std::vector<unsigned> weapon_last_seen = std::vector<unsigned>(1 << 16);
+	void add_events(const std::vector<newdemo_scan_event> &events);
+	void add_objects();
+};
+
+void demo_stats_collector::add_events(const std::vector<newdemo_scan_event> &events)
+{
+	range_for (const auto &e, events)
+	{
+		if (e.player >= MAX_PLAYERS)
+			continue;
+		auto &p = players[e.player];
+		const int8_t player = e.player;
+		switch (e.type)
+		{
+			case newdemo_scan_event::kind::kill:
+				p.kills += e.value;
+				rows.emplace_back(demo_stats_row{time, demo_stats_type::kill, player, e.value, segment_none, {}});
+				break;
+			case newdemo_scan_event::kind::death:
+				++p.deaths;
+				rows.emplace_back(demo_stats_row{time, demo_stats_type::death, player, 1, segment_none, {}});
+				break;
+			case newdemo_scan_event::kind::shields:
+				/* An increase is a pickup or a respawn, not damage. */
+				if (e.value < shields)
+				{
+					const auto damage = shields - e.value;
+					p.damage += damage;
+					rows.emplace_back(demo_stats_row{time, demo_stats_type::damage, player, damage, segment_none, {}});
+				}
+				shields = e.value;
+				break;
+		}
+	}
+}
+
+void demo_stats_collector::add_objects()
+{
+	auto &Objects = LevelUniqueObjectState.Objects;
+	auto &vcobjptr = Objects.vcptr;
+	++frames;
+	const bool sample_positions = time >= next_position_time;
+	if (sample_positions)
+		next_position_time = time + F1_0;
+	/* A player can be in the frame twice: once as the viewer, and once
+	 * as an object in another view.
+	 */
+	std::array<bool, MAX_PLAYERS> sampled{};
+	range_for (const auto &&objp, vcobjptr)
+	{
+		const object &obj = *objp;
+		if (obj.type == OBJ_WEAPON)
+		{
+			auto &last_seen = weapon_last_seen[static_cast<uint16_t>(obj.signature)];
+			if (!last_seen || frames - last_seen > demo_stats_forget_frames)
+			{
+				const unsigned id = get_weapon_id(obj);
+				if (fired.size() <= id)
+					fired.resize(id + 1);
+				++fired[id];
+				rows.emplace_back(demo_stats_row{time, demo_stats_type::fire, -1, static_cast<int>(id), segment_none, {}});
+			}
+			last_seen = frames;
+		}
+		else if (sample_positions && obj.type == OBJ_PLAYER)
+		{
+			const auto pnum = get_player_id(obj);
+			if (pnum >= MAX_PLAYERS || sampled[pnum])
+				continue;
+			sampled[pnum] = true;
+			rows.emplace_back(demo_stats_row{time, demo_stats_type::position, static_cast<int8_t>(pnum), 0, obj.segnum, obj.pos});
+		}
+	}
+	for (unsigned i = 0; i < N_players && i < MAX_PLAYERS; ++i)
+		players[i].callsign = vcplayerptr(i)->callsign;
+}
+
+static double demo_stats_seconds(const fix64 time)
+{
+	return static_cast<double>(time) / F1_0;
+}
+
+/* Callsigns are the only free text, and may hold any byte. */
+static void demo_stats_append_json_string(std::string &out, const char *s)
+{
+	out += '"';
+	for (; const uint8_t c = *s; ++s)
+	{
+		if (c == '"' || c == '\\')
+		{
+			out += '\\';
+			out += c;
+		}
+		else if (c < 0x20 || c >= 0x7f)
+		{
+			char escape[8];
+			snprintf(escape, sizeof(escape), "\\u%04x", c);
+			out += escape;
+		}
+		else
+			out += c;
+	}
+	out += '"';
+}
+
+template <typename... Args>
+static void demo_stats_printf(std::string &out, const char *const format, Args... args)
+{
+	char buf[256];
+	const auto len = snprintf(buf, sizeof(buf), format, args...);
+	if (len > 0)
+		out.append(buf, std::min<std::size_t>(len, sizeof(buf) - 1));
+}
+
+static std::string demo_stats_json(const char *const filename, const demo_stats_collector &c)
+{
+	std::string out;
+	out += "{\n\t\"demo\": ";
+	demo_stats_append_json_string(out, filename);
+	demo_stats_printf(out, ",\n\t\"frames\": %u,\n\t\"seconds\": %.3f,\n\t\"players\": [", c.frames, demo_stats_seconds(c.time));
+	const char *separator = "\n";
+	for (unsigned i = 0; i < N_players && i < MAX_PLAYERS; ++i)
+	{
+		auto &p = c.players[i];
+		demo_stats_printf(out, "%s\t\t{\"player\": %u, \"callsign\": ", separator, i);
+		demo_stats_append_json_string(out, static_cast<const char *>(p.callsign));
+		demo_stats_printf(out, ", \"kills\": %i, \"deaths\": %u, \"damage\": %u}", p.kills, p.deaths, p.damage);
+		separator = ",\n";
+	}
+	out += "\n\t],\n\t\"weapons\": [";
+	separator = "\n";
+	for (unsigned id = 0; id < c.fired.size(); ++id)
+		if (const auto fired = c.fired[id])
+		{
+			demo_stats_printf(out, "%s\t\t{\"weapon\": %u, \"fired\": %u}", separator, id, fired);
+			separator = ",\n";
+		}
+	out += "\n\t],\n\t\"events\": [";
+	separator = "\n";
+	range_for (auto &r, c.rows)
+		if (r.type != demo_stats_type::position)
+		{
+			demo_stats_printf(out, "%s\t\t{\"time\": %.3f, \"type\": \"%s\", ", separator, demo_stats_seconds(r.time), demo_stats_type_name(r.type));
+			if (r.type == demo_stats_type::fire)
+				demo_stats_printf(out, "\"weapon\": %i}", r.value);
+			else
+				demo_stats_printf(out, "\"player\": %i, \"value\": %i}", r.player, r.value);
+			separator = ",\n";
+		}
+	out += "\n\t],\n\t\"positions\": [";
+	separator = "\n";
+	range_for (auto &r, c.rows)
+		if (r.type == demo_stats_type::position)
+		{
+			demo_stats_printf(out, "%s\t\t{\"time\": %.3f, \"player\": %i, \"segment\": %u, \"x\": %.2f, \"y\": %.2f, \"z\": %.2f}", separator, demo_stats_seconds(r.time), r.player, static_cast<unsigned>(r.segment), f2fl(r.pos.x), f2fl(r.pos.y), f2fl(r.pos.z));
+			separator = ",\n";
+		}
+	out += "\n\t]\n}\n";
+	return out;
+}
+
+/* One row per event and per position sample, in demo order.  The
+ * totals are left to whatever reads the file.
+ */
+static std::string demo_stats_csv(const demo_stats_collector &c)
+{
+	std::string out = "time,type,player,value,segment,x,y,z\n";
+	range_for (auto &r, c.rows)
+	{
+		demo_stats_printf(out, "%.3f,%s,", demo_stats_seconds(r.time), demo_stats_type_name(r.type));
+		if (r.player >= 0)
+			demo_stats_printf(out, "%i", r.player);
+		if (r.type == demo_stats_type::position)
+			demo_stats_printf(out, ",,%u,%.2f,%.2f,%.2f\n", static_cast<unsigned>(r.segment), f2fl(r.pos.x), f2fl(r.pos.y), f2fl(r.pos.z));
+		else
+			demo_stats_printf(out, ",%i,,,,\n", r.value);
+	}
+	return out;
+}
+
+static bool demo_stats_one(const char *const filename, const bool csv)
+{
+	newdemo_start_playback(filename);
+	if (Newdemo_state != ND_STATE_PLAYBACK)
+	{
+		con_printf(CON_URGENT, "demo-stats: failed to start playback of \"%s\"", filename);
+		return false;
+	}
+	demo_stats_collector c;
+	std::vector<newdemo_scan_event> events;
+	for (;;)
+	{
+		fix frame_time;
+		const bool more = newdemo_read_next_frame(frame_time, events);
+		c.add_events(events);
+		events.clear();
+		/* After the last frame, the objects are not a whole frame. */
+		if (!more)
+			break;
+		c.add_objects();
+		c.time += frame_time;
+	}
+	if (Game_wind)
+		window_close(Game_wind);
+	std::string name(DEMO_DIR);
+	name += filename;
+	const auto dot = name.rfind('.');
+	if (dot != std::string::npos && dot > name.rfind('/') && !d_stricmp(&name[dot + 1], DEMO_EXT))
+		name.erase(dot);
+	name += csv ? ".csv" : ".json";
+	const auto out = csv ? demo_stats_csv(c) : demo_stats_json(filename, c);
+	const auto file = PHYSFSX_openWriteBuffered(name.c_str());
+	if (!file || PHYSFS_write(file, out.data(), 1, out.size()) != out.size())
+	{
+		con_printf(CON_URGENT, "demo-stats: failed to write \"%s\"", name.c_str());
+		return false;
+	}
+	con_printf(CON_NORMAL, "demo-stats: wrote %u frames of \"%s\" to \"%s\"", c.frames, filename, name.c_str());
+	return true;
+}
+
+static void demo_stats_append_argument(std::string &command, const char *const arg)
+{
+	if (!command.empty())
+		command += ' ';
+#ifdef _WIN32
+	command += '"';
+	for (auto p = arg; *p; ++p)
+	{
+		if (*p == '"')
+			command += '\\';
+		command += *p;
+	}
+	command += '"';
+#else
+	command += '\'';
+	for (auto p = arg; *p; ++p)
+	{
+		if (*p == '\'')
+			command += "'\\''";
+		else
+			command += *p;
+	}
+	command += '\'';
+#endif
+}
+
+}
+
+unsigned demo_stats(const std::vector<std::string> &demos, unsigned jobs, const bool csv, const int argc, char **const argv)
+{
+	if (demos.size() == 1)
+		return demo_stats_one(demos.front().c_str(), csv);
+	std::string base;
+	demo_stats_append_argument(base, argv[0]);
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!d_stricmp(argv[i], "-demo-stats") || !d_stricmp(argv[i], "-demo-stats-child") || !d_stricmp(argv[i], "-demo-stats-jobs"))
+		{
+			++i;
+			continue;
+		}
+		demo_stats_append_argument(base, argv[i]);
+	}
+	/* Each copy rereads the ini files.  -demo-stats-child makes it read
+	 * only its own demo, so that a -demo-stats list there cannot make
+	 * it start copies of its own.
+	 */
+	demo_stats_append_argument(base, "-demo-stats-child");
+	if (!jobs)
+		jobs = std::max(std::thread::hardware_concurrency(), 1u);
+	jobs = std::min<std::size_t>(jobs, demos.size());
+	con_printf(CON_NORMAL, "demo-stats: reading %u demos, %u at a time", static_cast<unsigned>(demos.size()), jobs);
+	/* The console is not thread safe, so the workers only record the
+	 * exit status of each copy, and it is reported after they finish.
+	 */
+	std::vector<int> status(demos.size());
+	std::atomic<std::size_t> next{0};
+	std::vector<std::thread> workers;
+	workers.reserve(jobs);
+	for (unsigned j = 0; j < jobs; ++j)
+		workers.emplace_back([&]() {
+			for (std::size_t i; (i = next++) < demos.size();)
+			{
+				auto command = base;
+				demo_stats_append_argument(command, demos[i].c_str());
+#ifdef _WIN32
+				/* cmd.exe strips the outer quotes of the command line. */
+				command = '"' + command + '"';
+#endif
+				status[i] = std::system(command.c_str());
+			}
+		});
+	range_for (auto &w, workers)
+		w.join();
+	unsigned read = 0;
+	for (std::size_t i = 0; i < demos.size(); ++i)
+	{
+		if (!status[i])
+			++read;
+		else
+			con_printf(CON_URGENT, "demo-stats: failed to read \"%s\" (status %i)", demos[i].c_str(), status[i]);
+	}
+	con_printf(CON_NORMAL, "demo-stats: read %u of %u demos", read, static_cast<unsigned>(demos.size()));
+	return read;
+}
+
+}
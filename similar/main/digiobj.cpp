@@ -42,6 +42,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "kconfig.h"
 #include "config.h"
 
+#include "profile.h"
 #include "compiler-range_for.h"
 #include "d_levelstate.h"
 #include <iterator>
@@ -540,6 +541,7 @@ static int was_recording = 0;
 
 void digi_sync_sounds()
 {
+	const profile_scope profile{profile_zone::digi_sync_sounds};
 	int oldvolume, oldpan;
 
 	if ( Newdemo_state == ND_STATE_RECORDING)	{
@@ -25,6 +25,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 
 #include <algorithm>
 #include <numeric>
+#include <vector>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -124,6 +125,55 @@ static bool can_collide(const object *const weapon_object, const object_base &it
 	}
 }
 
+//	Return, in ascending object number order, every object in a segment
+//	that might be within `maxdistance` of `position`.  Segments are reached
+//	only through their connections to `start`, and a segment is entered
+//	only if its bounding sphere overlaps the blast.  Walls are ignored
+//	here, because transparent walls do not block the blast.  The damage
+//	test uses vm_vec_dist_quick, which can understate a distance by up to
+//	about a tenth, so the blast radius here is padded by an eighth.  An
+//	object that the blast can see is never missed, since the line of
+//	sight to it stays inside the padded radius.
+//	Visiting the objects in object number order matches the order of a
+//	scan of every object, so the damage pass uses the same d_rand() calls.
+static std::vector<objnum_t> find_objects_near_explosion(const vcsegidx_t start, const vms_vector &position, const fix maxdistance)
+{
+	auto &LevelSharedVertexState = LevelSharedSegmentState.get_vertex_state();
+	auto &Vertices = LevelSharedVertexState.get_vertices();
+	auto &vcvertptr = Vertices.vcptr;
+	auto &Objects = LevelUniqueObjectState.Objects;
+	auto &vcobjptridx = Objects.vcptridx;
+	std::vector<objnum_t> result;
+	std::vector<segnum_t> seg_queue;
+	visited_segment_bitarray_t visited;
+	const vm_distance reach{maxdistance + maxdistance / 8};
+	seg_queue.emplace_back(start);
+	visited[start] = true;
+	for (std::size_t qhead = 0; qhead != seg_queue.size(); ++qhead)
+	{
+		const auto &&segp = vcsegptr(seg_queue[qhead]);
+		range_for (const auto objp, objects_in(segp, vcobjptridx, vcsegptr))
+			result.emplace_back(objp);
+		range_for (const auto child, segp->children)
+		{
+			if (!IS_CHILD(child))
+				continue;
+			if (visited[child])
+				continue;
+			visited[child] = true;
+			const shared_segment &childp = vcsegptr(child);
+			const auto center = compute_segment_center(vcvertptr, childp);
+			vm_distance radius{};
+			range_for (const auto v, childp.verts)
+				radius = std::max(radius, vm_vec_dist(center, vcvertptr(v)));
+			if (vm_vec_dist(center, position) < reach + radius)
+				seg_queue.emplace_back(child);
+		}
+	}
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
 static imobjptridx_t object_create_explosion_sub(const d_vclip_array &Vclip, fvmobjptridx &vmobjptridx, const imobjptridx_t obj_explosion_origin, const vmsegptridx_t segnum, const vms_vector &position, const fix size, const int vclip_type, const fix maxdamage, const fix maxdistance, const fix maxforce, const icobjptridx_t parent)
 {
 	/* `obj_explosion_origin` may not be a weapon in some cases, though
@@ -154,8 +204,9 @@ static imobjptridx_t object_create_explosion_sub(const d_vclip_array &Vclip, fvm
 		fix damage;
 		// -- now legal for badass explosions on a wall. Assert(obj_explosion_origin != NULL);
 
-		range_for (const auto &&obj_iter, vmobjptridx)
+		range_for (const auto nearby_objnum, find_objects_near_explosion(segnum, obj_fireball->pos, maxdistance))
 		{
+			const auto &&obj_iter = vmobjptridx(nearby_objnum);
 			//	Weapons used to be affected by badass explosions, but this introduces serious problems.
 			//	When a smart bomb blows up, if one of its children goes right towards a nearby wall, it will
 			//	blow up, blowing up all the children.  So I remove it.  MK, 09/11/94
@@ -395,7 +446,7 @@ static void object_create_debris(fvmsegptridx &vmsegptridx, const object_base &p
 	const auto &&obj = obj_create(OBJ_DEBRIS, 0, vmsegptridx(parent.segnum), parent.pos, &parent.orient, Polygon_models[parent.rtype.pobj_info.model_num].submodel_rads[subobj_num],
 				object::control_type::debris, object::movement_type::physics, RT_POLYOBJ);
 
-	if ((obj == object_none ) && (Highest_object_index >= MAX_OBJECTS-1)) {
+	if ((obj == object_none ) && (Highest_object_index >= LevelUniqueObjectState.object_limit - 1)) {
 //		Int3(); // this happens often and is normal :-)
 		return;
 	}
@@ -1311,7 +1362,7 @@ void do_explosion_sequence(object &obj)
 			explode_model(del_obj);		//explode a polygon model
 
 		//set some parm in explosion
-		//If num_objects < MAX_USED_OBJECTS, expl_obj could be set to dead before this setting causing the delete_obj not to be removed. If so, directly delete del_obj
+		//If num_objects < the limit less RESERVED_OBJECT_SLOTS, expl_obj could be set to dead before this setting causing the delete_obj not to be removed. If so, directly delete del_obj
 		if (expl_obj && !(expl_obj->flags & OF_SHOULD_BE_DEAD))
 		{
 			if (del_obj->movement_source == object::movement_type::physics) {
@@ -41,6 +41,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "robot.h"
 #include "piggy.h"
 #include "player.h"
+#include "profile.h"
 #include "compiler-range_for.h"
 #include "d_levelstate.h"
 #include "segiter.h"
@@ -634,6 +635,7 @@ static int fvi_sub(vms_vector &intp, segnum_t &ints, const vms_vector &p0, const
 //Returns the hit_data->hit_type
 int find_vector_intersection(const fvi_query &fq, fvi_info &hit_data)
 {
+	const profile_scope profile{profile_zone::find_vector_intersection};
 	auto &LevelSharedVertexState = LevelSharedSegmentState.get_vertex_state();
 	auto &Objects = LevelUniqueObjectState.Objects;
 	auto &Vertices = LevelSharedVertexState.get_vertices();
@@ -114,6 +114,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "d_enumerate.h"
 #include "d_levelstate.h"
 #include "d_range.h"
+#include "profile.h"
 #include "compiler-range_for.h"
 #include "partial_range.h"
 #include "segiter.h"
@@ -777,7 +778,11 @@ void record_screenshot_text_metadata(png_struct *const png_ptr, png_info *const
 	png_set_text(png_ptr, info_ptr, text_fields.data(), idx);
 }
 #endif
+#endif
+
+}
 
+#if DXX_USE_SCREENSHOT_FORMAT_PNG
 #if DXX_USE_OGL
 #define write_screenshot_png(F,T,B,P)	write_screenshot_png(F,T,B)
 #endif
@@ -878,8 +883,6 @@ unsigned write_screenshot_png(PHYSFS_File *const file, const struct tm *const tm
 }
 #endif
 
-}
-
 #if DXX_USE_SCREENSHOT
 void save_screen_shot(int automap_flag)
 {
@@ -1039,6 +1042,22 @@ static void do_cloak_stuff(void)
 	}
 }
 
+//	------------------------------------------------------------------------------------
+/* The protocol has no slot for a host that does not play, so a dedicated
+ * host still has a player and an object.  Keep the object a ghost, as a
+ * dead player's is, so that it is not drawn, is not hit and does not
+ * count when a spawn point is chosen.  The other players learn from the
+ * game flags that the host is a ghost.
+ */
+static void do_dedicated_host_stuff(object &plrobj)
+{
+	if (plrobj.type == OBJ_GHOST)
+		return;
+	plrobj.type = OBJ_GHOST;
+	plrobj.render_type = RT_NONE;
+	plrobj.movement_source = object::movement_type::None;
+}
+
 //	------------------------------------------------------------------------------------
 static void do_invulnerable_stuff(player_info &player_info)
 {
@@ -1505,6 +1524,8 @@ void show_netgame_help()
 	DXX_MENUITEM(VERB, TEXT, "SHIFT-LEFT\t  FAST BACKWARD", DEMOHELP_FAST_BACKWARD)	\
 	DXX_MENUITEM(VERB, TEXT, "CTRL-RIGHT\t  JUMP TO END", DEMOHELP_JUMP_END)	\
 	DXX_MENUITEM(VERB, TEXT, "CTRL-LEFT\t  JUMP TO START", DEMOHELP_JUMP_START)	\
+	DXX_MENUITEM(VERB, TEXT, "PAGE DOWN\t  JUMP 30 SECONDS FORWARD", DEMOHELP_SEEK_FORWARD)	\
+	DXX_MENUITEM(VERB, TEXT, "PAGE UP\t  JUMP 30 SECONDS BACKWARD", DEMOHELP_SEEK_BACKWARD)	\
 	_DXX_HELP_MENU_HINT_CMD_KEY(VERB, DEMOHELP)	\
 
 enum {
@@ -1755,7 +1776,7 @@ window_event_result game_window::event_handler(const d_event &event)
 				result = GameProcessFrame();
 			}
 
-			if (!Automap_active)		// efficiency hack
+			if (!Automap_active && !CGameArg.MplDedicated)		// efficiency hack
 			{
 				if (force_cockpit_redraw) {			//screen need redrawing?
 					init_cockpit();
@@ -1763,6 +1784,7 @@ window_event_result game_window::event_handler(const d_event &event)
 				}
 				game_render_frame(Controls);
 			}
+			profile_end_frame();
 			break;
 
 		case EVENT_WINDOW_CLOSE:
@@ -1783,6 +1805,8 @@ window_event_result game_window::event_handler(const d_event &event)
 #if DXX_USE_EDITOR
 			if (!EditorWindow)		// have to do it this way because of the necessary longjmp. Yuck.
 #endif
+			/* A dedicated host exits when its game ends. */
+			if (!CGameArg.MplDedicated)
 				show_menus();
 			event_toggle_focus(0);
 			key_toggle_repeat(1);
@@ -1897,6 +1921,7 @@ namespace {
 
 window_event_result GameProcessFrame()
 {
+	const profile_scope profile{profile_zone::game_process_frame};
 	auto &LevelUniqueControlCenterState = LevelUniqueObjectState.ControlCenterState;
 	auto &Objects = LevelUniqueObjectState.Objects;
 	auto &vmobjptr = Objects.vmptr;
@@ -1911,6 +1936,8 @@ window_event_result GameProcessFrame()
 	update_player_stats();
 	diminish_palette_towards_normal();		//	Should leave palette effect up for as long as possible by putting right before render.
 	do_afterburner_stuff(Objects);
+	if (CGameArg.MplDedicated && (Game_mode & GM_NETWORK))
+		do_dedicated_host_stuff(plrobj);
 	do_cloak_stuff();
 	do_invulnerable_stuff(player_info);
 #if defined(DXX_BUILD_DESCENT_II)
@@ -2072,6 +2099,18 @@ window_event_result GameProcessFrame()
 
 }
 
+/* Advance the world by exactly `frame_time`, without consulting the
+ * wall clock.  This lets a caller replay a demo deterministically,
+ * regardless of how quickly the host can render.
+ */
+window_event_result game_process_fixed_frame(const fix frame_time)
+{
+	FrameTime = frame_time;
+	GameTime64 += frame_time;
+	calc_d_tick();
+	return GameProcessFrame();
+}
+
 #if defined(DXX_BUILD_DESCENT_II)
 void compute_slide_segs()
 {
@@ -223,6 +223,9 @@ namespace {
 
 static fix64 newdemo_single_frame_time;
 
+// 30 seconds of a demo recorded at the full 20 frames per second
+constexpr int demo_seek_frames = 30 * 20;
+
 static void update_vcr_state(void)
 {
 	if ((keyd_pressed[KEY_LSHIFT] || keyd_pressed[KEY_RSHIFT]) && keyd_pressed[KEY_RIGHT] && d_tick_step)
@@ -651,6 +654,10 @@ static window_event_result HandleDemoKey(int key)
 		case KEY_CTRLED + KEY_LEFT:
 			return newdemo_goto_beginning();
 			break;
+		case KEY_PAGEDOWN:
+			return newdemo_seek_frames(demo_seek_frames);
+		case KEY_PAGEUP:
+			return newdemo_seek_frames(-demo_seek_frames);
 
 		KEY_MAC(case KEY_COMMAND+KEY_P:)
 		case KEY_PAUSE:
@@ -56,8 +56,10 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "gameseq.h"
 #include "args.h"
 #include "object.h"
+#include "profile.h"
 
 #include "compiler-range_for.h"
+#include "d_enumerate.h"
 #include "d_levelstate.h"
 #include "d_range.h"
 
@@ -171,6 +173,27 @@ static void show_framerate(grs_canvas &canvas)
 	gr_string(canvas, game_font, FSPACX(318) - w, bm_h - line_displacement, buf, w, h);
 }
 
+/* Start below the lines drawn by -renderstats, so that both can be
+ * shown at once.
+ */
+static void show_profile(grs_canvas &canvas)
+{
+	const auto &game_font = *GAME_FONT;
+	gr_set_fontcolor(canvas, BM_XRGB(0, 31, 0), -1);
+	const auto &&fspacx2 = FSPACX(2);
+	const auto &&line_spacing = LINE_SPACING(game_font, game_font);
+	auto y = FSPACY(1) + (line_spacing * 4);
+	const auto &average = profile_average_frame();
+	range_for (auto &&e, enumerate(average.zones))
+	{
+		const auto ms = std::chrono::duration<double, std::milli>(e.value.elapsed).count();
+		gr_printf(canvas, game_font, fspacx2, y, "%s %.2fms (%u)", profile_zone_label(static_cast<profile_zone>(e.idx)), ms, e.value.calls);
+		y += line_spacing;
+	}
+	if (average.dropped)
+		gr_printf(canvas, game_font, fspacx2, y, "%u events dropped", average.dropped);
+}
+
 }
 
 }
@@ -448,6 +471,9 @@ static void game_draw_hud_stuff(grs_canvas &canvas, const control_info &Controls
 	if (CGameCfg.FPSIndicator && PlayerCfg.CockpitMode[1] != CM_REAR_VIEW)
 		show_framerate(canvas);
 
+	if (profile_active)
+		show_profile(canvas);
+
 	if (Newdemo_state == ND_STATE_PLAYBACK)
 		Game_mode = Newdemo_game_mode;
 
@@ -782,6 +808,10 @@ void game_render_frame_mono(const control_info &Controls)
 
 	gr_set_current_canvas(Screen_3d_window);
 #if defined(DXX_BUILD_DESCENT_II)
+	/* The main view and the extra views build their segment lists
+	 * together, at the start of the frame.
+	 */
+	const render_view_prefetch_scope prefetch;
 	auto &Objects = LevelUniqueObjectState.Objects;
 	auto &vmobjptr = Objects.vmptr;
 	if (const auto &&gimobj = (
@@ -994,6 +1024,8 @@ void show_boxed_message(const char *msg, int RenderFlag)
 	int w,h;
 	int x,y;
 	
+	if (CGameArg.MplDedicated)
+		return;
 	gr_set_default_canvas();
 	auto &canvas = *grd_curcanv;
 	gr_set_fontcolor(canvas, BM_XRGB(31, 31, 31), -1);
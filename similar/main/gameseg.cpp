@@ -25,9 +25,11 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 
 #include <algorithm>
 #include <cassert>
+#include <climits>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>	//	for memset()
+#include <vector>
 
 #include "u_mem.h"
 #include "inferno.h"
@@ -92,7 +94,6 @@ struct verts_for_normal
 	bool negate_flag;
 };
 
-constexpr vm_distance fcd_abort_cache_value{F1_0 * 1000};
 constexpr vm_distance fcd_abort_return_value{-1};
 
 }
@@ -774,65 +775,167 @@ icsegptridx_t find_point_seg(const d_level_shared_segment_state &LevelSharedSegm
 #define	MAX_LOC_POINT_SEGS	64
 
 namespace dsx {
-#if defined(DXX_BUILD_DESCENT_I)
-static inline void add_to_fcd_cache(int seg0, int seg1, int depth, vm_distance dist)
-{
-	(void)(seg0||seg1||depth||dist);
-}
-#elif defined(DXX_BUILD_DESCENT_II)
-#define	MIN_CACHE_FCD_DIST	(F1_0*80)	//	Must be this far apart for cache lookup to succeed.  Recognizes small changes in distance matter at small distances.
-#define	MAX_FCD_CACHE	8
 
 namespace {
 
-struct fcd_data {
-	segnum_t	seg0, seg1;
-	int csd;
-	vm_distance dist;
+/* A breadth first search from one segment, through the sides that pass
+ * one `wid_flag`, kept between calls to find_connected_distance.  The
+ * search advances only as far as a query needs, and visits segments in
+ * the order a fresh search from the same segment would, so each query
+ * gets exactly the path, and the same abort, that its own search would
+ * have found.  Sound, the most frequent caller, always searches from the
+ * listener's segment, so most queries are answered from nodes that an
+ * earlier query already reached.
+ */
+class fcd_search
+{
+	struct node
+	{
+		unsigned generation;
+		/* Position in `queue`.  The search has finished with every
+		 * segment before it when it looks at this one.
+		 */
+		unsigned order;
+		uint16_t depth;
+		segnum_t parent, first_hop;
+		/* The center to center distance from `first_hop` to here. */
+		vm_distance hops;
+		vms_vector center;
+	};
+	std::vector<node> nodes;
+	std::vector<segnum_t> queue;
+	/* For each depth, the position in `queue` of the first segment at
+	 * that depth that led to a new segment, or UINT_MAX.
+	 */
+	std::vector<unsigned> first_expanding;
+	unsigned processed = 0;
+	unsigned generation = 0;
+	bool process_next(fvcvertptr &vcvertptr, fvcwallptr &vcwallptr);
+public:
+	segnum_t seg0 = segment_none;
+	WALL_IS_DOORWAY_mask_t wid_flag{};
+	unsigned last_used = 0;
+	/* The number of segments when the search started.  The editor adds
+	 * and removes segments without loading a level.
+	 */
+	std::size_t segment_count = 0;
+	void start(fvcvertptr &vcvertptr, vcsegptridx_t seg0, WALL_IS_DOORWAY_mask_t wid_flag);
+	vm_distance find(fvcvertptr &vcvertptr, fvcwallptr &vcwallptr, const vms_vector &p0, const vms_vector &p1, vcsegidx_t seg1, int max_depth);
 };
 
-}
+#define	MAX_FCD_SEARCHES	4
 
-int	Fcd_index = 0;
-static std::array<fcd_data, MAX_FCD_CACHE> Fcd_cache;
-fix64	Last_fcd_flush_time;
+static std::array<fcd_search, MAX_FCD_SEARCHES> Fcd_searches;
+static unsigned Fcd_use_count;
+static fix64 Last_fcd_flush_time;
 
-//	----------------------------------------------------------------------------------------------------------
-void flush_fcd_cache(void)
+void fcd_search::start(fvcvertptr &vcvertptr, const vcsegptridx_t s, const WALL_IS_DOORWAY_mask_t w)
 {
-	Fcd_index = 0;
-
-	range_for (auto &i, Fcd_cache)
-		i.seg0 = segment_none;
+	if (nodes.size() < Segments.get_count())
+		nodes.resize(Segments.get_count());
+	if (!++generation)
+	{
+		range_for (auto &n, nodes)
+			n.generation = 0;
+		generation = 1;
+	}
+	seg0 = s;
+	wid_flag = w;
+	segment_count = Segments.get_count();
+	queue.clear();
+	queue.emplace_back(s);
+	first_expanding.clear();
+	processed = 0;
+	auto &n = nodes[s];
+	n.generation = generation;
+	n.order = 0;
+	n.depth = 0;
+	n.parent = n.first_hop = segment_none;
+	n.hops = {};
+	compute_segment_center(vcvertptr, n.center, s);
+}
+
+bool fcd_search::process_next(fvcvertptr &vcvertptr, fvcwallptr &vcwallptr)
+{
+	if (processed == queue.size())
+		return false;
+	const auto cur_seg = queue[processed];
+	const auto &cur = nodes[cur_seg];
+	const cscusegment segp = *vmsegptr(cur_seg);
+	bool expanded = false;
+	for (int sidenum = 0; sidenum < MAX_SIDES_PER_SEGMENT; sidenum++)
+	{
+		const auto this_seg = segp.s.children[sidenum];
+		if (!IS_CHILD(this_seg))
+			continue;
+		if (!wid_flag.value || (WALL_IS_DOORWAY(GameBitmaps, Textures, vcwallptr, segp, sidenum) & wid_flag))
+		{
+			auto &n = nodes[this_seg];
+			if (n.generation == generation)
+				continue;
+			n.generation = generation;
+			n.order = queue.size();
+			n.depth = cur.depth + 1;
+			n.parent = cur_seg;
+			compute_segment_center(vcvertptr, n.center, vcsegptr(this_seg));
+			if (cur.depth)
+			{
+				n.first_hop = cur.first_hop;
+				n.hops = cur.hops + vm_vec_dist_quick(cur.center, n.center);
+			}
+			else
+			{
+				n.first_hop = this_seg;
+				n.hops = {};
+			}
+			queue.emplace_back(this_seg);
+			expanded = true;
+		}
+	}
+	if (expanded)
+	{
+		if (first_expanding.size() <= cur.depth)
+			first_expanding.resize(cur.depth + 1, UINT_MAX);
+		auto &f = first_expanding[cur.depth];
+		if (f == UINT_MAX)
+			f = processed;
+	}
+	++processed;
+	return true;
 }
 
-namespace {
-//	----------------------------------------------------------------------------------------------------------
-static void add_to_fcd_cache(int seg0, int seg1, int depth, vm_distance dist)
+vm_distance fcd_search::find(fvcvertptr &vcvertptr, fvcwallptr &vcwallptr, const vms_vector &p0, const vms_vector &p1, const vcsegidx_t seg1, const int max_depth)
 {
-	if (dist > MIN_CACHE_FCD_DIST) {
-		Fcd_cache[Fcd_index].seg0 = seg0;
-		Fcd_cache[Fcd_index].seg1 = seg1;
-		Fcd_cache[Fcd_index].csd = depth;
-		Fcd_cache[Fcd_index].dist = dist;
-
-		Fcd_index++;
-
-		if (Fcd_index >= MAX_FCD_CACHE)
-			Fcd_index = 0;
-	} else {
-		//	If it's in the cache, remove it.
-		range_for (auto &i, Fcd_cache)
-			if (i.seg0 == seg0)
-				if (i.seg1 == seg1) {
-					Fcd_cache[Fcd_index].seg0 = segment_none;
-					break;
-				}
+	/* A search limited to `max_depth` gives up as soon as a segment at
+	 * `abort_depth` leads to a new segment, even one that is `seg1`.
+	 */
+	const unsigned abort_depth = max_depth > 0 ? max_depth - 1 : UINT_MAX;
+	const auto aborted = [this, abort_depth](const unsigned before) {
+		return abort_depth < first_expanding.size() && first_expanding[abort_depth] < before;
+	};
+	const auto &n1 = nodes[seg1];
+	while (!(n1.generation == generation && processed >= n1.order))
+	{
+		if (aborted(UINT_MAX) || !process_next(vcvertptr, vcwallptr))
+			return fcd_abort_return_value;
 	}
+	if (aborted(n1.order))
+		return fcd_abort_return_value;
+	if (n1.depth == 1)
+		return vm_vec_dist_quick(p1, nodes[seg0].center) + vm_vec_dist_quick(p0, n1.center);
+	const auto &parent = nodes[n1.parent];
+	return vm_vec_dist_quick(p1, parent.center) + vm_vec_dist_quick(p0, nodes[n1.first_hop].center) + parent.hops;
+}
 
 }
+
+//	----------------------------------------------------------------------------------------------------------
+//	Forget every search, after a change to the level that may open or close a path.
+void flush_fcd_cache(void)
+{
+	range_for (auto &i, Fcd_searches)
+		i.seg0 = segment_none;
 }
-#endif
 
 //	----------------------------------------------------------------------------------------------------------
 //	Determine whether seg0 and seg1 are reachable in a way that allows sound to pass.
@@ -842,15 +945,8 @@ vm_distance find_connected_distance(const vms_vector &p0, const vcsegptridx_t se
 {
 	auto &LevelSharedVertexState = LevelSharedSegmentState.get_vertex_state();
 	auto &Vertices = LevelSharedVertexState.get_vertices();
-	segnum_t		cur_seg;
-	int		qtail = 0, qhead = 0;
-	seg_seg	seg_queue[MAX_SEGMENTS];
-	short		depth[MAX_SEGMENTS];
-	int		cur_depth;
-	int		num_points;
-	point_seg	point_segs[MAX_LOC_POINT_SEGS];
-
-	//	If > this, will overrun point_segs buffer
+
+	//	Searches have always been limited to this depth.
 #ifdef WINDOWS
 	if (max_depth == -1) max_depth = 200;
 #endif	
@@ -876,117 +972,28 @@ vm_distance find_connected_distance(const vms_vector &p0, const vcsegptridx_t se
 		}
 	}
 
-#if defined(DXX_BUILD_DESCENT_II)
-	//	Periodically flush cache.
+	//	Periodically flush the searches, in case a change was not reported.
 	if ((GameTime64 - Last_fcd_flush_time > F1_0*2) || (GameTime64 < Last_fcd_flush_time)) {
 		flush_fcd_cache();
 		Last_fcd_flush_time = GameTime64;
 	}
 
-	else
-	//	Can't quickly get distance, so see if in Fcd_cache.
-	range_for (auto &i, Fcd_cache)
-		if (i.seg0 == seg0 && i.seg1 == seg1)
-		{
-			return i.dist;
-		}
-#endif
-
-	num_points = 0;
-
-	visited_segment_bitarray_t visited;
-	memset(depth, 0, sizeof(depth[0]) * (Highest_segment_index+1));
-
-	cur_seg = seg0;
-	visited[cur_seg] = true;
-	cur_depth = 0;
-
-	while (cur_seg != seg1) {
-		const cscusegment segp = *vmsegptr(cur_seg);
-		for (int sidenum = 0; sidenum < MAX_SIDES_PER_SEGMENT; sidenum++) {
-
-			int	snum = sidenum;
-
-			const auto this_seg = segp.s.children[snum];
-			if (!IS_CHILD(this_seg))
-				continue;
-			if (!wid_flag.value || (WALL_IS_DOORWAY(GameBitmaps, Textures, vcwallptr, segp, snum) & wid_flag))
-			{
-				if (!visited[this_seg]) {
-					seg_queue[qtail].start = cur_seg;
-					seg_queue[qtail].end = this_seg;
-					visited[this_seg] = true;
-					depth[qtail++] = cur_depth+1;
-					if (max_depth != -1) {
-						if (depth[qtail-1] == max_depth) {
-							constexpr auto Connected_segment_distance = 1000;
-							add_to_fcd_cache(seg0, seg1, Connected_segment_distance, fcd_abort_cache_value);
-							return fcd_abort_return_value;
-						}
-					} else if (this_seg == seg1) {
-						goto fcd_done1;
-					}
-				}
-
-			}
-		}	//	for (sidenum...
-
-		if (qhead >= qtail) {
-			constexpr auto Connected_segment_distance = 1000;
-			add_to_fcd_cache(seg0, seg1, Connected_segment_distance, fcd_abort_cache_value);
-			return fcd_abort_return_value;
-		}
-
-		cur_seg = seg_queue[qhead].end;
-		cur_depth = depth[qhead];
-		qhead++;
-
-fcd_done1: ;
-	}	//	while (cur_seg ...
-
-	//	Set qtail to the segment which ends at the goal.
-	while (seg_queue[--qtail].end != seg1)
-		if (qtail < 0) {
-			constexpr auto Connected_segment_distance = 1000;
-			add_to_fcd_cache(seg0, seg1, Connected_segment_distance, fcd_abort_cache_value);
-			return fcd_abort_return_value;
-		}
-
 	auto &vcvertptr = Vertices.vcptr;
-	while (qtail >= 0) {
-		segnum_t	parent_seg, this_seg;
-
-		this_seg = seg_queue[qtail].end;
-		parent_seg = seg_queue[qtail].start;
-		point_segs[num_points].segnum = this_seg;
-		compute_segment_center(vcvertptr, point_segs[num_points].point, vcsegptr(this_seg));
-		num_points++;
-
-		if (parent_seg == seg0)
+	fcd_search *search = nullptr;
+	range_for (auto &i, Fcd_searches)
+	{
+		if (i.seg0 == seg0 && i.wid_flag.value == wid_flag.value)
+		{
+			search = &i;
 			break;
-
-		while (seg_queue[--qtail].end != parent_seg)
-			Assert(qtail >= 0);
-	}
-
-	point_segs[num_points].segnum = seg0;
-	compute_segment_center(vcvertptr, point_segs[num_points].point,seg0);
-	num_points++;
-
-	if (num_points == 1) {
-		return vm_vec_dist_quick(p0, p1);
-	}
-	auto dist = vm_vec_dist_quick(p1, point_segs[1].point);
-		dist += vm_vec_dist_quick(p0, point_segs[num_points-2].point);
-
-		for (int i=1; i<num_points-2; i++) {
-			dist += vm_vec_dist_quick(point_segs[i].point, point_segs[i+1].point);
 		}
-
-	add_to_fcd_cache(seg0, seg1, num_points, dist);
-
-	return dist;
-
+		if (!search || i.last_used < search->last_used)
+			search = &i;
+	}
+	if (search->seg0 != seg0 || search->wid_flag.value != wid_flag.value || search->segment_count != Segments.get_count())
+		search->start(vcvertptr, seg0, wid_flag);
+	search->last_used = ++Fcd_use_count;
+	return search->find(vcvertptr, vcwallptr, p0, p1, seg1, max_depth);
 }
 
 }
@@ -454,9 +454,13 @@ void gameseq_remove_unused_players()
 
 	if (Game_mode & GM_MULTI)
 	{
+		/* A dedicated host has no ship in the world.  The host itself
+		 * keeps its object a ghost in GameProcessFrame.
+		 */
+		const unsigned dedicated_host = Netgame.game_flag.dedicated_host && !multi_i_am_master();
 		for (unsigned i = 0; i < NumNetPlayerPositions; ++i)
 		{
-			if ((!vcplayerptr(i)->connected) || (i >= N_players))
+			if ((!vcplayerptr(i)->connected) || (i >= N_players) || (!i && dedicated_host))
 			{
 				multi_make_player_ghost(i);
 			}
@@ -993,6 +997,14 @@ void LoadLevel(int level_num,int page_in_textures)
 
 	Assert(level_num <= Last_level  && level_num >= Last_secret_level  && level_num != 0);
 	const d_fname &level_name = get_level_file(level_num);
+	{
+		/* A limit at or below RESERVED_OBJECT_SLOTS would stop
+		 * object_move_all from culling, so never go below the floor
+		 * that net_udp_do_join_game enforces.
+		 */
+		const unsigned limit = Netgame.ObjectLimit;
+		LevelUniqueObjectState.object_limit = (Game_mode & GM_MULTI) && limit && limit < MAX_OBJECTS ? std::max<unsigned>(limit, MIN_OBJECT_LIMIT) : MAX_OBJECTS;
+	}
 #if defined(DXX_BUILD_DESCENT_I)
 	if (!load_level(level_name))
 		Current_level_num=level_num;
@@ -1023,6 +1035,10 @@ void LoadLevel(int level_num,int page_in_textures)
 	timer_delay(F1_0);
 #endif
 
+	flush_fcd_cache();
+#if DXX_USE_OGL
+	ogl_level_mesh_invalidate();
+#endif
 	load_endlevel_data(level_num);
 #if defined(DXX_BUILD_DESCENT_I)
 	load_custom_data(level_name);
@@ -1668,7 +1684,10 @@ static void DoEndGame()
 		// NOTE LINK TO ABOVE
 		DoEndLevelScoreGlitz();
 
-	if (PLAYING_BUILTIN_MISSION && !((Game_mode & GM_MULTI) && !(Game_mode & GM_MULTI_COOP))) {
+	/* A dedicated host draws no end screen and has no pilot to add to
+	 * the high scores.
+	 */
+	if (PLAYING_BUILTIN_MISSION && !((Game_mode & GM_MULTI) && !(Game_mode & GM_MULTI_COOP)) && !CGameArg.MplDedicated) {
 		gr_set_default_canvas();
 		gr_clear_canvas(*grd_curcanv, BM_XRGB(0,0,0));
 #if defined(DXX_BUILD_DESCENT_II)
@@ -1997,7 +2016,9 @@ window_event_result StartNewLevelSub(const int level_num, const int page_in_text
 	reset_special_effects();
 
 #if DXX_USE_OGL
-	ogl_cache_level_textures();
+	/* A dedicated host has no context to load textures into. */
+	if (!CGameArg.MplDedicated)
+		ogl_cache_level_textures();
 #endif
 
 
@@ -70,6 +70,10 @@ char copyright[] = "DESCENT II  COPYRIGHT (C) 1994-1996 PARALLAX SOFTWARE CORPOR
 #include "digi.h"
 #include "palette.h"
 #include "args.h"
+#include "benchmark.h"
+#include "demoexport.h"
+#include "demostats.h"
+#include "profile.h"
 #include "titles.h"
 #include "text.h"
 #include "gamefont.h"
@@ -84,6 +88,7 @@ char copyright[] = "DESCENT II  COPYRIGHT (C) 1994-1996 PARALLAX SOFTWARE CORPOR
 #endif
 #include "playsave.h"
 #include "newdemo.h"
+#include "render.h"
 #include "joy.h"
 #if !DXX_USE_OGL
 #include "../texmap/scanline.h" //for select_tmap -MM
@@ -200,6 +205,7 @@ static void print_commandline_help()
 	))	\
 	VERB("\n Graphics:\n\n")	\
 	VERB("  -lowresfont                   Force use of low resolution fonts\n")	\
+	VERB("  -texmergecache <n>            Keep up to <n> merged overlay textures (default: " DXX_STRINGIZE(TEXMERGE_CACHE_SIZE_DEFAULT) ")\n")	\
 	DXX_COMMAND_LINE_HELP_D2(	\
 		VERB("  -lowresgraphics               Force use of low resolution graphics\n")	\
 		VERB("  -lowresmovies                 Play low resolution movies if available (for slow machines)\n")	\
@@ -228,6 +234,19 @@ static void print_commandline_help()
 		VERB("  -udp_hostaddr <s>             Use IP address/Hostname <s> for manual game joining\n\t\t\t\t(default: %s)\n", UDP_MANUAL_ADDR_DEFAULT)	\
 		VERB("  -udp_hostport <n>             Use UDP port <n> for manual game joining (default: %hu)\n", UDP_PORT_DEFAULT)	\
 		VERB("  -udp_myport <n>               Set my own UDP port to <n> (default: %hu)\n", UDP_PORT_DEFAULT)	\
+		VERB("  -dedicated                    Host a game without drawing, sound or menus; exit when it ends\n")	\
+		VERB("  -dedicated_mission <s>        Mission <s> for -dedicated (default: built-in mission)\n")	\
+		VERB("  -dedicated_level <n>          Start -dedicated at level <n> (default: 1)\n")	\
+		VERB("  -dedicated_mode <s>           Game mode <s> for -dedicated, such as anarchy, team,\n\t\t\t\tcoop or bounty (default: from netgame profile)\n")	\
+		VERB("  -dedicated_name <s>           Game name <s> for -dedicated\n")	\
+		VERB("  -dedicated_players <n>        Allow at most <n> players in -dedicated, counting the host\n")	\
+		VERB("  -udp_capture <s>              Record every UDP packet received to file <s>\n")	\
+		VERB("  -udp_replay <s>               Receive the UDP packets recorded in file <s>\n\t\t\t\tinstead of from the network, and send nothing\n")	\
+		VERB("  -udp_sim_loss <n>             Drop <n> percent of UDP packets received\n")	\
+		VERB("  -udp_sim_latency <n>          Delay UDP packets received by <n> ms\n")	\
+		VERB("  -udp_sim_jitter <n>           Delay UDP packets received by up to <n> ms more\n")	\
+		VERB("  -udp_sim_reorder <n>          Hold back <n> percent of UDP packets received,\n\t\t\t\tso that later packets overtake them\n")	\
+		VERB("  -udp_sim_seed <n>             Seed <n> for the -udp_sim_* random choices\n")	\
 		DXX_if_defined_01(DXX_USE_TRACKER, (	\
 			VERB("  -no-tracker                   Disable tracker (unless overridden by later -tracker_hostaddr)\n")	\
 			VERB("  -tracker_hostaddr <n>         Address of tracker server to register/query games to/from\n\t\t\t\t(default: %s)\n", TRACKER_ADDR_DEFAULT)	\
@@ -257,6 +276,19 @@ static void print_commandline_help()
 	VERB("  -nodoublebuffer               Disable Doublebuffering\n")	\
 	VERB("  -bigpig                       Use uncompressed RLE bitmaps\n")	\
 	VERB("  -16bpp                        Use 16Bpp instead of 32Bpp\n")	\
+	VERB("  -benchmark <s>                Play demo <s> without pacing or sound, report frame times, then exit\n")	\
+	VERB("  -benchmark-frames <n>         Stop the benchmark after <n> frames (default: end of demo)\n")	\
+	VERB("  -export <s>                   Play demo <s> at a fixed frame step without pacing, write it out, then exit\n")	\
+	VERB("  -export-png <s>               Write each exported frame to directory <s> as a numbered PNG\n")	\
+	VERB("  -export-video <s>             Write exported frames to file or pipe <s> as raw 24-bit RGB\n")	\
+	VERB("  -export-audio <s>             Write exported sound to file or pipe <s> as raw unsigned 8-bit stereo\n")	\
+	VERB("  -export-fps <n>               Export <n> frames per second of demo time (default: 30)\n")	\
+	VERB("  -demo-stats <s>               Write kills, deaths, damage, weapons and positions from demo <s>, then exit\n")	\
+	VERB("  -demo-stats-csv               Write demo statistics as CSV instead of JSON\n")	\
+	VERB("  -demo-stats-jobs <n>          Analyse up to <n> demos at once (default: one per CPU)\n")	\
+	VERB("  -demo-stats-child <s>         Analyse only demo <s>; used by -demo-stats for each demo\n")	\
+	VERB("  -profile                      Time hot paths and show the results in game\n")	\
+	VERB("  -profile-csv <s>              Like -profile, and also write per-frame timings to file <s>\n")	\
 	DXX_COMMAND_LINE_HELP_OGL(	\
 		VERB("  -gl_oldtexmerge               Use old texmerge, uses more ram, but might be faster\n")	\
 		VERB("  -gl_intensity4_ok <n>         Override DbgGlIntensity4Ok (default: 1)\n")	\
@@ -266,7 +298,8 @@ static void print_commandline_help()
 		VERB("  -gl_gettexlevelparam_ok <n>   Override DbgGlGetTexLevelParamOk (default: 1)\n")	\
 	)	\
 	DXX_COMMAND_LINE_HELP_SDL(	\
-		VERB("  -tmap <s>                     Select texmapper <s> to use\n\t\t\t\t(default: c, available: c, fp, quad)\n")	\
+		VERB("  -tmap <s>                     Select texmapper <s> to use\n\t\t\t\t(default: c, available: c, fp, quad, simd)\n")	\
+		VERB("  -tmap_threads <n>             Draw texture maps on <n> threads, at most one per CPU,\n\t\t\t\t0 for one per CPU (default: 1)\n")	\
 		VERB("  -hwsurface                    Use SDL HW Surface\n")	\
 		VERB("  -asyncblit                    Use queued blits over SDL. Can speed up rendering\n")	\
 	)	\
@@ -596,18 +629,25 @@ static int main(int argc, char *argv[])
 
 #if !DXX_USE_OGL
 	select_tmap(CGameArg.DbgTexMap);
+	tmap_batch_init(CGameArg.DbgTexMapThreads);
 
 #if defined(DXX_BUILD_DESCENT_II)
 	Lighting_on = 1;
 #endif
 #endif
 
-	con_puts(CON_VERBOSE, "Going into graphics mode...");
+	/* gr_init gave a dedicated host a screen in memory, and it has no
+	 * video mode to set.
+	 */
+	if (!CGameArg.MplDedicated)
+	{
+		con_puts(CON_VERBOSE, "Going into graphics mode...");
 #if DXX_USE_OGL
-	gr_set_mode_from_window_size();
+		gr_set_mode_from_window_size();
 #else
-	gr_set_mode(Game_screen_mode);
+		gr_set_mode(Game_screen_mode);
 #endif
+	}
 
 	// Load the palette stuff. Returns non-zero if error.
 	con_puts(CON_DEBUG, "Initializing palette system...");
@@ -665,14 +705,19 @@ static int main(int argc, char *argv[])
 		return(0);
 
 	con_puts(CON_DEBUG, "Initializing texture caching system...");
-	texmerge_init();		// 10 cache bitmaps
+	texmerge_init();
 
 #if defined(DXX_BUILD_DESCENT_II)
 	piggy_init_pigfile("groupa.pig");	//get correct pigfile
 #endif
 
+	profile_active = CGameArg.DbgProfile;
+	if (!CGameArg.DbgProfileCsv.empty())
+		profile_open_csv(CGameArg.DbgProfileCsv.c_str());
+
 	con_puts(CON_DEBUG, "Running game...");
 	init_game();
+	int exit_status = 0;
 
 #if defined(DXX_BUILD_DESCENT_I)
 	key_flush();
@@ -723,6 +768,44 @@ static int main(int argc, char *argv[])
 	}
 	else
 #endif
+#endif
+	if (!CGameArg.DbgBenchmarkDemo.empty())
+	{
+		Game_mode = {};
+		benchmark_demo_playback(CGameArg.DbgBenchmarkDemo.c_str(), CGameArg.DbgBenchmarkFrames);
+	}
+	else if (!CGameArg.DbgExportDemo.empty())
+	{
+		Game_mode = {};
+		export_demo(CGameArg.DbgExportDemo.c_str(), CGameArg.DbgExportFps, CGameArg.DbgExportPng, CGameArg.DbgExportVideo, CGameArg.DbgExportAudio);
+	}
+	else if (!CGameArg.DbgDemoStats.empty())
+	{
+		Game_mode = {};
+		/* A copy started for one demo of many reports failure to its
+		 * parent through the exit status.
+		 */
+		if (demo_stats(CGameArg.DbgDemoStats, CGameArg.DbgDemoStatsJobs, CGameArg.DbgDemoStatsCsv, argc, argv) != CGameArg.DbgDemoStats.size())
+			exit_status = 1;
+	}
+	else
+#if DXX_USE_UDP
+	if (CGameArg.MplDedicated)
+	{
+		Game_mode = {};
+		if (!*static_cast<const char *>(InterfaceUniqueState.PilotName))
+		{
+			/* Without -pilot, host as a pilot with default settings.
+			 * write_player_file does nothing on a dedicated host, so
+			 * this pilot is never saved.
+			 */
+			new_player_config();
+			InterfaceUniqueState.PilotName.copy("server", 6);
+		}
+		if (net_udp_start_dedicated_game() == window_event_result::close)
+			exit_status = 1;
+	}
+	else
 #endif
 	{
 		Game_mode = {};
@@ -745,14 +828,21 @@ static int main(int argc, char *argv[])
 	WriteConfigFile();
 
 	con_puts(CON_DEBUG, "Cleanup...");
+	profile_close_csv();
 	close_game();
 	texmerge_close();
+#if !DXX_USE_OGL
+	tmap_batch_close();
+#endif
+#if defined(DXX_BUILD_DESCENT_II)
+	render_view_prefetch_close();
+#endif
 	gamedata_close();
 	gamefont_close();
 	Current_mission.reset();
 	PHYSFSX_removeArchiveContent();
 
-	return(0);		//presumably successful exit
+	return exit_status;
 }
 
 }
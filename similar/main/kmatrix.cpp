@@ -370,7 +370,11 @@ window_event_result kmatrix_window::event_handler(const d_event &event)
 		case EVENT_WINDOW_DRAW:
 			{
 			timer_delay2(50);
-			kmatrix_redraw(this);
+			/* A dedicated host has nothing to draw to, but still
+			 * waits here for the players to finish the level.
+			 */
+			if (!CGameArg.MplDedicated)
+				kmatrix_redraw(this);
 
 			if (network != kmatrix_network::offline)
 				multi::dispatch->do_protocol_frame(0, 1);
@@ -1119,53 +1119,36 @@ imobjptridx_t find_homing_object_complete(const vms_vector &curpos, const vmobjp
 #endif
 
 	imobjptridx_t	best_objnum = object_none;
-	range_for (const auto &&curobjp, vmobjptridx)
-	{
-		int			is_proximity = 0;
+	const auto consider = [&](const vmobjptridx_t curobjp, const int is_proximity) {
 		fix			dot;
 
-		if ((curobjp->type != track_obj_type1) && (curobjp->type != track_obj_type2))
-		{
-#if defined(DXX_BUILD_DESCENT_II)
-			if ((curobjp->type == OBJ_WEAPON) && (is_proximity_bomb_or_player_smart_mine(get_weapon_id(curobjp)))) {
-				auto &cur_laser_info = curobjp->ctype.laser_info;
-				auto &tracker_laser_info = tracker->ctype.laser_info;
-				if (cur_laser_info.parent_num != tracker_laser_info.parent_num || cur_laser_info.parent_signature != tracker_laser_info.parent_signature)
-					is_proximity = 1;
-				else
-					continue;
-			} else
-#endif
-				continue;
-		}
-
 		if (curobjp == tracker->ctype.laser_info.parent_num) // Don't track shooter
-			continue;
+			return;
 
 		//	Don't track cloaked players.
 		if (curobjp->type == OBJ_PLAYER)
 		{
 			if (curobjp->ctype.player_info.powerup_flags & PLAYER_FLAGS_CLOAKED)
-				continue;
+				return;
 			// Don't track teammates in team games
 			if (Game_mode & GM_TEAM)
 			{
 				const auto &&objparent = vcobjptr(tracker->ctype.laser_info.parent_num);
 				if (objparent->type == OBJ_PLAYER && get_team(get_player_id(curobjp)) == get_team(get_player_id(objparent)))
-					continue;
+					return;
 			}
 		}
 
 		//	Can't track AI object if he's cloaked.
 		if (curobjp->type == OBJ_ROBOT) {
 			if (curobjp->ctype.ai_info.CLOAKED)
-				continue;
+				return;
 
 #if defined(DXX_BUILD_DESCENT_II)
 			//	Your missiles don't track your escort.
 			if (Robot_info[get_robot_id(curobjp)].companion)
 				if (tracker->ctype.laser_info.parent_type == OBJ_PLAYER)
-					continue;
+					return;
 #endif
 		}
 
@@ -1179,7 +1162,9 @@ imobjptridx_t find_homing_object_complete(const vms_vector &curpos, const vmobjp
 				dot = ((dot << 3) + dot) >> 3;		//	I suspect Watcom would be too stupid to figure out the obvious...
 
 			if (dot > min_trackable_dot) {
-				if (dot > max_dot) {
+				//	The candidates are not visited in object order, so break
+				//	ties the way a scan in object order would have.
+				if (dot > max_dot || (dot == max_dot && static_cast<objnum_t>(curobjp) < static_cast<objnum_t>(best_objnum))) {
 					if (object_to_object_visibility(tracker, curobjp, FQ_TRANSWALL)) {
 						max_dot = dot;
 						best_objnum = curobjp;
@@ -1187,8 +1172,34 @@ imobjptridx_t find_homing_object_complete(const vms_vector &curpos, const vmobjp
 				}
 			}
 		}
-
-	}
+	};
+	const auto consider_type = [&](const int type) {
+		if (type < 0 || type >= MAX_OBJECT_TYPES)
+			return;
+		range_for (const auto i, obj_list_of_type(static_cast<object_type_t>(type)))
+		{
+			const auto &&curobjp = vmobjptridx(i);
+			if (curobjp->type == type)
+				consider(curobjp, 0);
+		}
+	};
+	consider_type(track_obj_type1);
+	if (track_obj_type2 != track_obj_type1)
+		consider_type(track_obj_type2);
+#if defined(DXX_BUILD_DESCENT_II)
+	//	Mines are tracked too, unless they were already tracked as weapons.
+	if (track_obj_type1 != OBJ_WEAPON && track_obj_type2 != OBJ_WEAPON)
+		range_for (const auto i, obj_list_of_mines())
+		{
+			const auto &&curobjp = vmobjptridx(i);
+			if (curobjp->type != OBJ_WEAPON || !is_proximity_bomb_or_player_smart_mine(get_weapon_id(curobjp)))
+				continue;
+			auto &cur_laser_info = curobjp->ctype.laser_info;
+			auto &tracker_laser_info = tracker->ctype.laser_info;
+			if (cur_laser_info.parent_num != tracker_laser_info.parent_num || cur_laser_info.parent_signature != tracker_laser_info.parent_signature)
+				consider(curobjp, 1);
+		}
+#endif
 	return best_objnum;
 }
 
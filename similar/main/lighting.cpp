@@ -26,6 +26,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include <algorithm>
 #include <bitset>
 #include <numeric>
+#include <vector>
 #include <stdio.h>
 #include <string.h>	// for memset()
 
@@ -117,7 +118,7 @@ static fix compute_fireball_light_emission_intensity(const d_vclip_array &Vclip,
 namespace dsx {
 namespace {
 
-static void apply_light(fvmsegptridx &vmsegptridx, const g3s_lrgb obj_light_emission, const vcsegptridx_t obj_seg, const vms_vector &obj_pos, const unsigned n_render_vertices, std::array<vertnum_t, MAX_VERTICES> &render_vertices, const std::array<segnum_t, MAX_VERTICES> &vert_segnum_list, const icobjptridx_t objnum)
+static void apply_light(fvmsegptridx &vmsegptridx, const g3s_lrgb obj_light_emission, const vcsegptridx_t obj_seg, const vms_vector &obj_pos, const unsigned n_render_vertices, const std::vector<vertnum_t> &render_vertices, const std::vector<segnum_t> &vert_segnum_list, const icobjptridx_t objnum)
 {
 	auto &LevelSharedVertexState = LevelSharedSegmentState.get_vertex_state();
 	auto &Vertices = LevelSharedVertexState.get_vertices();
@@ -246,7 +247,7 @@ static void apply_light(fvmsegptridx &vmsegptridx, const g3s_lrgb obj_light_emis
 namespace {
 
 // ----------------------------------------------------------------------------------------------
-static void cast_muzzle_flash_light(fvmsegptridx &vmsegptridx, int n_render_vertices, std::array<vertnum_t, MAX_VERTICES> &render_vertices, const std::array<segnum_t, MAX_VERTICES> &vert_segnum_list)
+static void cast_muzzle_flash_light(fvmsegptridx &vmsegptridx, int n_render_vertices, const std::vector<vertnum_t> &render_vertices, const std::vector<segnum_t> &vert_segnum_list)
 {
 	fix64 current_time;
 	short time_since_flash;
@@ -512,13 +513,56 @@ static g3s_lrgb compute_light_emission(const d_level_shared_robot_info_state &Le
 
 }
 
+namespace {
+
+/* The vertices of the rendered segments, gathered by set_dynamic_light.
+ * The tables grow to the number of vertices in the level, not to
+ * MAX_VERTICES, and a vertex is marked as seen by stamping it with the
+ * pass number, so nothing is cleared between passes.
+ */
+struct dynamic_light_vertices
+{
+	std::vector<vertnum_t> render_vertices;
+	std::vector<segnum_t> vert_segnum_list;
+	std::vector<unsigned> seen;
+	unsigned pass = 0;
+	void start(std::size_t vertex_count);
+	bool mark(vertnum_t vnum)
+	{
+		auto &s = seen[static_cast<std::size_t>(vnum)];
+		if (s == pass)
+			return false;
+		s = pass;
+		return true;
+	}
+};
+
+void dynamic_light_vertices::start(const std::size_t vertex_count)
+{
+	render_vertices.clear();
+	vert_segnum_list.clear();
+	if (seen.size() < vertex_count)
+		seen.resize(vertex_count);
+	if (++pass)
+		return;
+	std::fill(seen.begin(), seen.end(), 0);
+	pass = 1;
+}
+
+static dynamic_light_vertices Dynamic_light_vertices;
+
+}
+
 // ----------------------------------------------------------------------------------------------
 void set_dynamic_light(render_state_t &rstate)
 {
 	auto &Objects = LevelUniqueObjectState.Objects;
 	auto &vcobjptridx = Objects.vcptridx;
-	std::array<vertnum_t, MAX_VERTICES> render_vertices;
-	std::array<segnum_t, MAX_VERTICES> vert_segnum_list;
+	auto &LevelSharedVertexState = LevelSharedSegmentState.get_vertex_state();
+	auto &Vertices = LevelSharedVertexState.get_vertices();
+	auto &dlv = Dynamic_light_vertices;
+	auto &render_vertices = dlv.render_vertices;
+	auto &vert_segnum_list = dlv.vert_segnum_list;
 	static fix light_time; 
 
 #if defined(DXX_BUILD_DESCENT_II)
@@ -533,29 +577,26 @@ void set_dynamic_light(render_state_t &rstate)
 		return;
 	light_time = light_time - (F1_0/60);
 
-	enumerated_bitset<MAX_VERTICES, vertnum_t> render_vertex_flags;
+	dlv.start(Vertices.get_count());
 
 	//	Create list of vertices that need to be looked at for setting of ambient light.
 	auto &Dynamic_light = LevelUniqueLightState.Dynamic_light;
-	uint_fast32_t n_render_vertices = 0;
 	range_for (const auto segnum, partial_const_range(rstate.Render_list, rstate.N_render_segs))
 	{
 		if (segnum != segment_none) {
 			auto &vp = Segments[segnum].verts;
 			range_for (const auto vnum, vp)
 			{
-				auto &&b = render_vertex_flags[vnum];
-				if (!b)
+				if (dlv.mark(vnum))
 				{
-					b = true;
-					render_vertices[n_render_vertices] = vnum;
-					vert_segnum_list[n_render_vertices] = segnum;
-					n_render_vertices++;
+					render_vertices.emplace_back(vnum);
+					vert_segnum_list.emplace_back(segnum);
 					Dynamic_light[vnum] = {};
 				}
 			}
 		}
 	}
+	const unsigned n_render_vertices = render_vertices.size();
 
 	cast_muzzle_flash_light(vmsegptridx, n_render_vertices, render_vertices, vert_segnum_list);
 
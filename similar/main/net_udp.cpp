@@ -28,6 +28,8 @@
 #include "player.h"
 #include "gameseq.h"
 #include "net_udp.h"
+#include "pdata_delta.h"
+#include "udp_capture.h"
 #include "game.h"
 #include "multi.h"
 #include "palette.h"
@@ -54,6 +56,7 @@
 #include "weapon.h"
 
 #include "compiler-cf_assert.h"
+#include "profile.h"
 #include "compiler-range_for.h"
 #include "d_enumerate.h"
 #include "d_levelstate.h"
@@ -120,6 +123,10 @@ static void net_udp_process_mdata (uint8_t *data, uint_fast32_t data_len, const
 static void net_udp_send_pdata();
 static void net_udp_process_pdata (const uint8_t *data, uint_fast32_t data_len, const _sockaddr &sender_addr);
 static void net_udp_read_pdata_packet(UDP_frame_info *pd);
+static void net_udp_process_pdata_delta(const uint8_t *data, uint_fast32_t data_len, const _sockaddr &sender_addr);
+static void net_udp_send_pdata_acks();
+static void net_udp_process_pdata_ack(const uint8_t *data, uint_fast32_t data_len, const _sockaddr &sender_addr);
+static void net_udp_pdata_clear(ubyte player_num);
 static void net_udp_timeout_check(fix64 time);
 static int net_udp_get_new_player_num ();
 static void net_udp_noloss_got_ack(const uint8_t *data, uint_fast32_t data_len);
@@ -134,14 +141,156 @@ namespace dsx {
 static void net_udp_process_game_info(const uint8_t *data, uint_fast32_t data_len, const _sockaddr &game_addr, int lite_info, uint16_t TrackerGameID = 0);
 }
 static int net_udp_start_game(void);
+static int net_udp_select_dedicated_players();
+
+namespace {
+
+/*
+ * MDATA packets which may have to be resent, oldest first.  Packets are
+ * numbered in the order they were added, and stored in a ring indexed by
+ * that number.
+ * An ACK names the pkt_num that was assigned to the packet for the player
+ * who sent the ACK.  Each player gets consecutive pkt_nums, so each player
+ * has a ring from pkt_num to packet number.
+ * Every resend waits the same time, so resends are due in the order they
+ * were scheduled, and a FIFO of pending resends finds the due ones without
+ * looking at the others.
+ */
+class UDP_mdata_store_queue
+{
+	struct pending_resend
+	{
+		uint32_t seq;
+		uint8_t pnum;
+	};
+	std::array<UDP_mdata_store, UDP_MDATA_STOR_QUEUE_SIZE> store;
+	std::array<std::array<uint32_t, UDP_MDATA_STOR_QUEUE_SIZE>, MAX_PLAYERS> ack_index;
+	/* Each stored packet has at most one pending resend per player.
+	 * Resends of removed packets stay until they are due, so there is room
+	 * for twice the live ones.
+	 */
+	std::array<pending_resend, UDP_MDATA_STOR_QUEUE_SIZE * MAX_PLAYERS * 2> resends;
+	uint32_t head = 0, tail = 0;	// number of the oldest packet, and of the next packet
+	unsigned resend_head = 0, resend_count = 0;
+	bool contains(const uint32_t seq) const
+	{
+		return seq - head < size();
+	}
+	bool is_pending(const pending_resend &r) const;
+	void drop_removed_resends();
+public:
+	unsigned size() const
+	{
+		return tail - head;
+	}
+	UDP_mdata_store &operator[](const uint32_t seq)
+	{
+		return store[seq % UDP_MDATA_STOR_QUEUE_SIZE];
+	}
+	UDP_mdata_store &front()
+	{
+		return (*this)[head];
+	}
+	uint32_t push_back();
+	void pop_front()
+	{
+		++head;
+	}
+	void clear()
+	{
+		head = tail;
+		resend_count = 0;
+	}
+	void set_ack_index(unsigned pnum, uint32_t pkt_num, uint32_t seq);
+	UDP_mdata_store *find_ack(unsigned pnum, uint32_t pkt_num);
+	void schedule_resend(uint32_t seq, unsigned pnum);
+	bool pop_due_resend(fix64 time, uint32_t &seq, unsigned &pnum);
+};
+
+/*
+ * PDATA packets can be sent as the difference from an earlier packet.
+ * A player who understands UPID_PDATA_DELTA says so by sending
+ * UPID_PDATA_ACK; until then a peer gets UPID_PDATA, so older builds
+ * still work.  Each packet is encoded against the newest packet the
+ * receiver has ACK'd, or against zero if there is none.  Both ends keep
+ * the last few packets of each player by sequence number, so that the
+ * baseline named in a packet can be found again.
+ * The host decodes what it gets from clients, and encodes it again for
+ * each other client against that client's baseline.
+ */
+constexpr unsigned UDP_pdata_history_size = 32;
+
+class UDP_pdata_history
+{
+	struct entry
+	{
+		uint16_t seq;
+		bool valid;
+		pdata_snapshot snapshot;
+	};
+	std::array<entry, UDP_pdata_history_size> entries{};
+public:
+	const pdata_snapshot *find(const uint16_t seq) const
+	{
+		auto &e = entries[seq % UDP_pdata_history_size];
+		return e.valid && e.seq == seq ? &e.snapshot : nullptr;
+	}
+	/* A late packet must not replace a newer one that may be in use as
+	 * a baseline.
+	 */
+	void store(const uint16_t seq, const pdata_snapshot &snapshot)
+	{
+		auto &e = entries[seq % UDP_pdata_history_size];
+		if (e.valid && static_cast<int16_t>(seq - e.seq) < 0)
+			return;
+		e.seq = seq;
+		e.valid = true;
+		e.snapshot = snapshot;
+	}
+	void clear()
+	{
+		range_for (auto &e, entries)
+			e.valid = false;
+	}
+};
+
+// What this player sent to one peer about the position of one player.
+struct UDP_pdata_sender
+{
+	UDP_pdata_history sent;
+	uint16_t next_seq;
+	uint16_t acked_seq;
+	bool acked;
+};
+
+// What this player received about the position of one player.
+struct UDP_pdata_receiver
+{
+	UDP_pdata_history received;
+	uint16_t latest_seq;
+	bool have_latest;
+	bool ack_pending;	// latest_seq has not been ACK'd yet
+	bool need_keyframe;	// a packet named a baseline which is not in received
+};
+
+struct UDP_pdata_peer
+{
+	std::array<UDP_pdata_sender, MAX_PLAYERS> senders;	// indexed by the player whose position is sent
+	fix64 announce_time;	// when a UPID_PDATA_ACK was last sent only to say UPID_PDATA_DELTA is understood
+	bool capable;	// peer sent UPID_PDATA_ACK
+	bool ack_due;	// peer sent PDATA since the last UPID_PDATA_ACK to it
+};
+
+}
 
 // Variables
 static int UDP_num_sendto, UDP_len_sendto, UDP_num_recvfrom, UDP_len_recvfrom;
 static UDP_mdata_info		UDP_MData;
 static UDP_sequence_packet UDP_Seq;
-static unsigned UDP_mdata_queue_highest;
-static std::array<UDP_mdata_store, UDP_MDATA_STOR_QUEUE_SIZE> UDP_mdata_queue;
+static UDP_mdata_store_queue UDP_mdata_queue;
 static std::array<UDP_mdata_check, MAX_PLAYERS> UDP_mdata_trace;
+static std::array<UDP_pdata_peer, MAX_PLAYERS> UDP_pdata_peers;
+static std::array<UDP_pdata_receiver, MAX_PLAYERS> UDP_pdata_received;
 static UDP_sequence_packet UDP_sync_player; // For rejoin object syncing
 static std::array<UDP_netgame_info_lite, UDP_MAX_NETGAMES> Active_udp_games;
 static unsigned num_active_udp_games;
@@ -434,6 +583,13 @@ static bool convert_text_portstring(const std::array<char, 6> &portstring, uint1
 
 namespace {
 
+#if defined(__linux__) && defined(MSG_WAITFORONE)
+/* Linux can move several datagrams per system call. */
+#define DXX_UDP_USE_MMSG	1
+#else
+#define DXX_UDP_USE_MMSG	0
+#endif
+
 #if DXX_USE_IPv6
 /* Returns true if kernel allows specifying sizeof(sockaddr_in6) for
  * size of a sockaddr_in.  Saves a compare+jump in application code to
@@ -573,8 +729,134 @@ public:
 	static ssize_t apply(int sockfd, void *msg, size_t len, int flags, sockaddr &from, socklen_t &fromlen);
 };
 
+#if DXX_UDP_USE_MMSG
+/* Packets sent during a protocol frame are queued, and sent together
+ * with one sendmmsg when the frame ends.
+ */
+class udp_send_batch_t
+{
+	static constexpr std::size_t max_packets = 64;
+	struct packet
+	{
+		_sockaddr to;
+		socklen_t tolen;
+		int sockfd;
+		unsigned len;
+		std::array<uint8_t, UPID_MAX_SIZE> data;
+	};
+	std::array<packet, max_packets> packets;
+	std::array<mmsghdr, max_packets> headers;
+	std::array<iovec, max_packets> iov;
+	unsigned count = 0;
+public:
+	unsigned depth = 0;	// nesting of udp_send_batch_scope; packets are queued only while positive
+	bool queue(int sockfd, const void *msg, size_t len, int flags, const sockaddr &to, socklen_t tolen);
+	void flush();
+};
+
+static udp_send_batch_t udp_send_batch;
+
+bool udp_send_batch_t::queue(const int sockfd, const void *const msg, const size_t len, const int flags, const sockaddr &to, const socklen_t tolen)
+{
+	if (!depth || flags || len > UPID_MAX_SIZE || tolen > sizeof(_sockaddr))
+		return false;
+	if (count == max_packets)
+		flush();
+	auto &p = packets[count++];
+	memcpy(&p.to, &to, tolen);
+	p.tolen = tolen;
+	p.sockfd = sockfd;
+	p.len = len;
+	memcpy(p.data.data(), msg, len);
+	return true;
+}
+
+void udp_send_batch_t::flush()
+{
+	for (unsigned i = 0; i < count; ++i)
+	{
+		auto &p = packets[i];
+		iov[i] = {p.data.data(), p.len};
+		auto &h = headers[i].msg_hdr;
+		h = {};
+		h.msg_name = &p.to;
+		h.msg_namelen = p.tolen;
+		h.msg_iov = &iov[i];
+		h.msg_iovlen = 1;
+	}
+	/* Each sendmmsg sends a run of packets for the same socket.  If a
+	 * packet fails, it is dropped, as a failed sendto would be, and the
+	 * rest of the run is retried.
+	 */
+	for (unsigned i = 0; i < count;)
+	{
+		const int sockfd = packets[i].sockfd;
+		unsigned run = 1;
+		while (i + run < count && packets[i + run].sockfd == sockfd)
+			++run;
+		const int sent = sendmmsg(sockfd, &headers[i], run, 0);
+		i += sent > 0 ? sent : 1;
+	}
+	count = 0;
+}
+#endif
+
+/* Received packets can be recorded to a file (-udp_capture), read back
+ * from a file in place of the sockets (-udp_replay), and passed through
+ * a simulated link (-udp_sim_*) on their way to
+ * net_udp_process_packet.  A replay is a benchmark of the receiving
+ * side, so nothing is sent while it runs.
+ */
+class udp_receive_harness_t
+{
+	RAIIPHYSFS_File capture;
+	std::vector<uint8_t> capture_buffer;
+	/* The time that the capture file started, so that each game appended
+	 * to it continues the same clock.
+	 */
+	fix64 capture_start_time = 0;
+	bool capture_started = false;
+	std::vector<uint8_t> replay;
+	std::size_t replay_offset = 0;
+	fix64 start_time = 0;
+	udp_link_queue link;
+	bool replaying = false;
+	bool simulating = false;
+	uint32_t now() const
+	{
+		return static_cast<uint32_t>((timer_query() - start_time) * 1000 / F1_0);
+	}
+	void open_replay(const char *filename);
+	void open_capture(const char *filename);
+public:
+	bool is_replaying() const
+	{
+		return replaying;
+	}
+	void open();
+	void close();
+	bool intercept(const uint8_t *data, const _sockaddr &sender, unsigned size);
+	void deliver();
+};
+
+static udp_receive_harness_t udp_receive_harness;
+
 ssize_t dxx_sendto_t::apply(int sockfd, const void *msg, size_t len, int flags, const sockaddr &to, socklen_t tolen)
 {
+	if (udp_receive_harness.is_replaying())
+	{
+		UDP_num_sendto++;
+		UDP_len_sendto += len;
+		return len;
+	}
+#if DXX_UDP_USE_MMSG
+	if (udp_send_batch.queue(sockfd, msg, len, flags, to, tolen))
+	{
+		UDP_num_sendto++;
+		UDP_len_sendto += len;
+		return len;
+	}
+#endif
 	ssize_t rv = sendto(sockfd, reinterpret_cast<const char *>(msg), len, flags, &to, tolen);
 
 	UDP_num_sendto++;
@@ -597,6 +879,26 @@ ssize_t dxx_recvfrom_t::apply(int sockfd, void *buf, size_t len, int flags, sock
 constexpr csockaddr_dispatch_t<socket_array_dispatch_t<dxx_sendto_t>> dxx_sendto{};
 constexpr sockaddr_dispatch_t<dxx_recvfrom_t> dxx_recvfrom{};
 
+/* While a scope is alive, sent packets are queued.  Each scope sends the
+ * queue when it ends, so that a nested protocol frame which waits in a
+ * loop does not hold back what the outer frame sent.
+ */
+class udp_send_batch_scope
+{
+public:
+#if DXX_UDP_USE_MMSG
+	udp_send_batch_scope()
+	{
+		++udp_send_batch.depth;
+	}
+	~udp_send_batch_scope()
+	{
+		--udp_send_batch.depth;
+		udp_send_batch.flush();
+	}
+#endif
+};
+
 }
 
 static void udp_traffic_stat()
@@ -1443,6 +1745,7 @@ void net_udp_init()
 #endif
 
 	clear_UDP_Socket();
+	udp_receive_harness.open();
 
 	Netgame = {};
 	UDP_Seq = {};
@@ -1464,7 +1767,14 @@ void net_udp_init()
 
 void net_udp_close()
 {
+#if DXX_UDP_USE_MMSG
+	/* Send what the current frame queued while its sockets are still
+	 * open.  Afterward, the queue cannot refer to a closed socket.
+	 */
+	udp_send_batch.flush();
+#endif
 	clear_UDP_Socket();
+	udp_receive_harness.close();
 #ifdef _WIN32
 	WSACleanup();
 #endif
@@ -1577,6 +1887,7 @@ void dispatch_table::disconnect_player(int playernum) const
 		VerifyPlayerJoined=-1;
 
 	net_udp_noloss_clear_mdata_trace(playernum);
+	net_udp_pdata_clear(playernum);
 }
 }
 }
@@ -1638,6 +1949,7 @@ static void net_udp_new_player(UDP_sequence_packet *const their)
 #endif
 
 	net_udp_noloss_clear_mdata_trace(pnum);
+	net_udp_pdata_clear(pnum);
 }
 }
 
@@ -1668,7 +1980,7 @@ static void net_udp_welcome_player(UDP_sequence_packet *their)
 
 	// Joining a running game will need quite a few packets on the mdata-queue, so let players only join if we have enough space.
 	if (Netgame.PacketLossPrevention)
-		if ((UDP_MDATA_STOR_QUEUE_SIZE - UDP_mdata_queue_highest) < UDP_MDATA_STOR_MIN_FREE_2JOIN)
+		if ((UDP_MDATA_STOR_QUEUE_SIZE - UDP_mdata_queue.size()) < UDP_MDATA_STOR_MIN_FREE_2JOIN)
 			return;
 
 	if (their->player.connected != Current_level_num)
@@ -1777,6 +2089,7 @@ static void net_udp_welcome_player(UDP_sequence_packet *their)
 		multi_send_score();
 
 		net_udp_noloss_clear_mdata_trace(player_num);
+		net_udp_pdata_clear(player_num);
 	}
 
 	auto &obj = *vmobjptr(vcplayerptr(player_num)->objnum);
@@ -2692,6 +3005,7 @@ static uint_fast32_t net_udp_prepare_heavy_game_info(const _sockaddr *addr, ubyt
 		buf[len] = Netgame.PacketLossPrevention;					len++;
 		buf[len] = Netgame.NoFriendlyFire;						len++;
 		buf[len] = Netgame.MouselookFlags;						len++;
+		PUT_INTEL_SHORT(buf + len, Netgame.ObjectLimit);				len += 2;
 		copy_from_ntstring(buf, len, Netgame.game_name);
 		copy_from_ntstring(buf, len, Netgame.mission_title);
 		copy_from_ntstring(buf, len, Netgame.mission_name);
@@ -2937,6 +3251,7 @@ static void net_udp_process_game_info(const uint8_t *data, uint_fast32_t, const
 		Netgame.PacketLossPrevention = data[len];					len++;
 		Netgame.NoFriendlyFire = data[len];						len++;
 		Netgame.MouselookFlags = data[len];						len++;
+		Netgame.ObjectLimit = GET_INTEL_SHORT(&(data[len]));				len += 2;
 		copy_to_ntstring(data, len, Netgame.game_name);
 		copy_to_ntstring(data, len, Netgame.mission_title);
 		copy_to_ntstring(data, len, Netgame.mission_name);
@@ -2992,6 +3307,7 @@ static void net_udp_process_request(UDP_sequence_packet *their)
 
 static void net_udp_process_packet(ubyte *data, const _sockaddr &sender_addr, int length )
 {
+	const profile_scope profile{profile_zone::net_udp_process_packet};
 	UDP_sequence_packet their{};
 
 	switch (data[0])
@@ -3114,6 +3430,12 @@ static void net_udp_process_packet(ubyte *data, const _sockaddr &sender_addr, in
 		case UPID_PDATA:
 			net_udp_process_pdata( data, length, sender_addr );
 			break;
+		case UPID_PDATA_DELTA:
+			net_udp_process_pdata_delta( data, length, sender_addr );
+			break;
+		case UPID_PDATA_ACK:
+			net_udp_process_pdata_ack( data, length, sender_addr );
+			break;
 		case UPID_MDATA_PNORM:
 			net_udp_process_mdata( data, length, sender_addr, 0 );
 			break;
@@ -3995,12 +4317,11 @@ static int net_udp_game_param_handler( newmenu *menu,const d_event &event, param
 }
 
 namespace dsx {
-window_event_result net_udp_setup_game()
+/* Start a new netgame with this player as host, and the parameters from
+ * the netgame profile.
+ */
+static void net_udp_init_host_netgame()
 {
-	param_opt opt;
-	auto &m = opt.m;
-	char level_text[32];
-
 	net_udp_init();
 
 	multi_new_game();
@@ -4035,12 +4356,14 @@ window_event_result net_udp_setup_game()
 	Netgame.PacketLossPrevention = 1;
 	Netgame.NoFriendlyFire = 0;
 	Netgame.MouselookFlags = 0;
+	Netgame.ObjectLimit = MAX_OBJECTS;
 
 #if DXX_USE_TRACKER
 	Netgame.Tracker = 1;
 #endif
 
 	read_netgame_profile(&Netgame);
+	Netgame.game_flag.dedicated_host = CGameArg.MplDedicated;
 
 #if defined(DXX_BUILD_DESCENT_II)
 	if (!HoardEquipped() && (Netgame.gamemode == NETGAME_HOARD || Netgame.gamemode == NETGAME_TEAM_HOARD)) // did we restore a hoard mode but don't have hoard installed right now? then fall back to anarchy!
@@ -4051,6 +4374,15 @@ window_event_result net_udp_setup_game()
 	Netgame.mission_title = Current_mission_longname;
 
 	Netgame.levelnum = 1;
+}
+
+window_event_result net_udp_setup_game()
+{
+	param_opt opt;
+	auto &m = opt.m;
+	char level_text[32];
+
+	net_udp_init_host_netgame();
 
 	unsigned optnum = 0;
 	opt.start_game=optnum;
@@ -4429,13 +4761,8 @@ menu:
 }
 
 namespace dsx {
-static int net_udp_select_players()
+static void net_udp_choose_shuffle_seed()
 {
-	int j;
-	char text[MAX_PLAYERS+4][45];
-	char subtitle[50];
-	unsigned save_nplayers;              //how may people would like to join
-
 	if (Netgame.ShufflePowerupSeed)
 	{
 		unsigned seed = 0;
@@ -4458,7 +4785,28 @@ static int net_udp_select_players()
 		}
 		Netgame.ShufflePowerupSeed = seed;
 	}
+}
+
+#if DXX_USE_TRACKER
+static void net_udp_start_tracker_registration()
+{
+	if( Netgame.Tracker )
+	{
+		TrackerAckStatus = TrackerAckState::TACK_NOCONNECTION;
+		TrackerAckTime = timer_query();
+		udp_tracker_register();
+	}
+}
+#endif
 
+static int net_udp_select_players()
+{
+	int j;
+	char text[MAX_PLAYERS+4][45];
+	char subtitle[50];
+	unsigned save_nplayers;              //how may people would like to join
+
+	net_udp_choose_shuffle_seed();
 	net_udp_add_player( &UDP_Seq );
 	start_poll_menu_items spd;
 		
@@ -4475,12 +4823,7 @@ static int net_udp_select_players()
 	snprintf(subtitle, sizeof(subtitle), "%s %d %s", TXT_TEAM_SELECT, Netgame.max_numplayers, TXT_TEAM_PRESS_ENTER);
 
 #if DXX_USE_TRACKER
-	if( Netgame.Tracker )
-	{
-		TrackerAckStatus = TrackerAckState::TACK_NOCONNECTION;
-		TrackerAckTime = timer_query();
-		udp_tracker_register();
-	}
+	net_udp_start_tracker_registration();
 #endif
 
 GetPlayersAgain:
@@ -4569,6 +4912,21 @@ abort:
 }
 }
 
+/* A dedicated host starts alone, and everyone else joins the game in
+ * progress.
+ */
+static int net_udp_select_dedicated_players()
+{
+	net_udp_choose_shuffle_seed();
+	net_udp_add_player( &UDP_Seq );
+	get_local_player().connected = CONNECT_PLAYING;
+	N_players = 1;
+#if DXX_USE_TRACKER
+	net_udp_start_tracker_registration();
+#endif
+	return 1;
+}
+
 static int net_udp_start_game(void)
 {
 	int i;
@@ -4599,7 +4957,7 @@ static int net_udp_start_game(void)
 
 	Netgame.protocol.udp.your_index = 0; // I am Host. I need to know that y'know? For syncing later.
 	
-	if (!net_udp_select_players()
+	if (!(CGameArg.MplDedicated ? net_udp_select_dedicated_players() : net_udp_select_players())
 		|| StartNewLevel(Netgame.levelnum) == window_event_result::close)
 	{
 		Game_mode = {};
@@ -4611,6 +4969,101 @@ static int net_udp_start_game(void)
 	return 1;	// don't keep params menu or mission listbox (may want to join a game next time)
 }
 
+namespace dsx {
+
+static bool net_udp_parse_dedicated_mode(const char *const name, ubyte &gamemode)
+{
+	static constexpr struct {
+		const char *name;
+		ubyte gamemode;
+	} modes[] = {
+		{"anarchy", NETGAME_ANARCHY},
+		{"team", NETGAME_TEAM_ANARCHY},
+		{"robo", NETGAME_ROBOT_ANARCHY},
+		{"coop", NETGAME_COOPERATIVE},
+#if defined(DXX_BUILD_DESCENT_II)
+		{"ctf", NETGAME_CAPTURE_FLAG},
+		{"hoard", NETGAME_HOARD},
+		{"teamhoard", NETGAME_TEAM_HOARD},
+#endif
+		{"bounty", NETGAME_BOUNTY},
+	};
+	range_for (auto &m, modes)
+		if (!d_stricmp(name, m.name))
+		{
+			gamemode = m.gamemode;
+			return true;
+		}
+	return false;
+}
+
+/* Host a game for -dedicated, without menus.  The netgame profile of the
+ * pilot supplies the game parameters, and the -dedicated_* options
+ * override the common ones.  Problems are reported to the console, since
+ * nobody is there to dismiss a message box.
+ */
+window_event_result net_udp_start_dedicated_game()
+{
+	{
+		mission_entry_predicate mission_predicate;
+		if (!CGameArg.MplDedicatedMission.empty())
+			mission_predicate.filesystem_name = CGameArg.MplDedicatedMission.c_str();
+		else
+#if defined(DXX_BUILD_DESCENT_I)
+			mission_predicate.filesystem_name = D1_MISSION_FILENAME;
+#elif defined(DXX_BUILD_DESCENT_II)
+			mission_predicate.filesystem_name = FULL_MISSION_FILENAME;
+		mission_predicate.check_version = false;
+#endif
+		if (const auto errstr = load_mission_by_name(mission_predicate, mission_name_type::guess))
+		{
+			con_printf(CON_URGENT, "Dedicated host: cannot load mission \"%s\": %s", mission_predicate.filesystem_name, errstr);
+			return window_event_result::close;
+		}
+	}
+
+	net_udp_init_host_netgame();
+
+	if (!CGameArg.MplDedicatedMode.empty() && !net_udp_parse_dedicated_mode(CGameArg.MplDedicatedMode.c_str(), Netgame.gamemode))
+		con_printf(CON_URGENT, "Dedicated host: unknown game mode \"%s\", using the netgame profile", CGameArg.MplDedicatedMode.c_str());
+#if defined(DXX_BUILD_DESCENT_II)
+	if (!HoardEquipped() && (Netgame.gamemode == NETGAME_HOARD || Netgame.gamemode == NETGAME_TEAM_HOARD))
+		Netgame.gamemode = NETGAME_ANARCHY;
+#endif
+	if (const unsigned level = CGameArg.MplDedicatedLevel)
+	{
+		if (level > Last_level)
+		{
+			con_printf(CON_URGENT, "Dedicated host: level %u is not in 1-%d", level, Last_level);
+			net_udp_close();
+			return window_event_result::close;
+		}
+		Netgame.levelnum = level;
+	}
+	if (const unsigned max_players = CGameArg.MplDedicatedMaxPlayers)
+		Netgame.max_numplayers = std::min(std::max(max_players, 2u), static_cast<unsigned>(MAX_PLAYERS));
+	if (!CGameArg.MplDedicatedName.empty())
+		Netgame.game_name.copy_if(CGameArg.MplDedicatedName.c_str(), CGameArg.MplDedicatedName.size());
+	/* Nobody is at the host to accept players, so anyone may join. */
+	Netgame.RefusePlayers = 0;
+	Netgame.game_flag.closed = 0;
+#if DXX_USE_TRACKER
+	if (CGameArg.MplTrackerAddr.empty())
+		Netgame.Tracker = 0;
+#endif
+
+	if (!net_udp_start_game())
+	{
+		con_puts(CON_URGENT, "Dedicated host: cannot start the game");
+		net_udp_close();
+		return window_event_result::close;
+	}
+	con_printf(CON_NORMAL, "Dedicated host: \"%s\" started at level %d on port %hu", Netgame.game_name.data(), Netgame.levelnum, UDP_MyPort);
+	return window_event_result::handled;
+}
+
+}
+
 static int net_udp_wait_for_sync(void)
 {
 	char text[60];
@@ -4761,6 +5214,18 @@ int net_udp_do_join_game()
 		return 0;
 	}
 
+	if (Netgame.ObjectLimit > MAX_OBJECTS)
+	{
+		nm_messagebox(menu_title{TXT_SORRY}, 1, TXT_OK, "This game allows up to %u objects.\nThis build can only hold %u.", Netgame.ObjectLimit, static_cast<unsigned>(MAX_OBJECTS));
+		return 0;
+	}
+	/* 0 comes from a host which does not send a limit. */
+	if (Netgame.ObjectLimit && Netgame.ObjectLimit < MIN_OBJECT_LIMIT)
+	{
+		nm_messagebox(menu_title{TXT_SORRY}, 1, TXT_OK, "This game allows only %u objects.\nAt least %u are needed.", Netgame.ObjectLimit, static_cast<unsigned>(MIN_OBJECT_LIMIT));
+		return 0;
+	}
+
 	// Check for valid mission name
 	{
 		mission_entry_predicate mission_predicate;
@@ -4888,10 +5353,240 @@ void net_udp_flush()
 		net_udp_flush(s);
 }
 
+void udp_receive_harness_t::open_replay(const char *const filename)
+{
+	auto f = PHYSFSX_openReadBuffered(filename);
+	if (!f)
+	{
+		con_printf(CON_URGENT, "Failed to open UDP capture \"%s\": %s", filename, PHYSFS_getLastError());
+		return;
+	}
+	replay.resize(PHYSFS_fileLength(f));
+	if (PHYSFS_read(f, replay.data(), 1, replay.size()) != static_cast<PHYSFS_sint64>(replay.size()) ||
+		replay.size() < udp_capture_header.size() ||
+		!std::equal(udp_capture_header.begin(), udp_capture_header.end(), replay.begin()))
+	{
+		con_printf(CON_URGENT, "\"%s\" is not a UDP capture", filename);
+		replay.clear();
+		return;
+	}
+	replay_offset = udp_capture_header.size();
+	replaying = true;
+	con_printf(CON_NORMAL, "Replaying UDP capture \"%s\"", filename);
+}
+
+/* The first game of a run starts the file.  Each later game is appended
+ * to it, instead of replacing it.
+ */
+void udp_receive_harness_t::open_capture(const char *const filename)
+{
+	if (capture_started)
+		capture = RAIIPHYSFS_File{PHYSFS_openAppend(filename)};
+	else
+		capture = PHYSFSX_openWriteBuffered(filename);
+	if (!capture)
+	{
+		con_printf(CON_URGENT, "Failed to open UDP capture \"%s\": %s", filename, PHYSFS_getLastError());
+		return;
+	}
+	if (!capture_started)
+	{
+		PHYSFS_write(capture, udp_capture_header.data(), 1, udp_capture_header.size());
+		capture_start_time = start_time;
+		capture_started = true;
+	}
+	con_printf(CON_NORMAL, "Recording UDP capture \"%s\"", filename);
+}
+
+void udp_receive_harness_t::open()
+{
+	close();
+	start_time = timer_query();
+	udp_link_model model{};
+	model.loss = CGameArg.MplUdpSimLoss;
+	model.reorder = CGameArg.MplUdpSimReorder;
+	model.latency = CGameArg.MplUdpSimLatency;
+	model.jitter = CGameArg.MplUdpSimJitter;
+	model.seed = CGameArg.MplUdpSimSeed;
+	link = udp_link_queue(model);
+	simulating = model.active();
+	if (!CGameArg.MplUdpReplay.empty())
+		open_replay(CGameArg.MplUdpReplay.c_str());
+	if (!CGameArg.MplUdpCapture.empty())
+		open_capture(CGameArg.MplUdpCapture.c_str());
+}
+
+void udp_receive_harness_t::close()
+{
+	capture.reset();
+	replay.clear();
+	replay_offset = 0;
+	link.clear();
+	replaying = simulating = false;
+}
+
+/* Returns true if the packet was taken by the simulated link, and will
+ * be processed later by deliver.
+ */
+bool udp_receive_harness_t::intercept(const uint8_t *const data, const _sockaddr &sender, const unsigned size)
+{
+	if (!capture && !simulating)
+		return false;
+	const auto address = reinterpret_cast<const uint8_t *>(&sender);
+	udp_capture_record record{now(), {address, address + sizeof(sender)}, {data, data + size}};
+	if (capture)
+	{
+		capture_buffer.clear();
+		const auto session_time = record.time;
+		record.time += static_cast<uint32_t>((start_time - capture_start_time) * 1000 / F1_0);
+		udp_capture_encode(record, capture_buffer);
+		record.time = session_time;
+		PHYSFS_write(capture, capture_buffer.data(), 1, capture_buffer.size());
+	}
+	if (!simulating)
+		return false;
+	link.push(std::move(record));
+	return true;
+}
+
+static void net_udp_process_recorded_packet(const udp_capture_record &record)
+{
+	const std::size_t size = record.payload.size();
+	if (!size || size > UPID_MAX_SIZE)
+		return;
+	std::array<uint8_t, UPID_MAX_SIZE> packet;
+	std::copy(record.payload.begin(), record.payload.end(), packet.begin());
+	if (size < packet.size())
+		packet[size] = 0;
+	_sockaddr sender{};
+	memcpy(&sender, record.address.data(), std::min(record.address.size(), sizeof(sender)));
+	net_udp_process_packet(packet.data(), sender, size);
+}
+
+/* Process the replayed packets whose time has come, and the packets
+ * that the simulated link has finished delaying.  The read position is
+ * advanced before each packet is processed, since processing may listen
+ * again.
+ */
+void udp_receive_harness_t::deliver()
+{
+	if (!replaying && !simulating)
+		return;
+	const auto t = now();
+	udp_capture_record record;
+	while (replay_offset < replay.size())
+	{
+		const auto used = udp_capture_decode(&replay[replay_offset], replay.size() - replay_offset, record);
+		if (!used)
+		{
+			con_printf(CON_URGENT, "UDP capture is truncated after %zu bytes", replay_offset);
+			replay_offset = replay.size();
+			break;
+		}
+		if (record.time > t)
+			break;
+		replay_offset += used;
+		if (simulating)
+			link.push(std::move(record));
+		else
+			net_udp_process_recorded_packet(record);
+	}
+	while (link.pop(t, record))
+		net_udp_process_recorded_packet(record);
+}
+
+static void net_udp_receive_packet(uint8_t *const data, const _sockaddr &sender_addr, const unsigned size)
+{
+	if (!udp_receive_harness.intercept(data, sender_addr, size))
+		net_udp_process_packet(data, sender_addr, size);
+}
+
+#if DXX_UDP_USE_MMSG
+/* Packets read together by one recvmmsg.  Processing a packet may
+ * listen again, for example from a menu.  That nested listen first
+ * delivers the rest of the batch, so that packets keep their order.  It
+ * then reads one packet at a time, since the arena is still in use.
+ */
+class udp_receive_batch_t
+{
+	static constexpr std::size_t max_packets = 32;
+	std::array<std::array<uint8_t, UPID_MAX_SIZE>, max_packets> packets;
+	std::array<_sockaddr, max_packets> senders;
+	std::array<mmsghdr, max_packets> headers;
+	std::array<iovec, max_packets> iov;
+	unsigned head = 0, count = 0;	// packets [head, count) are not yet delivered
+	bool busy = false;
+	void deliver();
+public:
+	bool listen(RAIIsocket &sock);
+};
+
+static udp_receive_batch_t udp_receive_batch;
+
+void udp_receive_batch_t::deliver()
+{
+	while (head < count)
+	{
+		const unsigned i = head++;
+		const unsigned size = headers[i].msg_len;
+		if (!size)
+			continue;
+		packets[i][size] = 0;
+		net_udp_receive_packet(packets[i].data(), senders[i], size);
+	}
+}
+
+/* Returns false if the arena is busy, and the caller must read the
+ * packets itself.
+ */
+bool udp_receive_batch_t::listen(RAIIsocket &sock)
+{
+	if (busy)
+	{
+		deliver();
+		return false;
+	}
+	busy = true;
+	for (;;)
+	{
+		for (unsigned i = 0; i < max_packets; ++i)
+		{
+			/* One byte short, so that a full packet can still be
+			 * terminated like udp_receive_packet does.
+			 */
+			iov[i] = {packets[i].data(), packets[i].size() - 1};
+			auto &h = headers[i].msg_hdr;
+			h = {};
+			h.msg_name = &senders[i];
+			h.msg_namelen = sizeof(_sockaddr);
+			h.msg_iov = &iov[i];
+			h.msg_iovlen = 1;
+		}
+		const int n = recvmmsg(sock, headers.data(), max_packets, MSG_DONTWAIT, nullptr);
+		if (n <= 0)
+			break;
+		UDP_num_recvfrom += n;
+		for (unsigned i = 0; i < static_cast<unsigned>(n); ++i)
+			UDP_len_recvfrom += headers[i].msg_len;
+		head = 0;
+		count = n;
+		deliver();
+		if (static_cast<unsigned>(n) < max_packets)
+			break;
+	}
+	busy = false;
+	return true;
+}
+#endif
+
 static void net_udp_listen(RAIIsocket &sock)
 {
 	if (!sock)
 		return;
+#if DXX_UDP_USE_MMSG
+	if (udp_receive_batch.listen(sock))
+		return;
+#endif
 	struct _sockaddr sender_addr;
 	std::array<uint8_t, UPID_MAX_SIZE> packet;
 	for (;;)
@@ -4899,14 +5594,16 @@ static void net_udp_listen(RAIIsocket &sock)
 		const int size = udp_receive_packet(sock, packet.data(), packet.size(), &sender_addr);
 		if (!(size > 0))
 			break;
-		net_udp_process_packet(packet.data(), sender_addr, size);
+		net_udp_receive_packet(packet.data(), sender_addr, size);
 	}
 }
 
 void net_udp_listen()
 {
-	range_for (auto &s, UDP_Socket)
-		net_udp_listen(s);
+	if (!udp_receive_harness.is_replaying())
+		range_for (auto &s, UDP_Socket)
+			net_udp_listen(s);
+	udp_receive_harness.deliver();
 }
 
 void net_udp_send_data(const uint8_t *const ptr, const unsigned len, const int priority)
@@ -4970,6 +5667,7 @@ void dispatch_table::do_protocol_frame(int force, int listen) const
 	if (!(Game_mode&GM_NETWORK) || !UDP_Socket[0])
 		return;
 
+	const udp_send_batch_scope send_batch;
 	const fix64 time = timer_update();
 
 	if (WaitForRefuseAnswer && time>(RefuseTimeLimit+(F1_0*12)))
@@ -4980,6 +5678,7 @@ void dispatch_table::do_protocol_frame(int force, int listen) const
 	{
 		last_pdata_time = time;
 		net_udp_send_pdata();
+		net_udp_send_pdata_acks();
 #if defined(DXX_BUILD_DESCENT_II)
                 multi_send_thief_frame();
 #endif
@@ -5040,6 +5739,97 @@ void dispatch_table::do_protocol_frame(int force, int listen) const
 
 /* CODE FOR PACKET LOSS PREVENTION - START */
 /* This code tries to make sure that packets with opcode UPID_MDATA_PNEEDACK aren't lost and sent and received in order. */
+
+uint32_t UDP_mdata_store_queue::push_back()
+{
+	const auto seq = tail++;
+	(*this)[seq] = {};
+	return seq;
+}
+
+void UDP_mdata_store_queue::set_ack_index(const unsigned pnum, const uint32_t pkt_num, const uint32_t seq)
+{
+	ack_index[pnum][pkt_num % UDP_MDATA_STOR_QUEUE_SIZE] = seq;
+}
+
+/* Find the stored packet which was sent to pnum as pkt_num. */
+UDP_mdata_store *UDP_mdata_store_queue::find_ack(const unsigned pnum, const uint32_t pkt_num)
+{
+	const auto seq = ack_index[pnum][pkt_num % UDP_MDATA_STOR_QUEUE_SIZE];
+	if (!contains(seq))
+		return nullptr;
+	auto &q = (*this)[seq];
+	if (!q.used || q.pkt_num[pnum] != pkt_num)
+		return nullptr;
+	return &q;
+}
+
+bool UDP_mdata_store_queue::is_pending(const pending_resend &r) const
+{
+	if (!contains(r.seq))
+		return false;
+	auto &q = store[r.seq % UDP_MDATA_STOR_QUEUE_SIZE];
+	return q.used && !q.player_ack[r.pnum];
+}
+
+/* Keep only the resends of packets which still wait for an ACK.  There
+ * are at most half as many of those as there is room for.
+ */
+void UDP_mdata_store_queue::drop_removed_resends()
+{
+	unsigned kept = 0;
+	for (unsigned i = 0; i < resend_count; ++i)
+	{
+		const auto r = resends[(resend_head + i) % resends.size()];
+		if (is_pending(r))
+			resends[(resend_head + kept++) % resends.size()] = r;
+	}
+	resend_count = kept;
+}
+
+void UDP_mdata_store_queue::schedule_resend(const uint32_t seq, const unsigned pnum)
+{
+	if (resend_count == resends.size())
+		drop_removed_resends();
+	resends[(resend_head + resend_count++) % resends.size()] = {seq, static_cast<uint8_t>(pnum)};
+}
+
+/* Take the next resend whose time has come, skipping those for packets
+ * which were ACK'd or removed since it was scheduled.
+ */
+bool UDP_mdata_store_queue::pop_due_resend(const fix64 time, uint32_t &seq, unsigned &pnum)
+{
+	for (; resend_count; resend_head = (resend_head + 1) % resends.size(), --resend_count)
+	{
+		const auto r = resends[resend_head];
+		if (!is_pending(r))
+			continue;
+		if ((*this)[r.seq].pkt_timestamp[r.pnum] + (F1_0/4) > time)
+			return false;
+		resend_head = (resend_head + 1) % resends.size();
+		--resend_count;
+		seq = r.seq;
+		pnum = r.pnum;
+		return true;
+	}
+	return false;
+}
+
+/* If player is not playing anymore, we can remove him from list. Also remove *me* (even if that should have been done already). Also make sure Clients do not send to anyone else than Host */
+static bool net_udp_noloss_skip_ack(const unsigned plc)
+{
+	return (vcplayerptr(plc)->connected != CONNECT_PLAYING || plc == Player_num) || (!multi_i_am_master() && plc > 0);
+}
+
+static void net_udp_noloss_set_ack(UDP_mdata_store &q, const unsigned plc)
+{
+	if (q.player_ack[plc])
+		return;
+	q.player_ack[plc] = 1;
+	if (!--q.needack)
+		q.used = 0;
+}
+
 /*
  * Adds a packet to our queue. Should be called when an IMPORTANT mdata packet is created.
  * player_ack is an array which should contain 0 for each player that needs to send an ACK signal.
@@ -5052,17 +5842,14 @@ static void net_udp_noloss_add_queue_pkt(fix64 time, const ubyte *data, ushort d
 	if (!Netgame.PacketLossPrevention)
 		return;
 
-	if (UDP_mdata_queue_highest == UDP_MDATA_STOR_QUEUE_SIZE) // The list is full. That should not happen. But if it does, we must do something.
+	if (UDP_mdata_queue.size() == UDP_MDATA_STOR_QUEUE_SIZE) // The list is full. That should not happen. But if it does, we must do something.
 	{
 		con_printf(CON_VERBOSE, "P#%u: MData store list is full!", Player_num);
 		if (multi_i_am_master()) // I am host. I will kick everyone who did not ACK the first packet and then remove it.
 		{
 			for ( int i=1; i<N_players; i++ )
-				if (UDP_mdata_queue[0].player_ack[i] == 0)
+				if (UDP_mdata_queue.front().player_ack[i] == 0)
 					multi::udp::dispatch->kick_player(Netgame.players[i].protocol.udp.addr, DUMP_PKTTIMEOUT);
-			std::move(std::next(UDP_mdata_queue.begin()), UDP_mdata_queue.end(), UDP_mdata_queue.begin());
-			UDP_mdata_queue[UDP_MDATA_STOR_QUEUE_SIZE - 1] = {};
-			UDP_mdata_queue_highest--;
 		}
 		else // I am just a client. I gotta go.
 		{
@@ -5075,28 +5862,44 @@ static void net_udp_noloss_add_queue_pkt(fix64 time, const ubyte *data, ushort d
 			multi_quit_game = 1;
 			game_leave_menus();
 		}
-		Assert(UDP_mdata_queue_highest == (UDP_MDATA_STOR_QUEUE_SIZE - 1));
+		UDP_mdata_queue.pop_front();
 	}
 
 	con_printf(CON_VERBOSE, "P#%u: Adding MData pkt_num [%i,%i,%i,%i,%i,%i,%i,%i], type %i from P#%i to MData store list", Player_num, UDP_mdata_trace[0].pkt_num_tosend,UDP_mdata_trace[1].pkt_num_tosend,UDP_mdata_trace[2].pkt_num_tosend,UDP_mdata_trace[3].pkt_num_tosend,UDP_mdata_trace[4].pkt_num_tosend,UDP_mdata_trace[5].pkt_num_tosend,UDP_mdata_trace[6].pkt_num_tosend,UDP_mdata_trace[7].pkt_num_tosend, data[0], pnum);
-	UDP_mdata_queue[UDP_mdata_queue_highest].used = 1;
-	UDP_mdata_queue[UDP_mdata_queue_highest].pkt_initial_timestamp = time;
+	const auto seq = UDP_mdata_queue.push_back();
+	auto &q = UDP_mdata_queue[seq];
+	q.used = 1;
+	q.pkt_initial_timestamp = time;
 	for (unsigned i = 0; i < MAX_PLAYERS; ++i)
 	{
 		if (i == Player_num || player_ack[i] || vcplayerptr(i)->connected == CONNECT_DISCONNECTED) // if player me, is not playing or does not require an ACK, do not add timestamp or increment pkt_num
 			continue;
 		
-		UDP_mdata_queue[UDP_mdata_queue_highest].pkt_timestamp[i] = time;
-		UDP_mdata_queue[UDP_mdata_queue_highest].pkt_num[i] = UDP_mdata_trace[i].pkt_num_tosend;
+		q.pkt_timestamp[i] = time;
+		q.pkt_num[i] = UDP_mdata_trace[i].pkt_num_tosend;
+		UDP_mdata_queue.set_ack_index(i, q.pkt_num[i], seq);
 		UDP_mdata_trace[i].pkt_num_tosend++;
 		if (UDP_mdata_trace[i].pkt_num_tosend > UDP_MDATA_PKT_NUM_MAX)
 			UDP_mdata_trace[i].pkt_num_tosend = UDP_MDATA_PKT_NUM_MIN;
 	}
-	UDP_mdata_queue[UDP_mdata_queue_highest].Player_num = pnum;
-	memcpy( &UDP_mdata_queue[UDP_mdata_queue_highest].player_ack, player_ack, sizeof(ubyte)*MAX_PLAYERS); 
-	memcpy( &UDP_mdata_queue[UDP_mdata_queue_highest].data, data, sizeof(char)*data_size );
-	UDP_mdata_queue[UDP_mdata_queue_highest].data_size = data_size;
-	UDP_mdata_queue_highest++;
+	q.Player_num = pnum;
+	memcpy( &q.player_ack, player_ack, sizeof(ubyte)*MAX_PLAYERS); 
+	memcpy( &q.data, data, sizeof(char)*data_size );
+	q.data_size = data_size;
+	for (unsigned i = 0; i < MAX_PLAYERS; ++i)
+	{
+		if (q.player_ack[i])
+			continue;
+		if (net_udp_noloss_skip_ack(i))
+			q.player_ack[i] = 1;
+		else
+		{
+			++q.needack;
+			UDP_mdata_queue.schedule_resend(seq, i);
+		}
+	}
+	if (!q.needack)
+		q.used = 0;
 }
 
 /*
@@ -5124,17 +5927,19 @@ static int net_udp_noloss_validate_mdata(uint32_t pkt_num, ubyte sender_pnum, co
         buf[len] = pkt_sender_pnum;											len++;
 	PUT_INTEL_INT(&buf[len], pkt_num);										len += 4;
 
+	/* Packets are accepted only in order, so the trace holds the last
+	 * UDP_MDATA_STOR_QUEUE_SIZE pkt_nums we got, each in its own slot.
+	 */
+	auto &trace_slot = UDP_mdata_trace[sender_pnum].pkt_num[pkt_num % UDP_MDATA_STOR_QUEUE_SIZE];
+
         // Make sure this is the packet we are expecting!
         if (UDP_mdata_trace[sender_pnum].pkt_num_torecv != pkt_num)
         {
-                range_for (auto &i, partial_const_range(UDP_mdata_trace[sender_pnum].pkt_num, static_cast<uint32_t>(UDP_MDATA_STOR_QUEUE_SIZE)))
+                if (pkt_num == trace_slot) // We got this packet already - need to REsend ACK
                 {
-                        if (pkt_num == i) // We got this packet already - need to REsend ACK
-                        {
-                                con_printf(CON_VERBOSE, "P#%u: Resending MData ACK for pkt %i we already got by pnum %i",Player_num, pkt_num, sender_pnum);
-                                dxx_sendto(sender_addr, UDP_Socket[0], buf, 0);
-                                return 0;
-                        }
+                        con_printf(CON_VERBOSE, "P#%u: Resending MData ACK for pkt %i we already got by pnum %i",Player_num, pkt_num, sender_pnum);
+                        dxx_sendto(sender_addr, UDP_Socket[0], buf, 0);
+                        return 0;
                 }
                 con_printf(CON_VERBOSE, "P#%u: Rejecting MData pkt %i - expected %i by pnum %i",Player_num, pkt_num, UDP_mdata_trace[sender_pnum].pkt_num_torecv, sender_pnum);
                 return 0; // Not the right packet and we haven't gotten it, yet either. So bail out and wait for the right one.
@@ -5143,10 +5948,7 @@ static int net_udp_noloss_validate_mdata(uint32_t pkt_num, ubyte sender_pnum, co
 	con_printf(CON_VERBOSE, "P#%u: Sending MData ACK for pkt %i by pnum %i",Player_num, pkt_num, sender_pnum);
 	dxx_sendto(sender_addr, UDP_Socket[0], buf, 0);
 
-	UDP_mdata_trace[sender_pnum].cur_slot++;
-	if (UDP_mdata_trace[sender_pnum].cur_slot >= UDP_MDATA_STOR_QUEUE_SIZE)
-		UDP_mdata_trace[sender_pnum].cur_slot = 0;
-	UDP_mdata_trace[sender_pnum].pkt_num[UDP_mdata_trace[sender_pnum].cur_slot] = pkt_num;
+	trace_slot = pkt_num;
 	UDP_mdata_trace[sender_pnum].pkt_num_torecv++;
 	if (UDP_mdata_trace[sender_pnum].pkt_num_torecv > UDP_MDATA_PKT_NUM_MAX)
 		UDP_mdata_trace[sender_pnum].pkt_num_torecv = UDP_MDATA_PKT_NUM_MIN;
@@ -5168,25 +5970,26 @@ void net_udp_noloss_got_ack(const uint8_t *data, uint_fast32_t data_len)
 	dest_pnum = data[len];												len++;
 	pkt_num = GET_INTEL_INT(&data[len]);										len += 4;
 
-	for (int i = 0; i < UDP_mdata_queue_highest; i++)
+	if (sender_pnum >= MAX_PLAYERS)
+		return;
+	const auto q = UDP_mdata_queue.find_ack(sender_pnum, pkt_num);
+	if (q && dest_pnum == q->Player_num)
 	{
-		if ((pkt_num == UDP_mdata_queue[i].pkt_num[sender_pnum]) && (dest_pnum == UDP_mdata_queue[i].Player_num))
-		{
-			con_printf(CON_VERBOSE, "P#%u: Got MData ACK for pkt_num %i from pnum %i for pnum %i",Player_num, pkt_num, sender_pnum, dest_pnum);
-			UDP_mdata_queue[i].player_ack[sender_pnum] = 1;
-			break;
-		}
+		con_printf(CON_VERBOSE, "P#%u: Got MData ACK for pkt_num %i from pnum %i for pnum %i",Player_num, pkt_num, sender_pnum, dest_pnum);
+		net_udp_noloss_set_ack(*q, sender_pnum);
 	}
 }
 
 /* Init/Free the queue. Call at start and end of a game or level. */
 void net_udp_noloss_init_mdata_queue(void)
 {
-	UDP_mdata_queue_highest=0;
 	con_printf(CON_VERBOSE, "P#%u: Clearing MData store/trace list",Player_num);
-	UDP_mdata_queue = {};
+	UDP_mdata_queue.clear();
 	for (int i = 0; i < MAX_PLAYERS; i++)
+	{
 		net_udp_noloss_clear_mdata_trace(i);
+		net_udp_pdata_clear(i);
+	}
 }
 
 /* Reset the trace list for given player when (dis)connect happens */
@@ -5194,14 +5997,13 @@ void net_udp_noloss_clear_mdata_trace(ubyte player_num)
 {
 	con_printf(CON_VERBOSE, "P#%u: Clearing trace list for %i",Player_num, player_num);
 	UDP_mdata_trace[player_num].pkt_num = {};
-	UDP_mdata_trace[player_num].cur_slot = 0;
 	UDP_mdata_trace[player_num].pkt_num_torecv = UDP_MDATA_PKT_NUM_MIN;
 	UDP_mdata_trace[player_num].pkt_num_tosend = UDP_MDATA_PKT_NUM_MIN;
 }
 
 /*
  * The main queue-process function.
- * Check if we can remove a packet from queue, and check if there are packets in queue which we need to re-send
+ * Check if there are packets in queue which we need to re-send, and check if we can remove packets from the queue
  */
 void net_udp_noloss_process_queue(fix64 time)
 {
@@ -5213,56 +6015,54 @@ void net_udp_noloss_process_queue(fix64 time)
 	if (!Netgame.PacketLossPrevention)
 		return;
 
-	for (int queuec = 0; queuec < UDP_mdata_queue_highest; queuec++)
+	// Resend packets which were not ACK'd in time. Send up to half our max packet size
+	uint32_t seq;
+	unsigned plc;
+	while (total_len < (UPID_MAX_SIZE/2) && UDP_mdata_queue.pop_due_resend(time, seq, plc))
 	{
-		int needack = 0;
-
-		// This might happen if we get out ACK's in the wrong order. So ignore that packet for now. It'll resolve itself.
-		if (!UDP_mdata_queue[queuec].used)
-			continue;
-
-		// Check if at least one connected player has not ACK'd the packet
-		for (unsigned plc = 0; plc < MAX_PLAYERS; ++plc)
+		auto &q = UDP_mdata_queue[seq];
+		if (net_udp_noloss_skip_ack(plc))
 		{
-			// If player is not playing anymore, we can remove him from list. Also remove *me* (even if that should have been done already). Also make sure Clients do not send to anyone else than Host
-			if ((vcplayerptr(plc)->connected != CONNECT_PLAYING || plc == Player_num) || (!multi_i_am_master() && plc > 0))
-				UDP_mdata_queue[queuec].player_ack[plc] = 1;
-
-			if (!UDP_mdata_queue[queuec].player_ack[plc])
-			{
-				// Resend if enough time has passed.
-				if (UDP_mdata_queue[queuec].pkt_timestamp[plc] + (F1_0/4) <= time)
-				{
-					ubyte buf[sizeof(UDP_mdata_info)];
-					int len = 0;
-					
-					con_printf(CON_VERBOSE, "P#%u: Resending pkt_num %i from pnum %i to pnum %i",Player_num, UDP_mdata_queue[queuec].pkt_num[plc], UDP_mdata_queue[queuec].Player_num, plc);
-					
-					UDP_mdata_queue[queuec].pkt_timestamp[plc] = time;
-					memset(&buf, 0, sizeof(UDP_mdata_info));
-					
-					// Prepare the packet and send it
-					buf[len] = UPID_MDATA_PNEEDACK;													len++;
-					buf[len] = UDP_mdata_queue[queuec].Player_num;								len++;
-					PUT_INTEL_INT(buf + len, UDP_mdata_queue[queuec].pkt_num[plc]);					len += 4;
-					memcpy(&buf[len], UDP_mdata_queue[queuec].data.data(), sizeof(char)*UDP_mdata_queue[queuec].data_size);
-																								len += UDP_mdata_queue[queuec].data_size;
-					dxx_sendto(Netgame.players[plc].protocol.udp.addr, UDP_Socket[0], buf, len, 0);
-					total_len += len;
-				}
-				needack++;
-			}
+			net_udp_noloss_set_ack(q, plc);
+			continue;
 		}
+		ubyte buf[sizeof(UDP_mdata_info)];
+		int len = 0;
+		
+		con_printf(CON_VERBOSE, "P#%u: Resending pkt_num %i from pnum %i to pnum %i",Player_num, q.pkt_num[plc], q.Player_num, plc);
+		
+		q.pkt_timestamp[plc] = time;
+		UDP_mdata_queue.schedule_resend(seq, plc);
+		memset(&buf, 0, sizeof(UDP_mdata_info));
+		
+		// Prepare the packet and send it
+		buf[len] = UPID_MDATA_PNEEDACK;													len++;
+		buf[len] = q.Player_num;								len++;
+		PUT_INTEL_INT(buf + len, q.pkt_num[plc]);					len += 4;
+		memcpy(&buf[len], q.data.data(), sizeof(char)*q.data_size);
+																					len += q.data_size;
+		dxx_sendto(Netgame.players[plc].protocol.udp.addr, UDP_Socket[0], buf, len, 0);
+		total_len += len;
+	}
 
-		// Check if we can remove that packet due to to it had no resend's or Timeout
-		if (needack==0 || (UDP_mdata_queue[queuec].pkt_initial_timestamp + UDP_TIMEOUT <= time))
+	// Remove packets from the top of the list which every player ACK'd, or which timed out. Packets are added in time order, so the first one which did not time out ends the search.
+	while (UDP_mdata_queue.size())
+	{
+		auto &q = UDP_mdata_queue.front();
+		if (q.used)
 		{
+			if (q.pkt_initial_timestamp + UDP_TIMEOUT > time)
+				break;
+			for (unsigned plc = 0; plc < MAX_PLAYERS; ++plc)
+				if (!q.player_ack[plc] && net_udp_noloss_skip_ack(plc))
+					net_udp_noloss_set_ack(q, plc);
+			const unsigned needack = q.needack;
 			if (needack) // packet timed out but still not all have ack'd.
 			{
 				if (multi_i_am_master()) // We are host, so we kick the remaining players.
 				{
 					for ( int plc=1; plc<N_players; plc++ )
-						if (UDP_mdata_queue[queuec].player_ack[plc] == 0)
+						if (q.player_ack[plc] == 0)
 							multi::udp::dispatch->kick_player(Netgame.players[plc].protocol.udp.addr, DUMP_PKTTIMEOUT);
 				}
 				else // We are client, so we gotta go.
@@ -5277,21 +6077,10 @@ void net_udp_noloss_process_queue(fix64 time)
 					game_leave_menus();
 				}
 			}
-			con_printf(CON_VERBOSE, "P#%u: Removing stored pkt_num [%i,%i,%i,%i,%i,%i,%i,%i] - missing ACKs: %i",Player_num, UDP_mdata_queue[queuec].pkt_num[0],UDP_mdata_queue[queuec].pkt_num[1],UDP_mdata_queue[queuec].pkt_num[2],UDP_mdata_queue[queuec].pkt_num[3],UDP_mdata_queue[queuec].pkt_num[4],UDP_mdata_queue[queuec].pkt_num[5],UDP_mdata_queue[queuec].pkt_num[6],UDP_mdata_queue[queuec].pkt_num[7], needack); // Just *marked* for removal. The actual process happens further below.
-			UDP_mdata_queue[queuec].used = 0;
+			con_printf(CON_VERBOSE, "P#%u: Removing stored pkt_num [%i,%i,%i,%i,%i,%i,%i,%i] - missing ACKs: %i",Player_num, q.pkt_num[0],q.pkt_num[1],q.pkt_num[2],q.pkt_num[3],q.pkt_num[4],q.pkt_num[5],q.pkt_num[6],q.pkt_num[7], needack);
+			q.used = 0;
 		}
-
-		// Send up to half our max packet size
-		if (total_len >= (UPID_MAX_SIZE/2))
-			break;
-	}
-
-	// Now that we are done processing the queue, actually remove all unused packets from the top of the list.
-	while (!UDP_mdata_queue[0].used && UDP_mdata_queue_highest > 0)
-	{
-		std::move(std::next(UDP_mdata_queue.begin()), UDP_mdata_queue.end(), UDP_mdata_queue.begin());
-		UDP_mdata_queue[UDP_MDATA_STOR_QUEUE_SIZE - 1] = {};
-		UDP_mdata_queue_highest--;
+		UDP_mdata_queue.pop_front();
 	}
 }
 /* CODE FOR PACKET LOSS PREVENTION - END */
@@ -5462,27 +6251,44 @@ void net_udp_process_mdata(uint8_t *data, uint_fast32_t data_len, const _sockadd
 	multi_process_bigdata(pnum, data+dataoffset, data_len-dataoffset );
 }
 
-void net_udp_send_pdata()
+static pdata_snapshot net_udp_pack_pdata_snapshot(const quaternionpos &qpp)
+{
+	return {{
+		qpp.orient.w, qpp.orient.x, qpp.orient.y, qpp.orient.z,
+		qpp.pos.x, qpp.pos.y, qpp.pos.z,
+		qpp.segment,
+		qpp.vel.x, qpp.vel.y, qpp.vel.z,
+		qpp.rotvel.x, qpp.rotvel.y, qpp.rotvel.z,
+	}};
+}
+
+static void net_udp_unpack_pdata_snapshot(const pdata_snapshot &s, quaternionpos &qpp)
+{
+	qpp.orient.w = s[0];
+	qpp.orient.x = s[1];
+	qpp.orient.y = s[2];
+	qpp.orient.z = s[3];
+	qpp.pos.x = s[4];
+	qpp.pos.y = s[5];
+	qpp.pos.z = s[6];
+	qpp.segment = s[7];
+	qpp.vel.x = s[8];
+	qpp.vel.y = s[9];
+	qpp.vel.z = s[10];
+	qpp.rotvel.x = s[11];
+	qpp.rotvel.y = s[12];
+	qpp.rotvel.z = s[13];
+}
+
+static void net_udp_send_pdata_full(const _sockaddr &addr, const unsigned subject, const uint8_t connected, const quaternionpos &qpp)
 {
-	auto &Objects = LevelUniqueObjectState.Objects;
-	auto &vmobjptr = Objects.vmptr;
 	std::array<uint8_t, 3 + quaternionpos::packed_size::value> buf;
 	int len = 0;
 
-	if (!(Game_mode&GM_NETWORK) || !UDP_Socket[0])
-		return;
-	auto &plr = get_local_player();
-	if (plr.connected != CONNECT_PLAYING)
-		return;
-	if ( !( Network_status == NETSTAT_PLAYING || Network_status == NETSTAT_ENDLEVEL ) )
-		return;
-
 	buf[len] = UPID_PDATA;									len++;
-	buf[len] = Player_num;									len++;
-	buf[len] = plr.connected;						len++;
+	buf[len] = subject;									len++;
+	buf[len] = connected;						len++;
 
-	quaternionpos qpp{};
-	create_quaternionpos(qpp, vmobjptr(plr.objnum));
 	PUT_INTEL_SHORT(&buf[len], qpp.orient.w);							len += 2;
 	PUT_INTEL_SHORT(&buf[len], qpp.orient.x);							len += 2;
 	PUT_INTEL_SHORT(&buf[len], qpp.orient.y);							len += 2;
@@ -5498,15 +6304,89 @@ void net_udp_send_pdata()
 	PUT_INTEL_INT(&buf[len], qpp.rotvel.y);							len += 4;
 	PUT_INTEL_INT(&buf[len], qpp.rotvel.z);							len += 4; // 46 + 3 = 49
 
+	dxx_sendto(addr, UDP_Socket[0], buf, 0);
+}
+
+/* Send the position of player `subject` to player `dest`, as a delta if
+ * `dest` understands it.
+ */
+static void net_udp_send_pdata_to(const unsigned dest, const unsigned subject, const uint8_t connected, const quaternionpos &qpp)
+{
+	const auto &addr = Netgame.players[dest].protocol.udp.addr;
+	auto &peer = UDP_pdata_peers[dest];
+	if (!peer.capable)
+	{
+		net_udp_send_pdata_full(addr, subject, connected, qpp);
+		return;
+	}
+	static const pdata_snapshot keyframe{};
+	std::array<uint8_t, UPID_PDATA_DELTA_HEADER_SIZE + pdata_delta_max_size> buf;
+	int len = 0;
+	auto &link = peer.senders[subject];
+	const auto &&snapshot = net_udp_pack_pdata_snapshot(qpp);
+	const uint16_t seq = link.next_seq++;
+	/* If the ACK'd packet has left the history, so has the receiver's
+	 * copy, and only a keyframe can be decoded.  A keyframe names its own
+	 * sequence number as its baseline.
+	 */
+	const auto baseline = link.acked ? link.sent.find(link.acked_seq) : nullptr;
+
+	buf[len] = UPID_PDATA_DELTA;									len++;
+	buf[len] = subject;									len++;
+	buf[len] = connected;						len++;
+	PUT_INTEL_SHORT(&buf[len], seq);							len += 2;
+	PUT_INTEL_SHORT(&buf[len], baseline ? link.acked_seq : seq);							len += 2;
+	len += pdata_delta_encode(baseline ? *baseline : keyframe, snapshot, &buf[len]);
+	link.sent.store(seq, snapshot);
+
+	dxx_sendto(addr, UDP_Socket[0], buf.data(), len, 0);
+}
+
+void net_udp_send_pdata()
+{
+	auto &Objects = LevelUniqueObjectState.Objects;
+	auto &vmobjptr = Objects.vmptr;
+
+	if (!(Game_mode&GM_NETWORK) || !UDP_Socket[0])
+		return;
+	auto &plr = get_local_player();
+	if (plr.connected != CONNECT_PLAYING)
+		return;
+	if ( !( Network_status == NETSTAT_PLAYING || Network_status == NETSTAT_ENDLEVEL ) )
+		return;
+
+	quaternionpos qpp{};
+	create_quaternionpos(qpp, vmobjptr(plr.objnum));
+
 	if (multi_i_am_master())
 	{
 		for (unsigned i = 1; i < MAX_PLAYERS; ++i)
 			if (vcplayerptr(i)->connected != CONNECT_DISCONNECTED)
-				dxx_sendto(Netgame.players[i].protocol.udp.addr, UDP_Socket[0], buf, 0);
+				net_udp_send_pdata_to(i, Player_num, plr.connected, qpp);
 	}
 	else
 	{
-		dxx_sendto(Netgame.players[0].protocol.udp.addr, UDP_Socket[0], buf, 0);
+		net_udp_send_pdata_to(0, Player_num, plr.connected, qpp);
+	}
+}
+
+/* The host relays each player's position to the others, encoded for
+ * each of them.
+ */
+static void net_udp_relay_pdata(const UDP_frame_info &pd)
+{
+	const unsigned ppn = pd.Player_num;
+	if (ppn > 0 && ppn <= N_players && vcplayerptr(ppn)->connected == CONNECT_PLAYING) // some checking whether this packet is legal
+	{
+		for (unsigned i = 1; i < MAX_PLAYERS; ++i)
+		{
+			// not to sender or disconnected/waiting players - right.
+			if (i == ppn)
+				continue;
+			auto &iplr = *vcplayerptr(i);
+			if (iplr.connected != CONNECT_DISCONNECTED && iplr.connected != CONNECT_WAITING)
+				net_udp_send_pdata_to(i, ppn, pd.connected, pd.qpp);
+		}
 	}
 }
 
@@ -5527,7 +6407,10 @@ void net_udp_process_pdata(const uint8_t *data, uint_fast32_t data_len, const _s
 	if (data_len != UPID_PDATA_SIZE)
 		return;
 
-	if (sender_addr != Netgame.players[((multi_i_am_master())?(data[len]):(0))].protocol.udp.addr)
+	const unsigned peer = multi_i_am_master() ? data[len] : 0;
+	if (peer >= MAX_PLAYERS)
+		return;
+	if (sender_addr != Netgame.players[peer].protocol.udp.addr)
 		return;
 
 	pd.Player_num = data[len];								len++;
@@ -5546,25 +6429,180 @@ void net_udp_process_pdata(const uint8_t *data, uint_fast32_t data_len, const _s
 	pd.qpp.rotvel.x = GET_INTEL_INT(&data[len]);					len += 4;
 	pd.qpp.rotvel.y = GET_INTEL_INT(&data[len]);					len += 4;
 	pd.qpp.rotvel.z = GET_INTEL_INT(&data[len]);					len += 4;
+
+	/* A peer which sends full packets may not know that this player
+	 * understands deltas.  Say so now and then, without flooding a peer
+	 * which cannot use them.
+	 */
+	auto &p = UDP_pdata_peers[peer];
+	const fix64 time = timer_query();
+	if (time >= p.announce_time + F1_0)
+	{
+		p.announce_time = time;
+		p.ack_due = true;
+	}
 	
 	if (multi_i_am_master()) // I am host - must relay this packet to others!
+		net_udp_relay_pdata(pd);
+
+	net_udp_read_pdata_packet (&pd);
+}
+
+void net_udp_process_pdata_delta(const uint8_t *data, uint_fast32_t data_len, const _sockaddr &sender_addr)
+{
+	UDP_frame_info pd{};
+	int len = 0;
+
+	if ( !( Game_mode & GM_NETWORK && ( Network_status == NETSTAT_PLAYING || Network_status == NETSTAT_ENDLEVEL ) ) )
+		return;
+	if (data_len < UPID_PDATA_DELTA_HEADER_SIZE)
+		return;
+
+	len++;
+
+	const unsigned subject = data[len];
+	if (subject >= MAX_PLAYERS)
+		return;
+	const unsigned peer = multi_i_am_master() ? subject : 0;
+	if (sender_addr != Netgame.players[peer].protocol.udp.addr)
+		return;
+
+	pd.Player_num = data[len];								len++;
+	pd.connected = data[len];								len++;
+	const uint16_t seq = GET_INTEL_SHORT(&data[len]);					len += 2;
+	const uint16_t baseline_seq = GET_INTEL_SHORT(&data[len]);					len += 2;
+
+	static const pdata_snapshot keyframe{};
+	auto &r = UDP_pdata_received[subject];
+	UDP_pdata_peers[peer].ack_due = true;
+	const auto baseline = baseline_seq == seq ? &keyframe : r.received.find(baseline_seq);
+	if (!baseline)
+	{
+		con_printf(CON_VERBOSE, "P#%u: Missing PDATA baseline %u for pnum %u, requesting keyframe", Player_num, baseline_seq, subject);
+		r.need_keyframe = true;
+		return;
+	}
+	pdata_snapshot snapshot;
+	if (!pdata_delta_decode(*baseline, &data[len], data_len - len, snapshot))
+		return;
+	r.received.store(seq, snapshot);
+	// A late packet is kept as a possible baseline, but not applied over a newer one.
+	if (r.have_latest && static_cast<int16_t>(seq - r.latest_seq) <= 0)
+		return;
+	r.latest_seq = seq;
+	r.have_latest = true;
+	r.ack_pending = true;
+	net_udp_unpack_pdata_snapshot(snapshot, pd.qpp);
+
+	if (multi_i_am_master())
+		net_udp_relay_pdata(pd);
+
+	net_udp_read_pdata_packet (&pd);
+}
+
+/* ACK the newest PDATA from each player.  A client gets every player's
+ * PDATA from the host, so it sends one ACK for all of them.  The host
+ * gets each client's own PDATA from that client.
+ */
+void net_udp_send_pdata_acks()
+{
+	if (!(Game_mode&GM_NETWORK) || !UDP_Socket[0])
+		return;
+	const bool master = multi_i_am_master();
+	for (unsigned peer = 0; peer < MAX_PLAYERS; ++peer)
 	{
-		const unsigned ppn = pd.Player_num;
-		if (ppn > 0 && ppn <= N_players && vcplayerptr(ppn)->connected == CONNECT_PLAYING) // some checking whether this packet is legal
+		auto &p = UDP_pdata_peers[peer];
+		if (!p.ack_due)
+			continue;
+		p.ack_due = false;
+		if (peer == Player_num)
+			continue;
+		std::array<uint8_t, UPID_PDATA_ACK_SIZE_MAX> buf;
+		int len = 0;
+		buf[len] = UPID_PDATA_ACK;									len++;
+		buf[len] = Player_num;									len++;
+		buf[len] = 0;									len++;
+		for (unsigned subject = 0; subject < MAX_PLAYERS; ++subject)
 		{
-			for (unsigned i = 1; i < MAX_PLAYERS; ++i)
+			if (subject == Player_num || (master && subject != peer))
+				continue;
+			auto &r = UDP_pdata_received[subject];
+			if (r.need_keyframe)
 			{
-				// not to sender or disconnected/waiting players - right.
-				if (i == ppn)
-					continue;
-				auto &iplr = *vcplayerptr(i);
-				if (iplr.connected != CONNECT_DISCONNECTED && iplr.connected != CONNECT_WAITING)
-					dxx_sendto(Netgame.players[i].protocol.udp.addr, UDP_Socket[0], data, data_len, 0);
+				r.need_keyframe = false;
+				buf[len] = subject | 0x80;									len++;
+				PUT_INTEL_SHORT(&buf[len], uint16_t{0});							len += 2;
+			}
+			else if (r.ack_pending)
+			{
+				r.ack_pending = false;
+				buf[len] = subject;									len++;
+				PUT_INTEL_SHORT(&buf[len], r.latest_seq);							len += 2;
 			}
+			else
+				continue;
+			++buf[2];
 		}
+		dxx_sendto(Netgame.players[peer].protocol.udp.addr, UDP_Socket[0], buf.data(), len, 0);
 	}
+}
 
-	net_udp_read_pdata_packet (&pd);
+void net_udp_process_pdata_ack(const uint8_t *data, uint_fast32_t data_len, const _sockaddr &sender_addr)
+{
+	if (!(Game_mode & GM_NETWORK))
+		return;
+	if (data_len < 3)
+		return;
+	const unsigned peer = data[1];
+	if (peer >= MAX_PLAYERS || (!multi_i_am_master() && peer != 0))
+		return;
+	if (sender_addr != Netgame.players[peer].protocol.udp.addr)
+		return;
+	const unsigned count = data[2];
+	if (data_len != 3 + 3 * count)
+		return;
+	auto &p = UDP_pdata_peers[peer];
+	p.capable = true;
+	for (unsigned i = 0, len = 3; i < count; ++i, len += 3)
+	{
+		const unsigned subject = data[len] & 0x7f;
+		if (subject >= MAX_PLAYERS)
+			continue;
+		auto &link = p.senders[subject];
+		// The receiver lost the baseline, so the next packet is a keyframe.
+		if (data[len] & 0x80)
+		{
+			link.acked = false;
+			continue;
+		}
+		const uint16_t seq = GET_INTEL_SHORT(&data[len + 1]);
+		if (link.sent.find(seq) && (!link.acked || static_cast<int16_t>(seq - link.acked_seq) > 0))
+		{
+			link.acked_seq = seq;
+			link.acked = true;
+		}
+	}
+}
+
+/* Forget the delta state for a player when (dis)connect happens.  The
+ * player starts over with full packets until it ACKs again.
+ */
+void net_udp_pdata_clear(ubyte player_num)
+{
+	auto &p = UDP_pdata_peers[player_num];
+	range_for (auto &link, p.senders)
+	{
+		link.sent.clear();
+		link.acked = false;
+	}
+	p.announce_time = 0;
+	p.capable = false;
+	p.ack_due = false;
+	auto &r = UDP_pdata_received[player_num];
+	r.received.clear();
+	r.have_latest = false;
+	r.ack_pending = false;
+	r.need_keyframe = false;
 }
 
 void net_udp_read_pdata_packet(UDP_frame_info *pd)
@@ -5604,6 +6642,7 @@ void net_udp_read_pdata_packet(UDP_frame_info *pd)
 			multi_send_score();
 
 			net_udp_noloss_clear_mdata_trace(TheirPlayernum);
+			net_udp_pdata_clear(TheirPlayernum);
 		}
 	}
 
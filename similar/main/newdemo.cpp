@@ -29,7 +29,14 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include <stdarg.h>
 #include <errno.h>
 #include <ctype.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <type_traits>
+#include <vector>
 #include "d_range.h"
 
 #include "u_mem.h"
@@ -165,9 +172,137 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 
 const std::array<file_extension_t, 1> demo_file_extensions{{DEMO_EXT}};
 
+namespace {
+
+/* Demo recording writes many elements of a few bytes each per frame.
+ * They are collected in memory, and the collected bytes are written by
+ * a separate thread, so that the game thread never waits for the disk.
+ * The buffer is handed over at each recorded frame, or sooner if it
+ * grows past flush_size.  A failed write is reported by failed() on the
+ * game thread's next write.
+ */
+class demo_writer
+{
+	static constexpr std::size_t flush_size = 64 * 1024;
+	RAIIPHYSFS_File file;
+	std::vector<uint8_t> pending;
+	std::deque<std::vector<uint8_t>> queue;
+	std::vector<std::vector<uint8_t>> spare;
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable work, drained;
+	bool stopping = false;
+	std::atomic<bool> write_failed;
+	void run_thread();
+public:
+	demo_writer() :
+		write_failed(false)
+	{
+	}
+	~demo_writer()
+	{
+		close();
+	}
+	explicit operator bool() const
+	{
+		return static_cast<bool>(file);
+	}
+	bool failed() const
+	{
+		return write_failed.load(std::memory_order_relaxed);
+	}
+	bool open(const char *filename);
+	void write(const void *buffer, std::size_t size)
+	{
+		const auto p = reinterpret_cast<const uint8_t *>(buffer);
+		pending.insert(pending.end(), p, p + size);
+		if (pending.size() >= flush_size)
+			flush();
+	}
+	void flush();
+	bool close();
+};
+
+bool demo_writer::open(const char *const filename)
+{
+	close();
+	file = PHYSFSX_openWriteBuffered(filename);
+	if (!file)
+		return false;
+	write_failed.store(false, std::memory_order_relaxed);
+	stopping = false;
+	thread = std::thread(&demo_writer::run_thread, this);
+	return true;
+}
+
+void demo_writer::run_thread()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	for (;;)
+	{
+		work.wait(lock, [this]{ return stopping || !queue.empty(); });
+		if (queue.empty())
+			return;
+		auto chunk = std::move(queue.front());
+		queue.pop_front();
+		lock.unlock();
+		/* After a failure, drop the rest, as a failed write stopped
+		 * recording when the writes were not batched.
+		 */
+		if (!failed() && PHYSFS_write(file, chunk.data(), 1, chunk.size()) != static_cast<PHYSFS_sint64>(chunk.size()))
+			write_failed.store(true, std::memory_order_relaxed);
+		chunk.clear();
+		lock.lock();
+		spare.emplace_back(std::move(chunk));
+		if (queue.empty())
+			drained.notify_all();
+	}
+}
+
+void demo_writer::flush()
+{
+	if (pending.empty())
+		return;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		queue.emplace_back(std::move(pending));
+		if (spare.empty())
+			pending = {};
+		else
+		{
+			pending = std::move(spare.back());
+			spare.pop_back();
+		}
+	}
+	work.notify_one();
+	pending.reserve(flush_size);
+}
+
+/* Write everything that is left, and close the file.  Returns false if
+ * any write failed.
+ */
+bool demo_writer::close()
+{
+	if (!file)
+		return true;
+	flush();
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		drained.wait(lock, [this]{ return queue.empty(); });
+		stopping = true;
+	}
+	work.notify_one();
+	thread.join();
+	file.reset();
+	spare.clear();
+	return !failed();
+}
+
+}
+
 // In- and Out-files
 static RAIIPHYSFS_File infile;
-static RAIIPHYSFS_File outfile;
+static demo_writer outfile;
 
 // Some globals
 int Newdemo_state = 0;
@@ -196,6 +331,13 @@ static int nd_playback_v_framecount;
 static fix nd_playback_total, nd_recorded_total, nd_recorded_time;
 static sbyte nd_playback_v_style;
 static ubyte nd_playback_v_dead = 0, nd_playback_v_rear = 0;
+/* Where each signature was last read from the demo.  Entries are not
+ * removed when objects are, so newdemo_find_object checks an entry
+ * before it trusts it.
+ */
+static std::array<objnum_t, 1 << 16> nd_playback_v_signature_objnum;
+/* Set only while newdemo_read_next_frame reads a frame. */
+static std::vector<newdemo_scan_event> *nd_playback_v_scan_events;
 #if defined(DXX_BUILD_DESCENT_II)
 static ubyte nd_playback_v_guided = 0;
 int nd_playback_v_juststarted=0;
@@ -239,7 +381,7 @@ int newdemo_get_percent_done()	{
 		return (PHYSFS_tell(infile) * 100) / nd_playback_v_demosize;
 	}
 	if ( Newdemo_state == ND_STATE_RECORDING ) {
-		return PHYSFS_tell(outfile);
+		return Newdemo_num_written;
 	}
 	return 0;
 }
@@ -299,10 +441,20 @@ icobjptridx_t newdemo_find_object(object_signature_t signature)
 {
 	auto &Objects = LevelUniqueObjectState.Objects;
 	auto &vcobjptridx = Objects.vcptridx;
+	auto &cached = nd_playback_v_signature_objnum[static_cast<uint16_t>(signature)];
+	if (cached < Objects.get_count())
+	{
+		const auto &&objp = vcobjptridx(cached);
+		if (objp->type != OBJ_NONE && objp->signature == signature)
+			return objp;
+	}
 	range_for (const auto &&objp, vcobjptridx)
 	{
 		if ( (objp->type != OBJ_NONE) && (objp->signature == signature))
+		{
+			cached = objp;
 			return objp;
+		}
 	}
 	return object_none;
 }
@@ -313,19 +465,20 @@ namespace {
 
 static int _newdemo_write(const void *buffer, int elsize, int nelem )
 {
-	int num_written, total_size;
+	int total_size;
 
 	if (unlikely(nd_record_v_no_space))
 		return -1;
 
-	total_size = elsize * nelem;
-	nd_record_v_framebytes_written += total_size;
-	Newdemo_num_written += total_size;
 	Assert(outfile);
-	num_written = (PHYSFS_write)(outfile, buffer, elsize, nelem);
-
-	if (likely(num_written == nelem))
-		return num_written;
+	if (likely(!outfile.failed()))
+	{
+		total_size = elsize * nelem;
+		nd_record_v_framebytes_written += total_size;
+		Newdemo_num_written += total_size;
+		outfile.write(buffer, total_size);
+		return nelem;
+	}
 
 	nd_record_v_no_space=2;
 	newdemo_stop_recording();
@@ -619,6 +772,7 @@ static void nd_read_object(const vmobjptridx_t obj)
 	nd_read_short(&shortsig);
 	// It's OKAY! We made sure, obj->signature is never has a value which short cannot handle!!! We cannot do this otherwise, without breaking the demo format!
 	obj->signature = object_signature_t{static_cast<uint16_t>(shortsig)};
+	nd_playback_v_signature_objnum[static_cast<uint16_t>(shortsig)] = obj;
 	nd_read_shortpos(obj);
 
 #if defined(DXX_BUILD_DESCENT_II)
@@ -1158,6 +1312,9 @@ void newdemo_record_start_frame(fix frame_time )
 		return;
 	}
 
+	// Hand the previous frame to the writer thread.
+	outfile.flush();
+
 	// Make demo recording waste a bit less space.
 	// First check if if at least REC_DELAY has passed since last recorded frame. If yes, record frame and set nd_record_v_recordframe true.
 	// nd_record_v_recordframe will be used for various other frame-by-frame events to drop some unnecessary bytes.
@@ -2053,6 +2210,130 @@ static void newdemo_pop_ctrlcen_triggers()
 }
 
 namespace dsx {
+namespace {
+
+/* The playback state after one frame, so that a seek can start from
+ * the nearest keyframe instead of reading every frame from the start
+ * of the demo.  Objects are recorded in full in every frame, but walls,
+ * textures, player status and scores are recorded only when they
+ * change, so the keyframe holds all of those too.
+ *
+ * Keyframes are taken every demo_keyframe_interval frames as playback
+ * reads forward, so a seek back reads at most that many frames, and a
+ * seek forward past the frames read so far reads up to the target.
+ */
+struct demo_keyframe
+{
+	int framecount;
+	int level;
+	PHYSFS_sint64 offset;
+	std::vector<object> objects;
+	std::array<player, MAX_PLAYERS> players;
+	std::vector<std::array<unique_side, MAX_SIDES_PER_SEGMENT>> sides;
+	std::vector<wall> walls;
+	std::vector<active_door> active_doors;
+	std::vector<trigger> triggers;
+#if defined(DXX_BUILD_DESCENT_II)
+	std::vector<cloaking_wall> cloaking_walls;
+#endif
+	d_level_unique_control_center_state control_center;
+	std::array<int16_t, 2> team_kills;
+	unsigned n_players;
+	sbyte cntrlcen_destroyed;
+	ubyte dead, rear;
+#if defined(DXX_BUILD_DESCENT_II)
+	ubyte guided;
+#endif
+};
+
+constexpr int demo_keyframe_interval = 1024;
+static std::vector<demo_keyframe> nd_playback_v_keyframes;
+
+template <typename A, typename T>
+static void nd_save_array(const A &a, std::vector<T> &v)
+{
+	v.assign(a.begin(), a.begin() + a.get_count());
+}
+
+template <typename A, typename T>
+static void nd_restore_array(A &a, const std::vector<T> &v)
+{
+	std::copy(v.begin(), v.end(), a.begin());
+	a.set_count(v.size());
+}
+
+static bool demo_keyframe_before(const demo_keyframe &k, const int framecount)
+{
+	return k.framecount < framecount;
+}
+
+static void nd_capture_keyframe()
+{
+	if (nd_playback_v_framecount % demo_keyframe_interval)
+		return;
+	if (Newdemo_vcr_state != ND_STATE_PLAYBACK && Newdemo_vcr_state != ND_STATE_FASTFORWARD && Newdemo_vcr_state != ND_STATE_ONEFRAMEFORWARD)
+		return;
+	auto &keyframes = nd_playback_v_keyframes;
+	const auto i = std::lower_bound(keyframes.begin(), keyframes.end(), nd_playback_v_framecount, demo_keyframe_before);
+	if (i != keyframes.end() && i->framecount == nd_playback_v_framecount)
+		return;
+	auto &Objects = LevelUniqueObjectState.Objects;
+	auto &k = *keyframes.emplace(i);
+	k.framecount = nd_playback_v_framecount;
+	k.level = Current_level_num;
+	k.offset = PHYSFS_tell(infile);
+	nd_save_array(Objects, k.objects);
+	std::copy(Players.begin(), Players.end(), k.players.begin());
+	range_for (const unique_segment &useg, vcsegptr)
+		k.sides.emplace_back(useg.sides);
+	nd_save_array(LevelUniqueWallSubsystemState.Walls, k.walls);
+	nd_save_array(LevelUniqueWallSubsystemState.ActiveDoors, k.active_doors);
+	nd_save_array(LevelUniqueWallSubsystemState.Triggers, k.triggers);
+#if defined(DXX_BUILD_DESCENT_II)
+	nd_save_array(LevelUniqueWallSubsystemState.CloakingWalls, k.cloaking_walls);
+#endif
+	k.control_center = LevelUniqueObjectState.ControlCenterState;
+	k.team_kills = team_kills;
+	k.n_players = N_players;
+	k.cntrlcen_destroyed = nd_playback_v_cntrlcen_destroyed;
+	k.dead = nd_playback_v_dead;
+	k.rear = nd_playback_v_rear;
+#if defined(DXX_BUILD_DESCENT_II)
+	k.guided = nd_playback_v_guided;
+#endif
+}
+
+static void nd_restore_keyframe(const demo_keyframe &k)
+{
+	auto &Objects = LevelUniqueObjectState.Objects;
+	PHYSFS_seek(infile, k.offset);
+	nd_playback_v_framecount = k.framecount;
+	nd_playback_v_at_eof = 0;
+	nd_restore_array(Objects, k.objects);
+	obj_relink_all();
+	std::copy(k.players.begin(), k.players.end(), Players.begin());
+	auto side = k.sides.begin();
+	range_for (unique_segment &useg, vmsegptr)
+		useg.sides = *side++;
+	nd_restore_array(LevelUniqueWallSubsystemState.Walls, k.walls);
+	nd_restore_array(LevelUniqueWallSubsystemState.ActiveDoors, k.active_doors);
+	nd_restore_array(LevelUniqueWallSubsystemState.Triggers, k.triggers);
+#if defined(DXX_BUILD_DESCENT_II)
+	nd_restore_array(LevelUniqueWallSubsystemState.CloakingWalls, k.cloaking_walls);
+#endif
+	LevelUniqueObjectState.ControlCenterState = k.control_center;
+	team_kills = k.team_kills;
+	N_players = k.n_players;
+	nd_playback_v_cntrlcen_destroyed = k.cntrlcen_destroyed;
+	nd_playback_v_dead = k.dead;
+	nd_playback_v_rear = k.rear;
+#if defined(DXX_BUILD_DESCENT_II)
+	nd_playback_v_guided = k.guided;
+#endif
+}
+
+}
+
 static int newdemo_read_frame_information(int rewrite)
 {
 	auto &LevelUniqueControlCenterState = LevelUniqueObjectState.ControlCenterState;
@@ -2599,6 +2880,8 @@ static int newdemo_read_frame_information(int rewrite)
 				nd_write_byte(shield);
 				break;
 			}
+			if (nd_playback_v_scan_events)
+				nd_playback_v_scan_events->emplace_back(newdemo_scan_event{newdemo_scan_event::kind::shields, static_cast<uint8_t>(Player_num), shield});
 			if (shareware)
 				get_local_plrobj().shields = i2f(shield);
 			else
@@ -2912,6 +3195,8 @@ static int newdemo_read_frame_information(int rewrite)
 				nd_write_byte(pnum);
 				break;
 			}
+			if (nd_playback_v_scan_events)
+				nd_playback_v_scan_events->emplace_back(newdemo_scan_event{newdemo_scan_event::kind::death, pnum, 1});
 			auto &player_info = vmobjptr(vcplayerptr(static_cast<unsigned>(pnum))->objnum)->ctype.player_info;
 			if ((Newdemo_vcr_state == ND_STATE_REWINDING) || (Newdemo_vcr_state == ND_STATE_ONEFRAMEBACKWARD))
 				player_info.net_killed_total--;
@@ -2931,6 +3216,8 @@ static int newdemo_read_frame_information(int rewrite)
 				nd_write_byte(kill);
 				break;
 			}
+			if (nd_playback_v_scan_events)
+				nd_playback_v_scan_events->emplace_back(newdemo_scan_event{newdemo_scan_event::kind::kill, pnum, static_cast<int8_t>(kill)});
 			auto &player_info = vmobjptr(vcplayerptr(static_cast<unsigned>(pnum))->objnum)->ctype.player_info;
 			if ((Newdemo_vcr_state == ND_STATE_REWINDING) || (Newdemo_vcr_state == ND_STATE_ONEFRAMEBACKWARD)) {
 				player_info.net_kills_total -= kill;
@@ -3383,6 +3670,8 @@ static int newdemo_read_frame_information(int rewrite)
 		nm_messagebox(menu_title{nullptr}, 1, TXT_OK, "%s %s", TXT_DEMO_ERR_READING, TXT_DEMO_OLD_CORRUPT);
 		Current_mission.reset();
 	}
+	else if (done == 1 && !rewrite)
+		nd_capture_keyframe();
 
 	return done;
 }
@@ -3570,6 +3859,63 @@ window_event_result newdemo_goto_end(int to_rewrite)
 }
 }
 
+/* Move playback by `frames`, which may be negative, and pause.  Start
+ * from the newest keyframe at or before the target, if it is on the
+ * loaded level and is closer than the current frame, and read forward
+ * from there.
+ */
+window_event_result newdemo_seek_frames(const int frames)
+{
+	const int target = std::max(nd_playback_v_framecount + frames, 0);
+	auto &keyframes = nd_playback_v_keyframes;
+	const demo_keyframe *start = nullptr;
+	for (auto i = std::upper_bound(keyframes.begin(), keyframes.end(), target, [](const int framecount, const demo_keyframe &k) { return framecount < k.framecount; }); i != keyframes.begin();)
+		if ((--i)->level == Current_level_num)
+		{
+			start = &*i;
+			break;
+		}
+	if (start && (target < nd_playback_v_framecount || start->framecount > nd_playback_v_framecount))
+		nd_restore_keyframe(*start);
+	else if (target < nd_playback_v_framecount)
+	{
+		const auto result = newdemo_goto_beginning();
+		if (result == window_event_result::close)
+			return result;
+	}
+	Newdemo_vcr_state = ND_STATE_FASTFORWARD;
+	while (nd_playback_v_framecount < target)
+		if (newdemo_read_frame_information(0) == -1)
+		{
+			if (nd_playback_v_at_eof)
+				break;
+			newdemo_stop_playback();
+			return window_event_result::close;
+		}
+	Newdemo_vcr_state = ND_STATE_PAUSED;
+	/* The frames read on the way started their sounds. */
+	digi_stop_digi_sounds();
+	return window_event_result::handled;
+}
+
+bool newdemo_read_next_frame(fix &frame_time, std::vector<newdemo_scan_event> &events)
+{
+	/* The events about to be read belong to the frame whose header was
+	 * read last time.
+	 */
+	frame_time = nd_recorded_time;
+	Newdemo_vcr_state = ND_STATE_FASTFORWARD;
+	nd_playback_v_scan_events = &events;
+	const auto done = newdemo_read_frame_information(0);
+	nd_playback_v_scan_events = nullptr;
+	if (done == -1)
+	{
+		newdemo_stop_playback();
+		return false;
+	}
+	return true;
+}
+
 static window_event_result newdemo_back_frames(int frames)
 {
 	short last_frame_length;
@@ -3905,9 +4251,7 @@ void newdemo_start_recording()
 
 	PHYSFS_mkdir(DEMO_DIR); //always try making directory - could only exist in read-only path
 
-	outfile = PHYSFSX_openWriteBuffered(DEMO_FILENAME);
-
-	if (!outfile)
+	if (!outfile.open(DEMO_FILENAME))
 	{
 		Newdemo_state = ND_STATE_NORMAL;
 		nm_messagebox_str(menu_title{nullptr}, nm_messagebox_tie(TXT_OK), menu_subtitle{"Cannot open demo temp file"});
@@ -4088,7 +4432,9 @@ void newdemo_stop_recording()
 		newdemo_write_end();
 	}
 
-	outfile.reset();
+	// The end of the demo may have been lost after the last check.
+	if (!outfile.close())
+		nd_record_v_no_space = 2;
 	Newdemo_state = ND_STATE_NORMAL;
 	gr_palette_load( gr_palette );
 try_again:
@@ -4208,6 +4554,7 @@ void newdemo_start_playback(const char * filename)
 	if (!infile) {
 		return;
 	}
+	nd_playback_v_keyframes.clear();
 
 	nd_playback_v_bad_read = 0;
 	change_playernum_to(0);                 // force playernum to 0
@@ -4256,6 +4603,7 @@ namespace dsx {
 void newdemo_stop_playback()
 {
 	infile.reset();
+	nd_playback_v_keyframes.clear();
 	Newdemo_state = ND_STATE_NORMAL;
 	change_playernum_to(0);             //this is reality
 	get_local_player().callsign = nd_playback_v_save_callsign;
@@ -4286,8 +4634,7 @@ int newdemo_swap_endian(const char *filename)
 		goto read_error;
 
 	nd_playback_v_demosize = PHYSFS_fileLength(infile);	// should be exactly the same size
-	outfile = PHYSFSX_openWriteBuffered(DEMO_FILENAME);
-	if (!outfile)
+	if (!outfile.open(DEMO_FILENAME))
 	{
 		infile.reset();
 		goto read_error;
@@ -4301,7 +4648,7 @@ int newdemo_swap_endian(const char *filename)
 
 	if (newdemo_read_demo_start(PURPOSE_REWRITE)) {
 		infile.reset();
-		outfile.reset();
+		outfile.close();
 		swap_endian = 0;
 		return 0;
 	}
@@ -4312,9 +4659,8 @@ int newdemo_swap_endian(const char *filename)
 	newdemo_write_end();	// and write it
 
 	swap_endian = 0;
-	complete = nd_playback_v_demosize == Newdemo_num_written;
 	infile.reset();
-	outfile.reset();
+	complete = outfile.close() && nd_playback_v_demosize == Newdemo_num_written;
 
 	if (complete)
 	{
@@ -80,6 +80,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "d_levelstate.h"
 #include "partial_range.h"
 #include <utility>
+#include <vector>
 
 using std::min;
 using std::max;
@@ -148,14 +149,88 @@ void object_goto_next_viewer()
 }
 #endif
 
+namespace {
+
+/* The lists behind obj_list_of_type.  The first call in a frame rebuilds
+ * them, and obj_create keeps them current for the rest of the frame.
+ */
+struct object_type_lists
+{
+	std::array<std::vector<objnum_t>, MAX_OBJECT_TYPES> by_type;
+#if defined(DXX_BUILD_DESCENT_II)
+	std::vector<objnum_t> mines;
+#endif
+	fix64 built_time;
+	bool built = false;
+	void add(const object_base &obj, objnum_t objnum);
+	void rebuild(fvcobjptridx &vcobjptridx);
+};
+
+static object_type_lists Object_type_lists;
+
+void object_type_lists::add(const object_base &obj, const objnum_t objnum)
+{
+	const unsigned type = obj.type;
+	if (type >= by_type.size())
+		return;
+	by_type[type].emplace_back(objnum);
+#if defined(DXX_BUILD_DESCENT_II)
+	if (type == OBJ_WEAPON && is_proximity_bomb_or_player_smart_mine(get_weapon_id(obj)))
+		mines.emplace_back(objnum);
+#endif
+}
+
+void object_type_lists::rebuild(fvcobjptridx &vcobjptridx)
+{
+	range_for (auto &i, by_type)
+		i.clear();
+#if defined(DXX_BUILD_DESCENT_II)
+	mines.clear();
+#endif
+	range_for (const auto &&i, vcobjptridx)
+		add(*i, i);
+	built_time = GameTime64;
+	built = true;
+}
+
+static const object_type_lists &get_object_type_lists()
+{
+	auto &l = Object_type_lists;
+	if (!l.built || l.built_time != GameTime64)
+		l.rebuild(LevelUniqueObjectState.Objects.vcptridx);
+	return l;
+}
+
+}
+
+const std::vector<objnum_t> &obj_list_of_type(const object_type_t type)
+{
+	assert(type < MAX_OBJECT_TYPES);
+	return get_object_type_lists().by_type[type];
+}
+
+#if defined(DXX_BUILD_DESCENT_II)
+const std::vector<objnum_t> &obj_list_of_mines()
+{
+	return get_object_type_lists().mines;
+}
+#endif
+
+void obj_invalidate_type_lists()
+{
+	Object_type_lists.built = false;
+}
+
 imobjptridx_t obj_find_first_of_type(fvmobjptridx &vmobjptridx, const object_type_t type)
 {
-	range_for (const auto &&i, vmobjptridx)
+	imobjptridx_t first = object_none;
+	range_for (const auto i, obj_list_of_type(type))
 	{
-		if (i->type==type)
-			return i;
+		const auto &&o = vmobjptridx(i);
+		if (o->type == type && (first == object_none || i < static_cast<objnum_t>(first)))
+			first = o;
 	}
-	return object_none;
+	return first;
 }
 
 }
@@ -896,6 +971,7 @@ void init_objects()
 	obj_link_unchecked(Objects.vmptr, Objects.vmptridx(ConsoleObject), Segments.vmptridx(segment_first));	//put in the world in segment 0
 	LevelUniqueObjectState.num_objects = 1;						//just the player
 	Objects.set_count(1);
+	obj_invalidate_type_lists();
 }
 
 //after calling init_object(), the network code has grabbed specific
@@ -917,6 +993,7 @@ void special_reset_objects(d_level_unique_object_state &LevelUniqueObjectState)
 			if (i > Highest_object_index)
 				Objects.set_count(i + 1);
 	LevelUniqueObjectState.num_objects = num_objects;
+	obj_invalidate_type_lists();
 }
 
 //link the object into the list for its segment
@@ -978,7 +1055,7 @@ void obj_unlink(fvmobjptr &vmobjptr, fvmsegptr &vmsegptr, object_base &obj)
 imobjptridx_t obj_allocate(d_level_unique_object_state &LevelUniqueObjectState)
 {
 	auto &Objects = LevelUniqueObjectState.Objects;
-	if (LevelUniqueObjectState.num_objects >= Objects.size())
+	if (LevelUniqueObjectState.num_objects >= std::min<std::size_t>(LevelUniqueObjectState.object_limit, Objects.size()))
 		return object_none;
 
 	const auto objnum = LevelUniqueObjectState.free_obj_list[LevelUniqueObjectState.num_objects++];
@@ -1025,10 +1102,12 @@ static void free_object_slots(uint_fast32_t num_used)
 	auto &vmobjptr = Objects.vmptr;
 	std::array<object *, MAX_OBJECTS>	obj_list;
 	unsigned	num_already_free, num_to_free, olind = 0;
+	/* A level file can hold more objects than a multiplayer limit. */
+	const unsigned object_limit = std::max<unsigned>(LevelUniqueObjectState.object_limit, Highest_object_index + 1);
 
-	num_already_free = MAX_OBJECTS - Highest_object_index - 1;
+	num_already_free = object_limit - Highest_object_index - 1;
 
-	if (MAX_OBJECTS - num_already_free < num_used)
+	if (object_limit - num_already_free < num_used)
 		return;
 
 	range_for (const auto &&objp, vmobjptr)
@@ -1036,14 +1115,14 @@ static void free_object_slots(uint_fast32_t num_used)
 		if (objp->flags & OF_SHOULD_BE_DEAD)
 		{
 			num_already_free++;
-			if (MAX_OBJECTS - num_already_free < num_used)
+			if (object_limit - num_already_free < num_used)
 				return;
 		} else
 			switch (objp->type)
 			{
 				case OBJ_NONE:
 					num_already_free++;
-					if (MAX_OBJECTS - num_already_free < num_used)
+					if (object_limit - num_already_free < num_used)
 						return;
 					break;
 				case OBJ_WALL:
@@ -1070,7 +1149,7 @@ static void free_object_slots(uint_fast32_t num_used)
 
 	}
 
-	num_to_free = MAX_OBJECTS - num_used - num_already_free;
+	num_to_free = object_limit - num_used - num_already_free;
 
 	if (num_to_free > olind) {
 		num_to_free = olind;
@@ -1197,6 +1276,8 @@ imobjptridx_t obj_create(const object_type_t type, const unsigned id, vmsegptrid
 	}
 
 	obj_link_unchecked(Objects.vmptr, obj, segnum);
+	if (Object_type_lists.built)
+		Object_type_lists.add(*obj, obj);
 
 	//	Set (or not) persistent bit in phys_info.
 	if (obj->type == OBJ_WEAPON) {
@@ -1234,6 +1315,8 @@ imobjptridx_t obj_create_copy(const object &srcobj, const vmsegptridx_t newsegnu
 
 	obj_link_unchecked(Objects.vmptr, obj, newsegnum);
 	obj->signature = next(signature);
+	if (Object_type_lists.built)
+		Object_type_lists.add(*obj, obj);
 
 	//we probably should initialize sub-structures here
 
@@ -2034,8 +2117,9 @@ static window_event_result object_move_all()
 	auto &vmobjptridx = Objects.vmptridx;
 	auto result = window_event_result::ignored;
 
-	if (Highest_object_index > MAX_USED_OBJECTS)
-		free_object_slots(MAX_USED_OBJECTS);		//	Free all possible object slots.
+	const unsigned max_used_objects = LevelUniqueObjectState.object_limit - RESERVED_OBJECT_SLOTS;
+	if (Highest_object_index > max_used_objects)
+		free_object_slots(max_used_objects);		//	Free all possible object slots.
 
 	obj_delete_all_that_should_be_dead();
 
@@ -2130,6 +2214,7 @@ void reset_objects(d_level_unique_object_state &LevelUniqueObjectState, const un
 {
 	LevelUniqueObjectState.Debris_object_count = 0;
 	LevelUniqueObjectState.num_objects = n_objs;
+	obj_invalidate_type_lists();
 	assert(LevelUniqueObjectState.num_objects > 0);
 	auto &Objects = LevelUniqueObjectState.get_objects();
 	assert(LevelUniqueObjectState.num_objects < Objects.size());
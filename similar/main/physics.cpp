@@ -48,6 +48,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #endif
 
 #include "d_levelstate.h"
+#include "profile.h"
 #include "compiler-range_for.h"
 
 //Global variables for physics system
@@ -313,6 +314,7 @@ public:
 //Simulate a physics object for this frame
 window_event_result do_physics_sim(const vmobjptridx_t obj, const vms_vector &obj_previous_position, phys_visited_seglist *const phys_segs)
 {
+	const profile_scope profile{profile_zone::do_physics_sim};
 	auto &LevelSharedVertexState = LevelSharedSegmentState.get_vertex_state();
 	auto &Objects = LevelUniqueObjectState.Objects;
 	auto &Vertices = LevelSharedVertexState.get_vertices();
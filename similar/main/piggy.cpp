@@ -47,6 +47,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "gamemine.h"
 #include "textures.h"
 #include "texmerge.h"
+#include "texmap.h"
 #include "paging.h"
 #include "game.h"
 #include "text.h"
@@ -1453,6 +1454,12 @@ void piggy_bitmap_page_out_all()
 {
 	int i;
 	
+#if !DXX_USE_OGL
+	/* Queued texture maps may point into the bitmap cache, which the
+	 * next page-in overwrites.
+	 */
+	tmap_batch_flush();
+#endif
 	Piggy_bitmap_cache_next = 0;
 
 	texmerge_flush();
@@ -1325,6 +1325,11 @@ void write_player_file()
 
 	if ( Newdemo_state == ND_STATE_PLAYBACK )
 		return;
+	/* A dedicated host only reads its pilot, so the default pilot it
+	 * uses without -pilot never reaches the disk.
+	 */
+	if (CGameArg.MplDedicated)
+		return;
 
 	errno_ret = WriteConfigFile();
 
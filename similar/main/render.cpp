@@ -24,9 +24,13 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
  */
 
 #include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <condition_variable>
 #include <limits>
 #include <cstdlib>
+#include <mutex>
+#include <thread>
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
@@ -44,6 +48,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "wall.h"
 #include "texmerge.h"
 #include "3d.h"
+#include "common/3d/globvars.h"
 #include "gameseg.h"
 #include "vclip.h"
 #include "lighting.h"
@@ -59,9 +64,11 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #endif
 #include "args.h"
 
+#include "profile.h"
 #include "compiler-range_for.h"
 #include "d_levelstate.h"
 #include "d_range.h"
+#include "d_zip.h"
 #include "partial_range.h"
 #include "segiter.h"
 
@@ -111,7 +118,7 @@ int	Bottom_bitmap_num = 9;
 namespace dcx {
 
 //Global vars for window clip test
-int Window_clip_left,Window_clip_top,Window_clip_right,Window_clip_bot;
+thread_local int Window_clip_left,Window_clip_top,Window_clip_right,Window_clip_bot;
 
 }
 
@@ -211,13 +218,64 @@ static inline int is_alphablend_eclip(int eclip_num)
 	return eclip_num == ECLIP_NUM_FUELCEN;
 }
 
+// ----------------------------------------------------------------------------
+//	Light one corner of a face.  `l` is the static light from the side's uvls,
+//	and is replaced by the light for the software renderer.  Returns the colored
+//	light for OpenGL.
+static g3s_lrgb light_face_vertex(fix &l, const g3s_lrgb &Dlvpi, const bool need_flashing_lights, const fix Seismic_tremor_magnitude)
+{
+	g3s_lrgb dli;
+	dli.r = dli.g = dli.b = l;
+	//the uvl struct has static light already in it
+
+	//scale static light for destruction effect
+	if (need_flashing_lights)	//make lights flash
+		l = fixmul(flash_scale, l);
+	//add in dynamic light (from explosions, etc.)
+	l += (Dlvpi.r + Dlvpi.g + Dlvpi.b) / 3;
+	//saturate at max value
+	if (l > MAX_LIGHT)
+		l = MAX_LIGHT;
+
+	// And now the same for the ACTUAL (rgb) light we want to use
+
+	//scale static light for destruction effect
+	if (need_flashing_lights)	//make lights flash
+	{
+		dli.g = dli.b = fixmul(flash_scale, l);
+		dli.r = (!Seismic_tremor_magnitude && PlayerCfg.DynLightColor)
+			? fixmul(std::max(static_cast<double>(flash_scale), f0_5 * 1.5), l) // let the mine glow red a little
+			: dli.g;
+	}
+
+	// add light color
+	dli.r += Dlvpi.r;
+	dli.g += Dlvpi.g;
+	dli.b += Dlvpi.b;
+	// saturate at max value
+	if (dli.r > MAX_LIGHT)
+		dli.r = MAX_LIGHT;
+	if (dli.g > MAX_LIGHT)
+		dli.g = MAX_LIGHT;
+	if (dli.b > MAX_LIGHT)
+		dli.b = MAX_LIGHT;
+	if (PlayerCfg.AlphaEffects) // due to additive blending, transparent sprites will become invivible in font of white surfaces (lamps). Fix that with a little desaturation
+	{
+		dli.r *= .93;
+		dli.g *= .93;
+		dli.b *= .93;
+	}
+	return dli;
+}
+
 // ----------------------------------------------------------------------------
 //	Render a face.
 //	It would be nice to not have to pass in segnum and sidenum, but
 //	they are used for our hideously hacked in headlight system.
 //	vp is a pointer to vertex ids.
 //	tmap1, tmap2 are texture map ids.  tmap2 is the pasty one.
-static void render_face(grs_canvas &canvas, const shared_segment &segp, const unsigned sidenum, const unsigned nv, const std::array<vertnum_t, 4> &vp, const texture1_value tmap1, const texture2_value tmap2, std::array<g3s_uvl, 4> uvl_copy, const WALL_IS_DOORWAY_result_t wid_flags)
+//	corners are the indices in the side of the vertices in vp.
+static void render_face(grs_canvas &canvas, const vcsegptridx_t segp, const unsigned sidenum, const unsigned nv, const std::array<vertnum_t, 4> &vp, const std::array<uint8_t, 4> &corners, const texture1_value tmap1, const texture2_value tmap2, std::array<g3s_uvl, 4> uvl_copy, const WALL_IS_DOORWAY_result_t wid_flags)
 {
 	auto &LevelUniqueControlCenterState = LevelUniqueObjectState.ControlCenterState;
 	auto &TmapInfo = LevelUniqueTmapInfoState.TmapInfo;
@@ -233,15 +291,17 @@ static void render_face(grs_canvas &canvas, const shared_segment &segp, const un
 	}
 
 #if defined(DXX_BUILD_DESCENT_I)
-	(void)segp;
 	(void)wid_flags;
+#if !DXX_USE_OGL
+	(void)segp;
 #if !DXX_USE_EDITOR
 	(void)sidenum;
 #endif
+#endif
 #elif defined(DXX_BUILD_DESCENT_II)
 	//handle cloaked walls
 	if (wid_flags & WALL_IS_DOORWAY_FLAG::cloaked) {
-		const auto wall_num = segp.shared_segment::sides[sidenum].wall_num;
+		const auto wall_num = segp->shared_segment::sides[sidenum].wall_num;
 		auto &Walls = LevelUniqueWallSubsystemState.Walls;
 		auto &vcwallptr = Walls.vcptr;
 		gr_settransblend(canvas, vcwallptr(wall_num)->cloak_value, gr_blend::normal);
@@ -298,51 +358,7 @@ static void render_face(grs_canvas &canvas, const shared_segment &segp, const un
 	auto &Dynamic_light = LevelUniqueLightState.Dynamic_light;
 	//set light values for each vertex & build pointlist
 	range_for (const uint_fast32_t i, xrange(nv))
-	{
-		auto &dli = dyn_light[i];
-		auto &uvli = uvl_copy[i];
-		auto &Dlvpi = Dynamic_light[vp[i]];
-		dli.r = dli.g = dli.b = uvli.l;
-		//the uvl struct has static light already in it
-
-		//scale static light for destruction effect
-		if (need_flashing_lights)	//make lights flash
-			uvli.l = fixmul(flash_scale, uvli.l);
-		//add in dynamic light (from explosions, etc.)
-		uvli.l += (Dlvpi.r + Dlvpi.g + Dlvpi.b) / 3;
-		//saturate at max value
-		if (uvli.l > MAX_LIGHT)
-			uvli.l = MAX_LIGHT;
-
-		// And now the same for the ACTUAL (rgb) light we want to use
-
-		//scale static light for destruction effect
-		if (need_flashing_lights)	//make lights flash
-		{
-			dli.g = dli.b = fixmul(flash_scale, uvli.l);
-			dli.r = (!Seismic_tremor_magnitude && PlayerCfg.DynLightColor)
-				? fixmul(std::max(static_cast<double>(flash_scale), f0_5 * 1.5), uvli.l) // let the mine glow red a little
-				: dli.g;
-		}
-
-		// add light color
-		dli.r += Dlvpi.r;
-		dli.g += Dlvpi.g;
-		dli.b += Dlvpi.b;
-		// saturate at max value
-		if (dli.r > MAX_LIGHT)
-			dli.r = MAX_LIGHT;
-		if (dli.g > MAX_LIGHT)
-			dli.g = MAX_LIGHT;
-		if (dli.b > MAX_LIGHT)
-			dli.b = MAX_LIGHT;
-		if (PlayerCfg.AlphaEffects) // due to additive blending, transparent sprites will become invivible in font of white surfaces (lamps). Fix that with a little desaturation
-		{
-			dli.r *= .93;
-			dli.g *= .93;
-			dli.b *= .93;
-		}
-	}
+		dyn_light[i] = light_face_vertex(uvl_copy[i].l, Dynamic_light[vp[i]], need_flashing_lights, Seismic_tremor_magnitude);
 
 	bool alpha = false;
 	if (PlayerCfg.AlphaBlendEClips && is_alphablend_eclip(TmapInfo[get_texture_index(tmap1)].eclip_num)) // set nice transparency/blending for some special effects (if we do more, we should maybe use switch here)
@@ -351,18 +367,33 @@ static void render_face(grs_canvas &canvas, const shared_segment &segp, const un
 		gr_settransblend(canvas, GR_FADE_OFF, gr_blend::additive_c);
 	}
 
+#if DXX_USE_OGL
+	/* Faces of the level mesh set their light in the mesh when they
+	 * are queued, so only drawn sides are lit.
+	 */
+	const bool drawn_from_mesh =
 #if DXX_USE_EDITOR
-	if ((Render_only_bottom) && (sidenum == WBOTTOM))
-		g3_draw_tmap(canvas, nv, pointlist, uvl_copy, dyn_light, GameBitmaps[Textures[Bottom_bitmap_num].index]);
-	else
+		!(Render_only_bottom && sidenum == WBOTTOM) &&
+#endif
+		ogl_level_mesh_draw_tmap(canvas, segp, sidenum, corners, nv, dyn_light, *bm, bm2, get_texture_rotation_low(tmap2));
+	if (!drawn_from_mesh)
+#else
+	(void)corners;
+#endif
+	{
+#if DXX_USE_EDITOR
+		if ((Render_only_bottom) && (sidenum == WBOTTOM))
+			g3_draw_tmap(canvas, nv, pointlist, uvl_copy, dyn_light, GameBitmaps[Textures[Bottom_bitmap_num].index]);
+		else
 #endif
 
 #if DXX_USE_OGL
-		if (bm2){
-			g3_draw_tmap_2(canvas, nv, pointlist, uvl_copy, dyn_light, *bm, *bm2, get_texture_rotation_low(tmap2));
-		}else
+			if (bm2){
+				g3_draw_tmap_2(canvas, nv, pointlist, uvl_copy, dyn_light, *bm, *bm2, get_texture_rotation_low(tmap2));
+			}else
 #endif
-			g3_draw_tmap(canvas, nv, pointlist, uvl_copy, dyn_light, *bm);
+				g3_draw_tmap(canvas, nv, pointlist, uvl_copy, dyn_light, *bm);
+	}
 
 	if (alpha)
 		gr_settransblend(canvas, GR_FADE_OFF, gr_blend::normal); // revert any transparency / blending setting back to normal
@@ -371,6 +402,7 @@ static void render_face(grs_canvas &canvas, const shared_segment &segp, const un
 	if (Outline_mode) draw_outline(canvas, nv, &pointlist[0]);
 #endif
 }
+
 }
 }
 
@@ -449,7 +481,7 @@ static inline void check_render_face(grs_canvas &canvas, std::index_sequence<N..
 	const std::array<g3s_uvl, 4> uvl_copy{{
 		{uvlp[N].u, uvlp[N].v, uvlp[N].l}...
 	}};
-	render_face(canvas, segnum, sidenum, nv, vp, tmap1, tmap2, uvl_copy, wid_flags);
+	render_face(canvas, segnum, sidenum, nv, vp, {{N...}}, tmap1, tmap2, uvl_copy, wid_flags);
 	check_face(canvas, segnum, sidenum, facenum, nv, vp, tmap1, tmap2, uvl_copy);
 }
 
@@ -714,11 +746,32 @@ void render_start_frame()
 	++ s_current_generation;
 }
 
-//Given a lit of point numbers, rotate any that haven't been rotated this frame
-g3s_codes rotate_list(fvcvertptr &vcvertptr, const std::size_t nv, const vertnum_t *const pointnumlist)
+namespace {
+
+/* Rotated vertices, and the generation that marks which of them were
+ * rotated for the current traversal.  The frame being drawn uses
+ * Segment_points.  A prefetched traversal uses its own, so that several
+ * traversals can run at once.
+ */
+struct segment_point_table
+{
+	g3s_point *const points;
+	const uint16_t generation;
+	g3s_point &operator[](const vertnum_t pnum) const
+	{
+		return points[static_cast<std::size_t>(pnum)];
+	}
+};
+
+static segment_point_table get_frame_segment_points()
+{
+	return {Segment_points.data(), s_current_generation};
+}
+
+static g3s_codes rotate_points(fvcvertptr &vcvertptr, const segment_point_table &points, const std::size_t nv, const vertnum_t *const pointnumlist)
 {
 	g3s_codes cc;
-	const auto current_generation = s_current_generation;
+	const auto current_generation = points.generation;
 	const auto cheats_acid = cheats.acid;
 	const float f = likely(!cheats_acid)
 		? 0.0f /* unused */
@@ -726,7 +779,7 @@ g3s_codes rotate_list(fvcvertptr &vcvertptr, const std::size_t nv, const vertnum
 
 	range_for (const auto pnum, unchecked_partial_range(pointnumlist, nv))
 	{
-		auto &pnt = Segment_points[pnum];
+		auto &pnt = points[pnum];
 		if (pnt.p3_last_generation != current_generation)
 		{
 			pnt.p3_last_generation = current_generation;
@@ -748,17 +801,23 @@ g3s_codes rotate_list(fvcvertptr &vcvertptr, const std::size_t nv, const vertnum
 
 }
 
-namespace {
 //Given a lit of point numbers, project any that haven't been projected
-static void project_list(const std::array<vertnum_t, 8> &pointnumlist)
+static void project_list(const segment_point_table &points, const std::array<vertnum_t, 8> &pointnumlist)
 {
 	range_for (const auto pnum, pointnumlist)
 	{
-		auto &p = Segment_points[pnum];
+		auto &p = points[pnum];
 		if (!(p.p3_flags & PF_PROJECTED))
 			g3_project_point(p);
 	}
 }
+
+}
+
+//Given a lit of point numbers, rotate any that haven't been rotated this frame
+g3s_codes rotate_list(fvcvertptr &vcvertptr, const std::size_t nv, const vertnum_t *const pointnumlist)
+{
+	return rotate_points(vcvertptr, get_frame_segment_points(), nv, pointnumlist);
 }
 
 
@@ -1006,15 +1065,9 @@ static void sort_seg_children(fvcvertptr &vcvertptr, const vms_vector &Viewer_ey
 
 static void add_obj_to_seglist(render_state_t &rstate, objnum_t objnum, segnum_t segnum)
 {
-	auto p = rstate.render_seg_map.emplace(segnum, render_state_t::per_segment_state_t{});
-	auto &o = p.first->second.objects;
-	if (p.second)
-		o.reserve(16);
-	o.emplace_back(render_state_t::per_segment_state_t::distant_object{objnum});
+	rstate.render_seg_map[segnum].objects.emplace_back(render_state_t::per_segment_state_t::distant_object{objnum});
 }
 
-using visited_twobit_array_t = visited_segment_mask_t<2>;
-
 class render_compare_context_t
 {
 	typedef render_state_t::per_segment_state_t::distant_object distant_object;
@@ -1273,28 +1326,30 @@ void update_rendered_data(window_rendered_data &window, const object &viewer, in
 namespace {
 //build a list of segments to be rendered
 //fills in Render_list & N_render_segs
-static void build_segment_list(render_state_t &rstate, const vms_vector &Viewer_eye, visited_twobit_array_t &visited, unsigned &first_terminal_seg, const vcsegidx_t start_seg_num)
+//This reads the level, and writes only to `rstate` and `points`, so
+//traversals with different states and points may run at once.
+static void build_segment_list(render_state_t &rstate, const segment_point_table &points, const vms_vector &Viewer_eye, const vcsegidx_t start_seg_num, const int canvas_width, const int canvas_height)
 {
+	const profile_scope profile{profile_zone::build_segment_list};
 	auto &LevelSharedVertexState = LevelSharedSegmentState.get_vertex_state();
 	auto &Vertices = LevelSharedVertexState.get_vertices();
 	int	lcnt,scnt,ecnt;
 	int	l;
 
-	rstate.render_pos.fill(-1);
+	rstate.render_seg_map.reset(Segments.get_count());
 
 	lcnt = scnt = 0;
 
 	rstate.Render_list[lcnt] = start_seg_num;
-	visited[start_seg_num]=1;
 	lcnt++;
 	ecnt = lcnt;
-	rstate.render_pos[start_seg_num] = 0;
 	{
 		auto &rsm_start_seg = rstate.render_seg_map[start_seg_num];
+		rsm_start_seg.render_pos = 0;
 		auto &rw = rsm_start_seg.render_window;
 		rw.left = rw.top = 0;
-		rw.right = grd_curcanv->cv_bitmap.bm_w-1;
-		rw.bot = grd_curcanv->cv_bitmap.bm_h-1;
+		rw.right = canvas_width - 1;
+		rw.bot = canvas_height - 1;
 	}
 
 	//breadth-first renderer
@@ -1322,7 +1377,7 @@ static void build_segment_list(render_state_t &rstate, const vms_vector &Viewer_
 			processed = true;
 
 			const auto &&seg = vcsegptridx(segnum);
-			const auto uor = rotate_list(vcvertptr, seg->verts).uor & CC_BEHIND;
+			const auto uor = rotate_points(vcvertptr, points, seg->verts.size(), seg->verts.data()).uor & CC_BEHIND;
 
 			//look at all sides of this segment.
 			//tricky code to look at sides in correct order follows
@@ -1336,7 +1391,7 @@ static void build_segment_list(render_state_t &rstate, const vms_vector &Viewer_
 					if (auto codes_and = uor)
 					{
 						range_for (const auto i, Side_to_verts[c])
-							codes_and &= Segment_points[seg->verts[i]].p3_codes;
+							codes_and &= points[seg->verts[i]].p3_codes;
 						if (codes_and)
 							continue;
 					}
@@ -1349,7 +1404,7 @@ static void build_segment_list(render_state_t &rstate, const vms_vector &Viewer_
 			//now order the sides in some magical way
 			const auto &&child_range = partial_range(child_list, n_children);
 			sort_seg_children(vcvertptr, Viewer_eye, seg, child_range);
-			project_list(seg->verts);
+			project_list(points, seg->verts);
 			range_for (const auto siden, child_range)
 			{
 				const auto ch = seg->shared_segment::children[siden];
@@ -1360,7 +1415,7 @@ static void build_segment_list(render_state_t &rstate, const vms_vector &Viewer_
 						uint8_t codes_and_3d = 0xff, codes_and_2d = codes_and_3d;
 						range_for (const auto i, Side_to_verts[siden])
 						{
-							g3s_point *pnt = &Segment_points[seg->verts[i]];
+							g3s_point *pnt = &points[seg->verts[i]];
 
 							if (! (pnt->p3_flags&PF_PROJECTED)) {no_proj_flag=1; break;}
 
@@ -1375,7 +1430,8 @@ static void build_segment_list(render_state_t &rstate, const vms_vector &Viewer_
 							codes_and_2d &= code_window_point(_x,_y,check_w);
 						}
 						if (no_proj_flag || (!codes_and_3d && !codes_and_2d)) {	//maybe add this segment
-							auto rp = rstate.render_pos[ch];
+							auto &chrsm = rstate.render_seg_map[ch];
+							const auto rp = chrsm.render_pos;
 							rect nw;
 
 							if (no_proj_flag)
@@ -1403,7 +1459,7 @@ static void build_segment_list(render_state_t &rstate, const vms_vector &Viewer_
 
 									{
 										//no_render_flag[lcnt] = 1;
-										rstate.render_seg_map[ch].processed = false;		//force reprocess
+										chrsm.processed = false;		//force reprocess
 										rstate.Render_list[lcnt] = segment_none;
 										old_w = nw;		//get updated window
 										goto no_add;
@@ -1411,16 +1467,12 @@ static void build_segment_list(render_state_t &rstate, const vms_vector &Viewer_
 								}
 								else goto no_add;
 							}
-							rstate.render_pos[ch] = lcnt;
+							chrsm.render_pos = lcnt;
 							rstate.Render_list[lcnt] = ch;
-							{
-								auto &chrsm = rstate.render_seg_map[ch];
-								chrsm.Seg_depth = l;
-								chrsm.render_window = nw;
-							}
+							chrsm.Seg_depth = l;
+							chrsm.render_window = nw;
 							lcnt++;
 							if (lcnt >= MAX_RENDER_SEGS) {goto done_list;}
-							visited[ch] = 1;
 no_add:
 	;
 
@@ -1436,15 +1488,258 @@ no_add:
 	}
 done_list:
 
-	first_terminal_seg = scnt;
+	rstate.first_terminal_seg = scnt;
 	rstate.N_render_segs = lcnt;
 
 }
+
+#if defined(DXX_BUILD_DESCENT_II)
+//everything that build_segment_list reads from the current view
+struct render_view_key
+{
+	vms_vector position;
+	vms_matrix matrix;
+	fix canvas_w2, canvas_h2;
+	segnum_t start_seg;
+	int depth;
+	static render_view_key current(const segnum_t start_seg)
+	{
+		return {View_position, View_matrix, Canv_w2, Canv_h2, start_seg, Render_depth};
+	}
+	bool operator==(const render_view_key &r) const
+	{
+		return start_seg == r.start_seg && depth == r.depth &&
+			canvas_w2 == r.canvas_w2 && canvas_h2 == r.canvas_h2 &&
+			!memcmp(&position, &r.position, sizeof(position)) &&
+			!memcmp(&matrix, &r.matrix, sizeof(matrix));
+	}
+};
+
+//a view that render_mine drew while a prefetch scope was active
+struct render_view_request
+{
+	const object *viewer;
+	object_signature_t signature;
+	bool rear;
+	int width, height;
+};
+
+struct prefetched_view
+{
+	render_view_request request;
+	render_view_key key;
+	bool ready = false;
+	uint16_t generation = 0;
+	std::vector<g3s_point> points;
+	render_state_t rstate;
+	void traverse();
+};
+
+/* Each view is traversed by one thread, with its own projection, view
+ * matrix and points.  The calling thread traverses views too, and no
+ * other code runs until all are done, so the level does not change
+ * under the traversals.
+ */
+class render_view_prefetch_t
+{
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable start_work, finished_work;
+	unsigned generation = 0;
+	unsigned busy_threads = 0;
+	unsigned view_count = 0;
+	bool stopping = false;
+	std::atomic<unsigned> next_view;
+	static constexpr std::size_t max_views = 4;
+	std::array<prefetched_view, max_views> views;
+	std::array<render_view_request, max_views> requests;
+	unsigned request_count = 0;
+	void run_views();
+	void run_thread();
+	void record(const object &viewer, bool rear, int width, int height);
+public:
+	bool recording = false;
+	void run();
+	void discard();
+	render_state_t *take(const object &viewer, bool rear, int width, int height, segnum_t start_seg);
+	void stop();
+};
+
+static render_view_prefetch_t render_view_prefetch;
+
+/* This matches the view that render_frame sets up for `eye_offset` 0.
+ */
+void prefetched_view::traverse()
+{
+	auto &viewer = *request.viewer;
+	auto &LevelSharedVertexState = LevelSharedSegmentState.get_vertex_state();
+	auto &Vertices = LevelSharedVertexState.get_vertices();
+	const auto &Viewer_eye = viewer.pos;
+	const auto &&viewer_segp = Segments.vcptridx(viewer.segnum);
+	auto start_seg_num = find_point_seg(LevelSharedSegmentState, Viewer_eye, viewer_segp);
+	if (start_seg_num == segment_none)
+		start_seg_num = viewer_segp;
+	g3_set_projection(request.width, request.height);
+	g3_set_view_matrix(Viewer_eye,
+		request.rear
+		? vm_matrix_x_matrix(viewer.orient, vm_angles_2_matrix(vms_angvec{0, 0, INT16_MAX}))
+		: viewer.orient, Render_zoom);
+	key = render_view_key::current(start_seg_num);
+	const std::size_t vertex_count = Vertices.get_count();
+	if (points.size() < vertex_count)
+		points.resize(vertex_count);
+	if (generation == std::numeric_limits<decltype(generation)>::max())
+	{
+		range_for (auto &p, points)
+			p.p3_last_generation = 0;
+		generation = 0;
+	}
+	++ generation;
+	build_segment_list(rstate, {points.data(), generation}, Viewer_eye, start_seg_num, request.width, request.height);
+	ready = true;
+}
+
+void render_view_prefetch_t::run_views()
+{
+	for (unsigned v; (v = next_view.fetch_add(1, std::memory_order_relaxed)) < view_count;)
+		views[v].traverse();
+}
+
+void render_view_prefetch_t::run_thread()
+{
+	unsigned seen = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			start_work.wait(lock, [this, seen]{ return stopping || generation != seen; });
+			if (stopping)
+				return;
+			seen = generation;
+		}
+		run_views();
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!--busy_threads)
+			finished_work.notify_one();
+	}
+}
+
+void render_view_prefetch_t::record(const object &viewer, const bool rear, const int width, const int height)
+{
+	/* The acid cheat moves the vertices with the time, so a traversal
+	 * done earlier in the frame would not match.
+	 */
+	if (!recording || request_count >= requests.size() || cheats.acid)
+		return;
+	requests[request_count++] = {&viewer, viewer.signature, rear, width, height};
+}
+
+/* Traverse the views recorded in the last scope whose viewer still
+ * exists.  A single view gains nothing from being traversed early, so
+ * it is left to render_mine.
+ */
+void render_view_prefetch_t::run()
+{
+	view_count = 0;
+	range_for (auto &r, partial_const_range(requests, request_count))
+	{
+		auto &viewer = *r.viewer;
+		if (viewer.type == OBJ_NONE || viewer.signature != r.signature || viewer.segnum == segment_none)
+			continue;
+		views[view_count++].request = r;
+	}
+	request_count = 0;
+	if (view_count < 2 || cheats.acid)
+	{
+		view_count = 0;
+		return;
+	}
+	if (threads.empty())
+	{
+		const unsigned cpus = std::thread::hardware_concurrency();
+		const unsigned helpers = cpus > 1 ? std::min<unsigned>(cpus, views.size()) - 1 : 0;
+		threads.reserve(helpers);
+		for (unsigned i = helpers; i--;)
+			threads.emplace_back(&render_view_prefetch_t::run_thread, this);
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		next_view.store(0, std::memory_order_relaxed);
+		busy_threads = threads.size();
+		++generation;
+	}
+	start_work.notify_all();
+	run_views();
+	std::unique_lock<std::mutex> lock(mutex);
+	finished_work.wait(lock, [this]{ return !busy_threads; });
+}
+
+void render_view_prefetch_t::discard()
+{
+	range_for (auto &v, partial_range(views, view_count))
+		v.ready = false;
+	view_count = 0;
+}
+
+/* Record the view for the next scope, and return the traversal of the
+ * current view, if one was prefetched.  Each traversal is used at most
+ * once, since render_mine adds the objects to it and marks its segments
+ * as drawn.
+ */
+render_state_t *render_view_prefetch_t::take(const object &viewer, const bool rear, const int width, const int height, const segnum_t start_seg)
+{
+	record(viewer, rear, width, height);
+	if (!view_count)
+		return nullptr;
+	const auto key = render_view_key::current(start_seg);
+	range_for (auto &v, partial_range(views, view_count))
+		if (v.ready && v.key == key)
+		{
+			v.ready = false;
+			return &v.rstate;
+		}
+	return nullptr;
 }
 
+void render_view_prefetch_t::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	start_work.notify_all();
+	range_for (auto &t, threads)
+		t.join();
+	threads.clear();
+	stopping = false;
+}
+#endif
+
+}
+
+#if defined(DXX_BUILD_DESCENT_II)
+render_view_prefetch_scope::render_view_prefetch_scope()
+{
+	render_view_prefetch.run();
+	render_view_prefetch.recording = true;
+}
+
+render_view_prefetch_scope::~render_view_prefetch_scope()
+{
+	render_view_prefetch.recording = false;
+	render_view_prefetch.discard();
+}
+
+void render_view_prefetch_close()
+{
+	render_view_prefetch.stop();
+}
+#endif
+
 //renders onto current canvas
 void render_mine(grs_canvas &canvas, const vms_vector &Viewer_eye, const vcsegidx_t start_seg_num, const fix eye_offset, window_rendered_data &window)
 {
+	const profile_scope profile{profile_zone::render_mine};
 	auto &LevelSharedVertexState = LevelSharedSegmentState.get_vertex_state();
 	auto &Objects = LevelUniqueObjectState.Objects;
 	auto &Vertices = LevelSharedVertexState.get_vertices();
@@ -1457,7 +1752,6 @@ void render_mine(grs_canvas &canvas, const vms_vector &Viewer_eye, const vcsegid
 	auto &vcwallptr = Walls.vcptr;
 #endif
 	using std::advance;
-	render_state_t rstate;
 	#ifndef NDEBUG
 	object_rendered = {};
 	#endif
@@ -1466,22 +1760,41 @@ void render_mine(grs_canvas &canvas, const vms_vector &Viewer_eye, const vcsegid
 
 	render_start_frame();
 
-	visited_twobit_array_t visited;
-
-	unsigned first_terminal_seg;
+	/* The state is kept from frame to frame, so that its tables are
+	 * allocated only once.
+	 */
+	static render_state_t frame_rstate;
+	render_state_t *rstatep = &frame_rstate;
 #if DXX_USE_EDITOR
 #if defined(DXX_BUILD_DESCENT_I)
-	if (_search_mode || eye_offset>0)
+	const bool editor_search = _search_mode || eye_offset>0;
 #elif defined(DXX_BUILD_DESCENT_II)
-	if (_search_mode)
+	const bool editor_search = _search_mode;
 #endif
+	if (editor_search)
 	{
-		first_terminal_seg = 0;
+		frame_rstate.render_seg_map.reset(Segments.get_count());
+		frame_rstate.N_render_segs = 0;
+		frame_rstate.first_terminal_seg = 0;
 	}
 	//else
-	#endif
+#else
+	constexpr bool editor_search = false;
+#endif
+	/* The list is still built in the editor's search mode; only a
+	 * prefetched list replaces it.
+	 */
+#if defined(DXX_BUILD_DESCENT_II)
+	if (const auto prefetched = editor_search || eye_offset ? nullptr : render_view_prefetch.take(*Viewer, Rear_view && Viewer == ConsoleObject, canvas.cv_bitmap.bm_w, canvas.cv_bitmap.bm_h, start_seg_num))
+		rstatep = prefetched;
+	else
+#else
+	(void)editor_search;
+#endif
 		//NOTE LINK TO ABOVE!!	-Link killed by kreatordxx to get editor selection working again
-		build_segment_list(rstate, Viewer_eye, visited, first_terminal_seg, start_seg_num);		//fills in Render_list & N_render_segs
+		build_segment_list(frame_rstate, get_frame_segment_points(), Viewer_eye, start_seg_num, canvas.cv_bitmap.bm_w, canvas.cv_bitmap.bm_h);		//fills in Render_list & N_render_segs
+	auto &rstate = *rstatep;
+	const auto first_terminal_seg = rstate.first_terminal_seg;
 
 	const auto &&render_range = partial_const_range(rstate.Render_list, rstate.N_render_segs);
 	const auto &&reversed_render_range = render_range.reversed();
@@ -1522,13 +1835,20 @@ void render_mine(grs_canvas &canvas, const vms_vector &Viewer_eye, const vcsegid
 		}
 	}
 #if !DXX_USE_OGL
+	/* Texture maps are queued and drawn on all threads when the scope
+	 * ends, or earlier if something other than a texture map is drawn.
+	 * Search mode reads back the canvas, so it must draw immediately.
+	 */
+	const tmap_batch_scope tmap_batch(!_search_mode);
 	range_for (const auto segnum, reversed_render_range)
 	{
 		// Interpolation_method = 0;
+		if (segnum == segment_none)
+			continue;
 		auto &srsm = rstate.render_seg_map[segnum];
 
 		//if (!no_render_flag[nn])
-		if (segnum!=segment_none && (_search_mode || visited[segnum]!=3)) {
+		if (_search_mode || !srsm.rendered) {
 			//set global render window vars
 
 			Current_seg_depth = srsm.Seg_depth;
@@ -1541,7 +1861,7 @@ void render_mine(grs_canvas &canvas, const vms_vector &Viewer_eye, const vcsegid
 			}
 
 			render_segment(vcvertptr, vcwallptr, Viewer_eye, *grd_curcanv, vcsegptridx(segnum));
-			visited[segnum]=3;
+			srsm.rendered = true;
 			if (srsm.objects.empty())
 				continue;
 
@@ -1572,48 +1892,68 @@ void render_mine(grs_canvas &canvas, const vms_vector &Viewer_eye, const vcsegid
 	auto &Walls = LevelUniqueWallSubsystemState.Walls;
 	auto &vcwallptr = Walls.vcptr;
         // First Pass: render opaque level geometry and level geometry with alpha pixels (high Alpha-Test func)
-	range_for (const auto segnum, reversed_render_range)
 	{
-		auto &srsm = rstate.render_seg_map[segnum];
+		/* Texture maps are queued and drawn in batches.  The queue is drawn
+		 * before glAlphaFunc changes, and when the scope ends.
+		 */
+		const ogl_tmap_batch_scope tmap_batch;
+		/* Opaque faces are drawn from the level mesh, unless the editor
+		 * may have moved vertices, or the acid cheat moves them every
+		 * frame.
+		 */
+		if (
+#if DXX_USE_EDITOR
+			!EditorWindow &&
+#endif
+			!cheats.acid)
+			ogl_level_mesh_begin_view();
+		range_for (const auto segnum, reversed_render_range)
+		{
+			if (segnum == segment_none)
+				continue;
+			auto &srsm = rstate.render_seg_map[segnum];
 
-		if (segnum!=segment_none && (_search_mode || visited[segnum]!=3)) {
-			//set global render window vars
+			if (_search_mode || !srsm.rendered) {
+				//set global render window vars
 
-			{
-				const auto &rw = srsm.render_window;
-				Window_clip_left  = rw.left;
-				Window_clip_top   = rw.top;
-				Window_clip_right = rw.right;
-				Window_clip_bot   = rw.bot;
-			}
+				{
+					const auto &rw = srsm.render_window;
+					Window_clip_left  = rw.left;
+					Window_clip_top   = rw.top;
+					Window_clip_right = rw.right;
+					Window_clip_bot   = rw.bot;
+				}
 
-			// render segment
-			{
-				const auto &&seg = vcsegptridx(segnum);
-				Assert(segnum!=segment_none && segnum<=Highest_segment_index);
-				if (!rotate_list(vcvertptr, seg->verts).uand)
-				{		//all off screen?
+				// render segment
+				{
+					const auto &&seg = vcsegptridx(segnum);
+					Assert(segnum!=segment_none && segnum<=Highest_segment_index);
+					if (!rotate_list(vcvertptr, seg->verts).uand)
+					{		//all off screen?
 
-					if (Viewer->type!=OBJ_ROBOT)
-						LevelUniqueAutomapState.Automap_visited[segnum] = 1;
+						if (Viewer->type!=OBJ_ROBOT)
+							LevelUniqueAutomapState.Automap_visited[segnum] = 1;
 
-					range_for (const uint_fast32_t sn, xrange(MAX_SIDES_PER_SEGMENT))
-					{
-						const auto wid = WALL_IS_DOORWAY(GameBitmaps, Textures, vcwallptr, seg, sn);
-						if (wid == WID_TRANSPARENT_WALL || wid == WID_TRANSILLUSORY_WALL
+						range_for (const uint_fast32_t sn, xrange(MAX_SIDES_PER_SEGMENT))
+						{
+							const auto wid = WALL_IS_DOORWAY(GameBitmaps, Textures, vcwallptr, seg, sn);
+							if (wid == WID_TRANSPARENT_WALL || wid == WID_TRANSILLUSORY_WALL
 #if defined(DXX_BUILD_DESCENT_II)
-							|| (wid & WALL_IS_DOORWAY_FLAG::cloaked)
+								|| (wid & WALL_IS_DOORWAY_FLAG::cloaked)
 #endif
-							)
-						{
-							if (PlayerCfg.AlphaBlendEClips && is_alphablend_eclip(TmapInfo[get_texture_index(seg->unique_segment::sides[sn].tmap_num)].eclip_num)) // Do NOT render geometry with blending textures. Since we've not rendered any objects, yet, they would disappear behind them.
-                                                                continue;
-							glAlphaFunc(GL_GEQUAL,0.8); // prevent ugly outlines if an object (which is rendered later) is shown behind a grate, door, etc. if texture filtering is enabled. These sides are rendered later again with normal AlphaFunc
-							render_side(vcvertptr, canvas, seg, sn, wid, Viewer_eye);
-							glAlphaFunc(GL_GEQUAL,0.02);
+								)
+							{
+								if (PlayerCfg.AlphaBlendEClips && is_alphablend_eclip(TmapInfo[get_texture_index(seg->unique_segment::sides[sn].tmap_num)].eclip_num)) // Do NOT render geometry with blending textures. Since we've not rendered any objects, yet, they would disappear behind them.
+	                                                                continue;
+								ogl_tmap_batch_flush();
+								glAlphaFunc(GL_GEQUAL,0.8); // prevent ugly outlines if an object (which is rendered later) is shown behind a grate, door, etc. if texture filtering is enabled. These sides are rendered later again with normal AlphaFunc
+								render_side(vcvertptr, canvas, seg, sn, wid, Viewer_eye);
+								ogl_tmap_batch_flush();
+								glAlphaFunc(GL_GEQUAL,0.02);
+							}
+							else
+								render_side(vcvertptr, canvas, seg, sn, wid, Viewer_eye);
 						}
-						else
-							render_side(vcvertptr, canvas, seg, sn, wid, Viewer_eye);
 					}
 				}
 			}
@@ -1623,9 +1963,11 @@ void render_mine(grs_canvas &canvas, const vms_vector &Viewer_eye, const vcsegid
         // Second pass: Render objects and level geometry with alpha pixels (normal Alpha-Test func) and eclips with blending
 	range_for (const auto segnum, reversed_render_range)
 	{
+		if (segnum == segment_none)
+			continue;
 		auto &srsm = rstate.render_seg_map[segnum];
 
-		if (segnum!=segment_none && (_search_mode || visited[segnum]!=3)) {
+		if (_search_mode || !srsm.rendered) {
 			//set global render window vars
 
 			{
@@ -1660,7 +2002,7 @@ void render_mine(grs_canvas &canvas, const vms_vector &Viewer_eye, const vcsegid
 					}
 				}
 			}
-			visited[segnum]=3;
+			srsm.rendered = true;
 			if (srsm.objects.empty())
 				continue;
 			{		//reset for objects
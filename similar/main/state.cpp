@@ -83,11 +83,11 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include <utility>
 
 #if defined(DXX_BUILD_DESCENT_I)
-#define STATE_VERSION 7
+#define STATE_VERSION 8
 #define STATE_MATCEN_VERSION 25 // specific version of metcen info written into D1 savegames. Currenlty equal to GAME_VERSION (see gamesave.cpp). If changed, then only along with STATE_VERSION.
 #define STATE_COMPATIBLE_VERSION 6
 #elif defined(DXX_BUILD_DESCENT_II)
-#define STATE_VERSION 22
+#define STATE_VERSION 23
 #define STATE_COMPATIBLE_VERSION 20
 #endif
 // 0 - Put DGSS (Descent Game State Save) id at tof.
@@ -110,6 +110,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 // 19- Saved cheats.enabled flag
 // 20- First_secret_visit
 // 22- Omega_charge
+// 23- Object count may exceed 350 (Descent 1: version 8)
 
 #define THUMBNAIL_W 100
 #define THUMBNAIL_H 50
@@ -881,7 +882,8 @@ static d_game_unique_state::save_slot state_get_savegame_filename(d_game_unique_
 				{
 					PHYSFS_seek(fp, PHYSFS_tell(fp) + sizeof(PHYSFS_sint32) + sizeof(char)*CALLSIGN_LEN+1); // skip state_game_id, callsign
 				}
-				if ((version >= STATE_COMPATIBLE_VERSION) || (SWAPINT(version) >= STATE_COMPATIBLE_VERSION)) {
+				const int native_version = (version & 0xffff0000) ? SWAPINT(version) : version;
+				if (native_version >= STATE_COMPATIBLE_VERSION && native_version <= STATE_VERSION) {
 					// Read description
 					PHYSFS_read(fp, desc[i].data(), desc[i].size(), 1);
 					desc[i].back() = 0;
@@ -1701,7 +1703,7 @@ int state_restore_all_sub(const d_level_shared_destructible_light_state &LevelSh
 		version = SWAPINT(version);
 	}
 
-	if (version < STATE_COMPATIBLE_VERSION)	{
+	if (version < STATE_COMPATIBLE_VERSION || version > STATE_VERSION)	{
 		return 0;
 	}
 
@@ -2426,7 +2428,7 @@ int state_get_game_id(const d_game_unique_state::savegame_file_path &filename)
 		version = SWAPINT(version);
 	}
 
-	if (version < STATE_COMPATIBLE_VERSION)	{
+	if (version < STATE_COMPATIBLE_VERSION || version > STATE_VERSION)	{
 		return 0;
 	}
 
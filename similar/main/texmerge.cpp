@@ -24,15 +24,21 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
  */
 
 
+#include <iterator>
+#include <list>
+#include <unordered_map>
 #include "gr.h"
+#include "args.h"
+#include "console.h"
 #include "dxxerror.h"
 #include "fmtcheck.h"
 #include "textures.h"
 #include "rle.h"
-#include "timer.h"
 #include "piggy.h"
 #include "segment.h"
 #include "texmerge.h"
+#include "texmerge_kernel.h"
+#include "texmap.h"
 #include "piggy.h"
 
 #include "compiler-range_for.h"
@@ -41,166 +47,72 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #if DXX_USE_OGL
 #include "ogl_init.h"
 #endif
-#define MAX_NUM_CACHE_BITMAPS 10
-
-//static grs_bitmap * cache_bitmaps[MAX_NUM_CACHE_BITMAPS];                     
-
 namespace {
 
-struct TEXTURE_CACHE {
-	grs_bitmap_ptr bitmap;
-	grs_bitmap * bottom_bmp;
-	grs_bitmap * top_bmp;
-	texture2_rotation_high orient;
-	fix64		last_time_used;
-};
-
-/* Helper classes merge_texture_0 through merge_texture_3 correspond to
- * the four values of `orient` used by texmerge_get_cached_bitmap.
+/* A merged texture is identified by the bitmap numbers of its two
+ * source textures and the rotation of the top one.
  */
-struct merge_texture_0
-{
-	static size_t get_top_data_index(const unsigned wh, const unsigned y, const unsigned x)
-	{
-		return wh * y + x;
-	}
-};
-
-struct merge_texture_1
-{
-	static size_t get_top_data_index(const unsigned wh, const unsigned y, const unsigned x)
-	{
-		return wh * x + ((wh - 1) - y);
-	}
-};
+using texmerge_key = uint64_t;
 
-struct merge_texture_2
-{
-	static size_t get_top_data_index(const unsigned wh, const unsigned y, const unsigned x)
-	{
-		return wh * ((wh - 1) - y) + ((wh - 1) - x);
-	}
-};
-
-struct merge_texture_3
-{
-	static size_t get_top_data_index(const unsigned wh, const unsigned y, const unsigned x)
-	{
-		return wh * ((wh - 1) - x) + y;
-	}
-};
-
-/* For supertransparent colors, remap 254.
- * For regular transparent colors, do nothing.
- *
- * In both cases, the caller remaps TRANSPARENCY_COLOR to the bottom
- * bitmap.
+/* Each field of a valid key is 16 bits, so the top 16 bits are always
+ * clear and this never matches a real texture.
  */
-struct merge_transform_super_xparent
-{
-	static uint8_t transform_color(uint8_t c)
-	{
-		return c == 254 ? TRANSPARENCY_COLOR : c;
-	}
-};
+constexpr texmerge_key texmerge_key_none = UINT64_MAX;
 
-struct merge_transform_new
+static texmerge_key build_texmerge_key(const bitmap_index bottom, const bitmap_index top, const texture2_rotation_high orient)
 {
-	static uint8_t transform_color(uint8_t c)
-	{
-		return c;
-	}
-};
-
+	return (static_cast<texmerge_key>(bottom.index) << 32) | (static_cast<texmerge_key>(top.index) << 16) | static_cast<uint16_t>(orient);
 }
 
-/* Run the transform for one texture merge case.  Different values of
- * `orient` in texmerge_get_cached_bitmap lead to different types for
- * `get_index`.
- */
-template <typename texture_transform, typename get_index>
-static void merge_textures_case(const unsigned wh, const uint8_t *const top_data, const uint8_t *const bottom_data, uint8_t *dest_data)
-{
-	for (unsigned y = 0; y < wh; ++y)
-		for (unsigned x = 0; x < wh; ++x)
-		{
-			const auto c = top_data[get_index::get_top_data_index(wh, y, x)];
-			/* All merged textures support TRANSPARENCY_COLOR, so handle
-			 * it here.  Supertransparency is delegated down to
-			 * `texture_transform`, since not all textures want
-			 * supertransparency.
-			 */
-			*dest_data++ = (c == TRANSPARENCY_COLOR)
-				? bottom_data[wh * y + x]
-				: texture_transform::transform_color(c);
-		}
-}
+struct TEXTURE_CACHE {
+	grs_bitmap_ptr bitmap;
+	texmerge_key key = texmerge_key_none;
+};
 
-/* Dispatch a texture transformation based on the value of `orient`.
- * The loops are duplicated in each case so that `orient` is not reread
- * for each byte processed.
+/* The list is kept in order of use, most recent first, so the entry to
+ * reuse on a miss is always at the back.  The index finds an entry
+ * without walking the list.
  */
-template <typename texture_transform>
-static void merge_textures(const texture2_rotation_high orient, const grs_bitmap &expanded_bottom_bmp, const grs_bitmap &expanded_top_bmp, uint8_t *const dest_data)
-{
-	const auto &top_data = expanded_top_bmp.bm_data;
-	const auto &bottom_data = expanded_bottom_bmp.bm_data;
-	const auto wh = expanded_bottom_bmp.bm_w;
-	switch (orient)
-	{
-		case texture2_rotation_high::Normal:
-			merge_textures_case<texture_transform, merge_texture_0>(wh, top_data, bottom_data, dest_data);
-			break;
-		case texture2_rotation_high::_1:
-			merge_textures_case<texture_transform, merge_texture_1>(wh, top_data, bottom_data, dest_data);
-			break;
-		case texture2_rotation_high::_2:
-			merge_textures_case<texture_transform, merge_texture_2>(wh, top_data, bottom_data, dest_data);
-			break;
-		case texture2_rotation_high::_3:
-			merge_textures_case<texture_transform, merge_texture_3>(wh, top_data, bottom_data, dest_data);
-			break;
-	}
+using texmerge_cache_list = std::list<TEXTURE_CACHE>;
+
 }
 
-static std::array<TEXTURE_CACHE, MAX_NUM_CACHE_BITMAPS> Cache;
+static texmerge_cache_list Cache;
+static std::unordered_map<texmerge_key, texmerge_cache_list::iterator> Cache_index;
 
-static int cache_hits = 0;
-static int cache_misses = 0;
+static texmerge_cache_stats cache_stats;
 
 //----------------------------------------------------------------------
 
 int texmerge_init()
 {
-	range_for (auto &i, Cache)
-	{
-		i.bitmap = NULL;
-		i.last_time_used = -1;
-		i.top_bmp = NULL;
-		i.bottom_bmp = NULL;
-	}
-
+	Cache.clear();
+	Cache_index.clear();
+	Cache.resize(CGameArg.GfxTexMergeCacheSize);
+	Cache_index.reserve(CGameArg.GfxTexMergeCacheSize);
+	cache_stats = {};
 	return 1;
 }
 
 void texmerge_flush()
 {
 	range_for (auto &i, Cache)
-	{
-		i.last_time_used = -1;
-		i.top_bmp = NULL;
-		i.bottom_bmp = NULL;
-	}
+		i.key = texmerge_key_none;
+	Cache_index.clear();
 }
 
 
 //-------------------------------------------------------------------------
 void texmerge_close()
 {
-	range_for (auto &i, Cache)
-	{
-		i.bitmap.reset();
-	}
+	con_printf(CON_VERBOSE, "texmerge: %u hits, %u misses", cache_stats.hits, cache_stats.misses);
+	Cache_index.clear();
+	Cache.clear();
+}
+
+const texmerge_cache_stats &texmerge_get_stats()
+{
+	return cache_stats;
 }
 
 //--unused-- int info_printed = 0;
@@ -208,7 +120,6 @@ void texmerge_close()
 grs_bitmap &texmerge_get_cached_bitmap(const texture1_value tmap_bottom, const texture2_value tmap_top)
 {
 	grs_bitmap *bitmap_top, *bitmap_bottom;
-	int lowest_time_used;
 
 	auto &texture_top = Textures[get_texture_index(tmap_top)];
 	bitmap_top = &GameBitmaps[texture_top.index];
@@ -217,23 +128,20 @@ grs_bitmap &texmerge_get_cached_bitmap(const texture1_value tmap_bottom, const t
 	
 	const auto orient = get_texture_rotation_high(tmap_top);
 
-	lowest_time_used = Cache[0].last_time_used;
-	auto least_recently_used = &Cache.front();
-	range_for (auto &i, Cache)
+	const auto key = build_texmerge_key(texture_bottom, texture_top, orient);
+	const auto found = Cache_index.find(key);
+	if (found != Cache_index.end())
 	{
-		if ( (i.last_time_used > -1) && (i.top_bmp==bitmap_top) && (i.bottom_bmp==bitmap_bottom) && (i.orient==orient ))	{
-			cache_hits++;
-			i.last_time_used = timer_query();
-			return *i.bitmap.get();
-		}	
-		if ( i.last_time_used < lowest_time_used )	{
-			lowest_time_used = i.last_time_used;
-			least_recently_used = &i;
-		}
+		cache_stats.hits++;
+		Cache.splice(Cache.begin(), Cache, found->second);
+		return *found->second->bitmap.get();
 	}
 
 	//---- Page out the LRU bitmap;
-	cache_misses++;
+	cache_stats.misses++;
+	const auto least_recently_used = std::prev(Cache.end());
+	if (least_recently_used->key != texmerge_key_none)
+		Cache_index.erase(least_recently_used->key);
 
 	// Make sure the bitmaps are paged in...
 
@@ -244,31 +152,34 @@ grs_bitmap &texmerge_get_cached_bitmap(const texture1_value tmap_bottom, const t
 	if (bitmap_bottom->bm_w != bitmap_top->bm_w || bitmap_bottom->bm_h != bitmap_top->bm_h)
 		Error("Top and Bottom textures have different size!\nbottom tmap = %u; bottom bitmap = %u; bottom width = %u; bottom height = %u\ntop tmap = %hu; top bitmap = %u; top width=%u; top height=%u", static_cast<uint16_t>(tmap_bottom), texture_bottom.index, bitmap_bottom->bm_w, bitmap_bottom->bm_h, static_cast<uint16_t>(tmap_top), texture_top.index, bitmap_top->bm_w, bitmap_top->bm_h);
 
+#if !DXX_USE_OGL
+	tmap_batch_retire(std::move(least_recently_used->bitmap));
+#endif
 	least_recently_used->bitmap = gr_create_bitmap(bitmap_bottom->bm_w,  bitmap_bottom->bm_h);
 #if DXX_USE_OGL
 	ogl_freebmtexture(*least_recently_used->bitmap.get());
 #endif
 
+	const auto rotation = static_cast<unsigned>(get_texture_rotation_low(orient));
 	auto &expanded_top_bmp = *rle_expand_texture(*bitmap_top);
 	auto &expanded_bottom_bmp = *rle_expand_texture(*bitmap_bottom);
 	if (bitmap_top->get_flag_mask(BM_FLAG_SUPER_TRANSPARENT))
 	{
-		merge_textures<merge_transform_super_xparent>(orient, expanded_bottom_bmp, expanded_top_bmp, least_recently_used->bitmap->get_bitmap_data());
+		texmerge_merge(expanded_bottom_bmp.bm_w, rotation, texmerge_transform::super_transparent, expanded_top_bmp.bm_data, expanded_bottom_bmp.bm_data, least_recently_used->bitmap->get_bitmap_data());
 		gr_set_bitmap_flags(*least_recently_used->bitmap.get(), BM_FLAG_TRANSPARENT);
 #if !DXX_USE_OGL
 		least_recently_used->bitmap->avg_color = bitmap_top->avg_color;
 #endif
 	} else	{
-		merge_textures<merge_transform_new>(orient, expanded_bottom_bmp, expanded_top_bmp, least_recently_used->bitmap->get_bitmap_data());
+		texmerge_merge(expanded_bottom_bmp.bm_w, rotation, texmerge_transform::none, expanded_top_bmp.bm_data, expanded_bottom_bmp.bm_data, least_recently_used->bitmap->get_bitmap_data());
 		least_recently_used->bitmap->set_flags(bitmap_bottom->get_flag_mask(~BM_FLAG_RLE));
 #if !DXX_USE_OGL
 		least_recently_used->bitmap->avg_color = bitmap_bottom->avg_color;
 #endif
 	}
 
-	least_recently_used->top_bmp = bitmap_top;
-	least_recently_used->bottom_bmp = bitmap_bottom;
-	least_recently_used->last_time_used = timer_query();
-	least_recently_used->orient = orient;
+	least_recently_used->key = key;
+	Cache_index.emplace(key, least_recently_used);
+	Cache.splice(Cache.begin(), Cache, least_recently_used);
 	return *least_recently_used->bitmap.get();
 }
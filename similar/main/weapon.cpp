@@ -1500,7 +1500,7 @@ void DropCurrentWeapon (player_info &player_info)
 {
 	auto &Objects = LevelUniqueObjectState.Objects;
 	auto &vmobjptr = Objects.vmptr;
-	if (LevelUniqueObjectState.num_objects >= Objects.size())
+	if (LevelUniqueObjectState.num_objects >= LevelUniqueObjectState.object_limit)
 		return;
 
 	powerup_type_t drop_type;
@@ -1609,7 +1609,7 @@ void DropSecondaryWeapon (player_info &player_info)
 	int seed;
 	ushort sub_ammo=0;
 
-	if (LevelUniqueObjectState.num_objects >= Objects.size())
+	if (LevelUniqueObjectState.num_objects >= LevelUniqueObjectState.object_limit)
 		return;
 
 	auto &Secondary_weapon = player_info.Secondary_weapon;
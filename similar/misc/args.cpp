@@ -11,6 +11,8 @@
  *
  */
 
+#include <algorithm>
+#include <climits>
 #include <string>
 #include <vector>
 #include <stdlib.h>
@@ -24,6 +26,7 @@
 #include "game.h"
 #include "console.h"
 #include "mission.h"
+#include "texmerge.h"
 #if DXX_USE_UDP
 #include "net_udp.h"
 #endif
@@ -136,11 +139,22 @@ static void arg_port_number(Arglist::iterator &pp, Arglist::const_iterator end,
 	if (static_cast<uint16_t>(port) == port && (allow_privileged || port >= 1024))
 		out = port;
 }
+
+static void arg_percent(Arglist::iterator &pp, Arglist::const_iterator end, uint8_t &out)
+{
+	auto percent = arg_integer(pp, end);
+	if (percent >= 0 && percent <= 100)
+		out = percent;
+}
 #endif
 
 static void InitGameArg()
 {
 	CGameArg.SysMaxFPS = MAXIMUM_FPS;
+	CGameArg.GfxTexMergeCacheSize = TEXMERGE_CACHE_SIZE_DEFAULT;
+#if !DXX_USE_OGL
+	CGameArg.DbgTexMapThreads = 1;
+#endif
 #if DXX_USE_UDP
 	CGameArg.MplUdpHostAddr = UDP_MANUAL_ADDR_DEFAULT;
 #if DXX_USE_TRACKER
@@ -150,6 +164,8 @@ static void InitGameArg()
 #endif
 	CGameArg.DbgVerbose = CON_NORMAL;
 	CGameArg.DbgBpp = 32;
+	CGameArg.DbgBenchmarkFrames = UINT_MAX;
+	CGameArg.DbgExportFps = 30;
 #if DXX_USE_OGL
 	CGameArg.OglSyncMethod = OGL_SYNC_METHOD_DEFAULT;
 	CGameArg.OglSyncWait = OGL_SYNC_WAIT_DEFAULT;
@@ -278,6 +294,8 @@ static void ReadCmdArgs(Inilist &ini, Arglist &Args)
 
 		else if (!d_stricmp(p, "-lowresfont"))
 			CGameArg.GfxSkipHiresFNT = true;
+		else if (!d_stricmp(p, "-texmergecache"))
+			CGameArg.GfxTexMergeCacheSize = arg_integer(pp, end);
 #if defined(DXX_BUILD_DESCENT_II)
 		else if (!d_stricmp(p, "-lowresgraphics"))
 			GameArg.GfxSkipHiresGFX	= 1;
@@ -315,6 +333,46 @@ static void ReadCmdArgs(Inilist &ini, Arglist &Args)
 		{
 			arg_port_number(pp, end, CGameArg.MplUdpMyPort, false);
 		}
+		else if (!d_stricmp(p, "-dedicated"))
+		{
+			CGameArg.MplDedicated = true;
+			/* Nobody sits at a dedicated host, so skip everything that
+			 * waits on or plays to a player.
+			 */
+			CGameArg.SysNoTitles = true;
+			CGameArg.SndNoSound = true;
+			CGameArg.SndNoMusic = true;
+#if defined(DXX_BUILD_DESCENT_II)
+			GameArg.SysNoMovies = 1;
+#endif
+		}
+		else if (!d_stricmp(p, "-dedicated_mission"))
+			CGameArg.MplDedicatedMission = arg_string(pp, end);
+		else if (!d_stricmp(p, "-dedicated_level"))
+			CGameArg.MplDedicatedLevel = arg_integer(pp, end);
+		else if (!d_stricmp(p, "-dedicated_mode"))
+			CGameArg.MplDedicatedMode = arg_string(pp, end);
+		else if (!d_stricmp(p, "-dedicated_name"))
+			CGameArg.MplDedicatedName = arg_string(pp, end);
+		else if (!d_stricmp(p, "-dedicated_players"))
+		{
+			if (const auto players = arg_integer(pp, end); players >= 1 && players <= static_cast<long>(MAX_PLAYERS))
+				CGameArg.MplDedicatedMaxPlayers = players;
+		}
+		else if (!d_stricmp(p, "-udp_capture"))
+			CGameArg.MplUdpCapture = arg_string(pp, end);
+		else if (!d_stricmp(p, "-udp_replay"))
+			CGameArg.MplUdpReplay = arg_string(pp, end);
+		else if (!d_stricmp(p, "-udp_sim_loss"))
+			arg_percent(pp, end, CGameArg.MplUdpSimLoss);
+		else if (!d_stricmp(p, "-udp_sim_reorder"))
+			arg_percent(pp, end, CGameArg.MplUdpSimReorder);
+		else if (!d_stricmp(p, "-udp_sim_latency"))
+			CGameArg.MplUdpSimLatency = arg_integer(pp, end);
+		else if (!d_stricmp(p, "-udp_sim_jitter"))
+			CGameArg.MplUdpSimJitter = arg_integer(pp, end);
+		else if (!d_stricmp(p, "-udp_sim_seed"))
+			CGameArg.MplUdpSimSeed = arg_integer(pp, end);
 		else if (!d_stricmp(p, "-no-tracker"))
 		{
 			/* Always recognized.  No-op if tracker support compiled
@@ -374,6 +432,67 @@ static void ReadCmdArgs(Inilist &ini, Arglist &Args)
 			CGameArg.DbgNoCompressPigBitmap = true;
 		else if (!d_stricmp(p, "-16bpp"))
 			CGameArg.DbgBpp		= 16;
+		else if (!d_stricmp(p, "-benchmark"))
+		{
+			CGameArg.DbgBenchmarkDemo = arg_string(pp, end);
+			/* The benchmark drives playback itself and never waits on
+			 * the player, so skip everything that would.
+			 */
+			CGameArg.SysNoTitles = true;
+			CGameArg.SndNoSound = true;
+			CGameArg.SndNoMusic = true;
+#if defined(DXX_BUILD_DESCENT_II)
+			GameArg.SysNoMovies = 1;
+#endif
+		}
+		else if (!d_stricmp(p, "-benchmark-frames"))
+			CGameArg.DbgBenchmarkFrames = std::max(arg_integer(pp, end), 1L);
+		else if (!d_stricmp(p, "-export"))
+		{
+			CGameArg.DbgExportDemo = arg_string(pp, end);
+			/* As for -benchmark.  Sound is turned back on below if
+			 * -export-audio asks for it.
+			 */
+			CGameArg.SysNoTitles = true;
+			CGameArg.SndNoSound = true;
+			CGameArg.SndNoMusic = true;
+#if defined(DXX_BUILD_DESCENT_II)
+			GameArg.SysNoMovies = 1;
+#endif
+		}
+		else if (!d_stricmp(p, "-export-png"))
+			CGameArg.DbgExportPng = arg_string(pp, end);
+		else if (!d_stricmp(p, "-export-video"))
+			CGameArg.DbgExportVideo = arg_string(pp, end);
+		else if (!d_stricmp(p, "-export-audio"))
+			CGameArg.DbgExportAudio = arg_string(pp, end);
+		else if (!d_stricmp(p, "-export-fps"))
+			CGameArg.DbgExportFps = std::max(arg_integer(pp, end), 1L);
+		else if (const bool child = !d_stricmp(p, "-demo-stats-child"); child || !d_stricmp(p, "-demo-stats"))
+		{
+			if (child)
+				CGameArg.DbgDemoStatsChild = arg_string(pp, end);
+			else
+				CGameArg.DbgDemoStats.emplace_back(arg_string(pp, end));
+			/* As for -benchmark. */
+			CGameArg.SysNoTitles = true;
+			CGameArg.SndNoSound = true;
+			CGameArg.SndNoMusic = true;
+#if defined(DXX_BUILD_DESCENT_II)
+			GameArg.SysNoMovies = 1;
+#endif
+		}
+		else if (!d_stricmp(p, "-demo-stats-csv"))
+			CGameArg.DbgDemoStatsCsv = true;
+		else if (!d_stricmp(p, "-demo-stats-jobs"))
+			CGameArg.DbgDemoStatsJobs = arg_integer(pp, end);
+		else if (!d_stricmp(p, "-profile"))
+			CGameArg.DbgProfile = true;
+		else if (!d_stricmp(p, "-profile-csv"))
+		{
+			CGameArg.DbgProfileCsv = arg_string(pp, end);
+			CGameArg.DbgProfile = true;
+		}
 
 #if DXX_USE_OGL
 		else if (!d_stricmp(p, "-gl_oldtexmerge"))
@@ -391,6 +510,11 @@ static void ReadCmdArgs(Inilist &ini, Arglist &Args)
 #else
 		else if (!d_stricmp(p, "-tmap"))
 			CGameArg.DbgTexMap = arg_string(pp, end);
+		else if (!d_stricmp(p, "-tmap_threads"))
+		{
+			if (const auto threads = arg_integer(pp, end); threads >= 0)
+				CGameArg.DbgTexMapThreads = threads;
+		}
 		else if (!d_stricmp(p, "-hwsurface"))
 			CGameArg.DbgSdlHWSurface = true;
 		else if (!d_stricmp(p, "-asyncblit"))
@@ -428,6 +552,30 @@ static void PostProcessGameArg()
 		CGameArg.SysMaxFPS = MINIMUM_FPS;
 	else if (CGameArg.SysMaxFPS > MAXIMUM_FPS)
 		CGameArg.SysMaxFPS = MAXIMUM_FPS;
+	/* The texture merge cache needs an entry to replace on a miss.
+	 */
+	if (!CGameArg.GfxTexMergeCacheSize)
+		CGameArg.GfxTexMergeCacheSize = 1;
+	/* A copy started for one demo of many reads only that demo, even
+	 * when an ini file lists others with -demo-stats.
+	 */
+	if (!CGameArg.DbgDemoStatsChild.empty())
+	{
+		CGameArg.DbgDemoStats.clear();
+		CGameArg.DbgDemoStats.emplace_back(std::move(CGameArg.DbgDemoStatsChild));
+	}
+	if (CGameArg.DbgExportDemo.empty())
+		CGameArg.DbgExportAudio.clear();
+	else if (!CGameArg.DbgExportAudio.empty())
+	{
+		/* Only the plain SDL sound system can be mixed without a
+		 * device.
+		 */
+		CGameArg.SndNoSound = false;
+#if DXX_USE_SDLMIXER
+		CGameArg.SndDisableSdlMixer = true;
+#endif
+	}
 #if PHYSFS_VER_MAJOR >= 2
 	if (!CGameArg.SysMissionDir.empty())
 		PHYSFS_mount(CGameArg.SysMissionDir.c_str(), MISSION_DIR, 1);
@@ -439,6 +587,23 @@ static void PostProcessGameArg()
 		sdl_disable_lock_keys[sizeof(sdl_disable_lock_keys) - 2] = '1';
 	SDL_putenv(sdl_disable_lock_keys);
 #endif
+#if !DXX_USE_OGL
+	/* The benchmark renders into an offscreen canvas and never presents
+	 * a frame, the export reads each frame back from memory, and demo
+	 * statistics draw nothing, so all of them can run without a
+	 * display.  An explicit choice of driver in the environment still
+	 * wins.  A dedicated host does not initialize video at all.
+	 */
+	if ((!CGameArg.DbgBenchmarkDemo.empty() || !CGameArg.DbgExportDemo.empty() || !CGameArg.DbgDemoStats.empty()) && !SDL_getenv("SDL_VIDEODRIVER"))
+	{
+#if SDL_MAJOR_VERSION == 1
+		static char sdl_videodriver_dummy[] = "SDL_VIDEODRIVER=dummy";
+		SDL_putenv(sdl_videodriver_dummy);
+#else
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+#endif
+	}
+#endif
 }
 
 static std::string ConstructIniStackExplanation(const Inilist &ini)